@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <iostream>
@@ -32,6 +33,9 @@ public:
         UNKNOWN
     };
 
+    // Receives each translated function, returns true to keep it in the module or false to destroy it
+    using FunctionSinkType = std::function<bool(uir::Function &F)>;
+
 public:
     UnknownFrontendTranslator() = default;
     virtual ~UnknownFrontendTranslator() = default;
@@ -46,6 +50,14 @@ public:
     // Translate the given binary into UnknownIR
     virtual std::unique_ptr<uir::Module> translateBinary(const std::string &ModuleName) = 0;
 
+    // Translate the given binary into UnknownIR on NumThreads threads, 0 means all hardware threads
+    virtual std::unique_ptr<uir::Module> translateBinary(const std::string &ModuleName, uint32_t NumThreads) = 0;
+
+    // Translate the given binary into UnknownIR and hand each function to the sink in symbol order as soon as it is
+    // translated, the module only holds the functions the sink kept
+    virtual std::unique_ptr<uir::Module>
+    translateBinary(const std::string &ModuleName, const FunctionSinkType &Sink, uint32_t NumThreads = 1) = 0;
+
     // Translate one instruction into UnknownIR
     virtual bool translateOneInstruction(const uint8_t *Bytes, size_t Size, uint64_t Address, uir::BasicBlock *BB) = 0;
 
@@ -57,6 +69,21 @@ public:
     virtual bool
     translateOneFunction(const std::string &FunctionName, uint64_t Address, size_t Size, uir::Function *F) = 0;
 
+public:
+    // Print
+    // Print the module on NumThreads threads, 0 means all hardware threads.
+    // The time is reported as the print phase of the statistics.
+    virtual void printModule(const uir::Module &M, unknown::raw_ostream &OS, uint32_t NumThreads = 1) = 0;
+
+public:
+    // Cache
+    // Enable the on-disk cache of lifted functions, PruningPolicy uses the syntax of unknown::parseCachePruningPolicy
+    virtual bool enableLiftCache(const std::string &CacheDirectory, const std::string &PruningPolicy = "") = 0;
+
+    // Enable the on-disk cache of the parsed function symbols, it has to be called before initTranslator.
+    // The directory may be the one of the lift cache.
+    virtual bool enableSymbolCache(const std::string &CacheDirectory) = 0;
+
 public:
     // Get/Set
     // Get the context of this translator
@@ -101,6 +128,50 @@ public:
     // Set EnableAnalyzeAllFunctions
     virtual void setEnableAnalyzeAllFunctions(bool Set) = 0;
 
+    // Get EnableLazyDecodeDetail
+    virtual const bool getEnableLazyDecodeDetail() const = 0;
+
+    // Set EnableLazyDecodeDetail, only the instructions with a semantic translator are decoded with operand detail
+    virtual void setEnableLazyDecodeDetail(bool Set) = 0;
+
+public:
+    // Statistics
+    // Get the number of instructions decoded by the disassembler
+    virtual const uint64_t getNumDecodedInstructions() const = 0;
+
+    // Get the number of instructions decoded with operand detail
+    virtual const uint64_t getNumDetailDecodedInstructions() const = 0;
+
+    // Get the number of instructions served from the decoded-instruction cache
+    virtual const uint64_t getNumDecodeCacheHits() const = 0;
+
+    // Get the number of functions rehydrated from the lift cache
+    virtual const uint64_t getNumLiftCacheHits() const = 0;
+
+    // Get the number of functions that were not found in the lift cache
+    virtual const uint64_t getNumLiftCacheMisses() const = 0;
+
+    // Get the number of functions translated
+    virtual const uint64_t getNumTranslatedFunctions() const = 0;
+
+    // Get the number of basic blocks created
+    virtual const uint64_t getNumTranslatedBasicBlocks() const = 0;
+
+    // Get the number of instructions that fell back to the unknown instruction
+    virtual const uint64_t getNumUnknownInstructions() const = 0;
+
+    // Get EnableStatistics
+    virtual const bool getEnableStatistics() const = 0;
+
+    // Set EnableStatistics, times the decoding and the translation of each opcode
+    virtual void setEnableStatistics(bool Set) = 0;
+
+    // Print the phase timers and the counters
+    virtual void printStatistics(unknown::raw_ostream &OS) = 0;
+
+    // Print the phase timers and the counters as a JSON document
+    virtual void printStatisticsJSON(unknown::raw_ostream &OS) = 0;
+
 public:
     // Static
     static std::unique_ptr<UnknownFrontendTranslator> createTranslator(
@@ -57,6 +57,9 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == ArgumentVal; }
+
     static Argument *get(Type *Ty, const unknown::StringRef &ArgName = "", Function *F = nullptr, uint32_t ArgNo = 0);
 };
 
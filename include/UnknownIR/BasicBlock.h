@@ -1,27 +1,72 @@
 #pragma once
 #include <UnknownIR/Constant.h>
+#include <UnknownIR/InstructionBase.h>
+
+#include <UnknownUtils/unknown/ADT/ilist_node.h>
+#include <UnknownUtils/unknown/ADT/iterator.h>
+#include <UnknownUtils/unknown/ADT/simple_ilist.h>
 
 namespace uir {
 class Function;
 class Instruction;
 class TerminatorInstruction;
 
-class BasicBlock : public Constant
+// Iterate over an intrusive list by the pointers of its nodes
+template <typename WrappedIteratorT, typename T = decltype(&*std::declval<WrappedIteratorT>())>
+class node_pointer_iterator : public unknown::iterator_adaptor_base<
+                                  node_pointer_iterator<WrappedIteratorT, T>,
+                                  WrappedIteratorT,
+                                  typename std::iterator_traits<WrappedIteratorT>::iterator_category,
+                                  T>
+{
+    mutable T Ptr;
+
+public:
+    node_pointer_iterator() = default;
+    explicit node_pointer_iterator(WrappedIteratorT u) : node_pointer_iterator::iterator_adaptor_base(std::move(u)) {}
+
+    // Convert the iterator to the const iterator
+    template <
+        typename OtherWrappedIteratorT,
+        typename OtherT,
+        typename = std::enable_if_t<std::is_convertible_v<OtherWrappedIteratorT, WrappedIteratorT>>>
+    node_pointer_iterator(const node_pointer_iterator<OtherWrappedIteratorT, OtherT> &Other) :
+        node_pointer_iterator::iterator_adaptor_base(Other.getNodeIterator())
+    {
+    }
+
+    T &operator*() { return Ptr = &*this->I; }
+    const T &operator*() const { return Ptr = &*this->I; }
+
+    // Get the iterator of the intrusive list
+    const WrappedIteratorT &getNodeIterator() const { return this->I; }
+};
+
+class BasicBlock : public Constant, public unknown::ilist_node<BasicBlock>
 {
     friend class TerminatorInstruction;
+    friend class Function;
 
 public:
-    using InstListType = std::list<Instruction *>;
+    // The instructions are linked through their own nodes, the block does not own them
+    using InstListType = unknown::simple_ilist<Instruction>;
     using PredecessorsListType = std::vector<BasicBlock *>;
 
 private:
-    std::string mBasicBlockName;
+    // The name is interned in the string pool of the context
+    const char *mBasicBlockName;
     uint64_t mBasicBlockAddressBegin;
     uint64_t mBasicBlockAddressEnd;
     Function *mParent;
     InstListType mInstList;
     PredecessorsListType mPredecessorsList;
 
+    // The order of this block in its function, only meaningful while the block order of the function is valid
+    mutable uint32_t mOrder;
+
+    // Are the order indices of the instructions up to date?
+    mutable bool mInstOrderValid;
+
 public:
     explicit BasicBlock(Context &C);
     explicit BasicBlock(
@@ -34,44 +79,50 @@ public:
 
 public:
     // InstList
+    // The list is only changed through the block, so the parents and the order indices stay up to date
     const InstListType &getInstList() const { return mInstList; }
-    InstListType &getInstList() { return mInstList; }
 
 public:
-    // Instruction iterators
-    using iterator = InstListType::iterator;
-    using const_iterator = InstListType::const_iterator;
-    using reverse_iterator = InstListType::reverse_iterator;
-    using const_reverse_iterator = InstListType::const_reverse_iterator;
-
-    iterator begin() { return mInstList.begin(); }
-    const_iterator begin() const { return mInstList.cbegin(); }
-    iterator end() { return mInstList.end(); }
-    const_iterator end() const { return mInstList.cend(); }
-
-    reverse_iterator rbegin() { return mInstList.rbegin(); }
-    const_reverse_iterator rbegin() const { return mInstList.crbegin(); }
-    reverse_iterator rend() { return mInstList.rend(); }
-    const_reverse_iterator rend() const { return mInstList.crend(); }
+    // Instruction iterators, they dereference to the instruction pointer
+    using iterator = node_pointer_iterator<InstListType::iterator>;
+    using const_iterator = node_pointer_iterator<InstListType::const_iterator>;
+    using reverse_iterator = node_pointer_iterator<InstListType::reverse_iterator>;
+    using const_reverse_iterator = node_pointer_iterator<InstListType::const_reverse_iterator>;
+
+    iterator begin() { return iterator(mInstList.begin()); }
+    const_iterator begin() const { return const_iterator(mInstList.begin()); }
+    iterator end() { return iterator(mInstList.end()); }
+    const_iterator end() const { return const_iterator(mInstList.end()); }
+
+    reverse_iterator rbegin() { return reverse_iterator(mInstList.rbegin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(mInstList.rbegin()); }
+    reverse_iterator rend() { return reverse_iterator(mInstList.rend()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(mInstList.rend()); }
 
     size_t size() const { return mInstList.size(); }
     bool empty() const { return mInstList.empty(); }
-    const Instruction &front() const { return *mInstList.front(); }
-    Instruction &front() { return *mInstList.front(); }
-    const Instruction &back() const { return *mInstList.back(); }
-    Instruction &back() { return *mInstList.back(); }
-    void push(Instruction *I) { mInstList.push_back(I); }
-    void pop() { mInstList.pop_back(); }
-    void push_back(Instruction *I) { mInstList.push_back(I); }
-    void pop_back() { mInstList.pop_back(); }
-    void push_front(Instruction *I) { mInstList.push_front(I); }
-    void pop_front() { mInstList.pop_front(); }
-    void insert(iterator I, Instruction *Inst) { mInstList.insert(I, Inst); }
-    void insert(iterator I, size_t N, Instruction *Inst) { mInstList.insert(I, N, Inst); }
-    void insert(iterator I, iterator First, iterator Last) { mInstList.insert(I, First, Last); }
-    void erase(iterator I) { mInstList.erase(I); }
-    void erase(iterator First, iterator Last) { mInstList.erase(First, Last); }
-    void clear() { mInstList.clear(); }
+    const Instruction &front() const { return mInstList.front(); }
+    Instruction &front() { return mInstList.front(); }
+    const Instruction &back() const { return mInstList.back(); }
+    Instruction &back() { return mInstList.back(); }
+    void push(Instruction *I) { push_back(I); }
+    void pop() { pop_back(); }
+    void push_back(Instruction *I);
+    void pop_back() { remove(&mInstList.back()); }
+    void push_front(Instruction *I) { insert(begin(), I); }
+    void pop_front() { remove(&mInstList.front()); }
+    iterator insert(iterator I, Instruction *Inst);
+    iterator erase(iterator I);
+    iterator erase(iterator First, iterator Last);
+    void remove(Instruction *I);
+    void clear();
+
+    // Move the instructions [First, Last) of another block before I
+    void splice(iterator I, BasicBlock *From, iterator First, iterator Last);
+
+    // Get the iterator of an instruction in this block
+    static iterator getInstIterator(Instruction *I);
+    static const_iterator getInstIterator(const Instruction *I);
 
 public:
     // PredecessorsList
@@ -139,6 +190,20 @@ public:
     // Get the first predecessor of this block
     const BasicBlock *getFirstPredecessor() const;
 
+public:
+    // Order
+    // Is this block before the other block of the same function?
+    bool comesBefore(const BasicBlock *Other) const;
+
+    // Are the order indices of the instructions up to date?
+    bool isInstrOrderValid() const { return mInstOrderValid; }
+
+    // Mark the order indices of the instructions out of date, they are renumbered on the next query
+    void invalidateOrders() const { mInstOrderValid = false; }
+
+    // Renumber the order indices of the instructions
+    void renumberInstructions() const;
+
 public:
     // Remove/Erase/Insert/Clear
     // Remove the block from the its parent, but does not delete it.
@@ -165,6 +230,9 @@ public:
     // Clear all instructions in this block.
     void clearAllInstructions();
 
+    // Clear all instructions in this block, the operands shared with other blocks are only freed once.
+    void clearAllInstructions(unknown::SmallPtrSetImpl<Value *> &FreedOperands);
+
 public:
     // Virtual functions
     // Get the readable name of this object
@@ -181,6 +249,9 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == BasicBlockVal; }
+
     // Generate a new block name by order
     static std::string generateOrderedBasicBlockName(Context &C);
 
@@ -15,6 +15,9 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() >= ConstantVal; }
+
     // Get a Constant object
     static Constant *get(Type *Ty, const unknown::StringRef &ConstantName);
 };
@@ -39,6 +42,10 @@ public:
     // Return the bitwidth of this constant.
     uint32_t getBitWidth() const;
 
+private:
+    // Name the constant after its value
+    void updateName();
+
 public:
     // Virtual functions
     // Get the readable name of this object
@@ -46,6 +53,9 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == ConstantIntVal; }
+
     // Get a ConstantInt from a value
     static ConstantInt *get(Context &Context, const unknown::APInt &Val);
 
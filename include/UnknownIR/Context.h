@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -45,6 +46,12 @@ public:
     unknown::StringRef getModeString();
     void setMode(Mode mode);
     uint32_t getModeBits();
+
+public:
+    // Arena
+    // Allocate the memory of a value from the arena of the function being built on the current thread, nullptr if the
+    // thread is not in a Function::ArenaScope of this context. ArenaID is set to the id of the arena.
+    void *allocate(size_t Size, size_t Alignment, uint32_t &ArenaID);
 };
 
 } // namespace uir
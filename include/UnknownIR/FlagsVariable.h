@@ -6,6 +6,28 @@ namespace uir {
 class FlagsVariable : public LocalVariable
 {
 public:
+    // The condition tested by a conditional branch
+    enum class ConditionKind : uint8_t
+    {
+        None,
+        Above,          // CF = 0 and ZF = 0
+        AboveOrEqual,   // CF = 0
+        Below,          // CF = 1
+        BelowOrEqual,   // CF = 1 or ZF = 1
+        Equal,          // ZF = 1
+        NotEqual,       // ZF = 0
+        Greater,        // ZF = 0 and SF = OF
+        GreaterOrEqual, // SF = OF
+        Less,           // SF != OF
+        LessOrEqual,    // ZF = 1 or SF != OF
+        Overflow,       // OF = 1
+        NotOverflow,    // OF = 0
+        Parity,         // PF = 1
+        NotParity,      // PF = 0
+        Sign,           // SF = 1
+        NotSign         // SF = 0
+    };
+
     union Flags
     {
         uint64_t FlagsValue;
@@ -19,6 +41,7 @@ public:
             uint64_t SignFlag : 1;      // SF
             uint64_t DirectionFlag : 1; // DF
             uint64_t OverflowFlag : 1;  // OF
+            uint64_t Condition : 8;     // ConditionKind
         };
     };
 
@@ -61,10 +84,22 @@ public:
     // Set the OverflowFlag
     void setOverflowFlag(bool Set = true);
 
+    // Get the condition tested by the branch
+    ConditionKind getCondition() const;
+
+    // Set the condition tested by the branch and the flags it reads
+    void setCondition(ConditionKind Condition);
+
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == FlagsVariableVal; }
+
     static FlagsVariable *get(Type *Ty);
     static FlagsVariable *get(Context &C);
+
+    // Get a flags variable for a conditional branch
+    static FlagsVariable *get(Context &C, ConditionKind Condition);
 };
 
 } // namespace uir
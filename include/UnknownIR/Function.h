@@ -1,5 +1,8 @@
 #pragma once
+#include <memory>
+
 #include <UnknownIR/Constant.h>
+#include <UnknownIR/BasicBlock.h>
 
 #include <UnknownUtils/unknown/Support/raw_ostream.h>
 
@@ -9,11 +12,24 @@ class Module;
 class BasicBlock;
 class Argument;
 class FunctionContext;
+class GlobalVariable;
+class ValueArena;
+
+// The options of the binary format of the basic blocks of a function
+struct BinaryBodyOptions
+{
+    // Write the addresses as the delta to a nearby address
+    bool mDeltaAddresses = true;
+
+    // Write the comments and the extra info of the basic blocks
+    bool mBlockAnnotations = true;
+};
 
 class Function : public Constant
 {
 public:
-    using BasicBlockListType = std::list<BasicBlock *>;
+    // The blocks are linked through their own nodes, the function does not own them
+    using BasicBlockListType = unknown::simple_ilist<BasicBlock>;
     using ArgumentListType = std::list<Argument *>;
     using FunctionContextListType = std::list<FunctionContext *>;
     using FunctionAttributesListType = std::vector<std::string>;
@@ -31,6 +47,17 @@ private:
     bool mHasAsyncEH;
     bool mHasNaked;
 
+    // Are the order indices of the blocks up to date?
+    mutable bool mBlockOrderValid;
+
+    // The global variables used by the blocks that are not in a module, they are freed with the function
+    std::vector<GlobalVariable *> mOwnedGlobalVariables;
+
+    // The arena of the values built in an ArenaScope of this function, nullptr until the first scope
+    std::unique_ptr<ValueArena> mArena;
+
+    friend class Module;
+
 public:
     explicit Function(
         Context &C,
@@ -42,8 +69,8 @@ public:
 
 public:
     // BasicBlocksList
+    // The list is only changed through the function, so the parents and the order indices stay up to date
     const BasicBlockListType &getBasicBlockList() const { return mBasicBlocksList; }
-    BasicBlockListType &getBasicBlockList() { return mBasicBlocksList; }
 
 public:
     // ArgumentsList
@@ -61,25 +88,32 @@ public:
     FunctionAttributesListType &getFunctionAttributesList() { return mFunctionAttributesList; }
 
 public:
-    // BasicBlock iterators
-    using iterator = BasicBlockListType::iterator;
-    using const_iterator = BasicBlockListType::const_iterator;
-    iterator begin() { return mBasicBlocksList.begin(); }
-    const_iterator begin() const { return mBasicBlocksList.cbegin(); }
-    iterator end() { return mBasicBlocksList.end(); }
-    const_iterator end() const { return mBasicBlocksList.cend(); }
+    // BasicBlock iterators, they dereference to the block pointer
+    using iterator = node_pointer_iterator<BasicBlockListType::iterator>;
+    using const_iterator = node_pointer_iterator<BasicBlockListType::const_iterator>;
+    iterator begin() { return iterator(mBasicBlocksList.begin()); }
+    const_iterator begin() const { return const_iterator(mBasicBlocksList.begin()); }
+    iterator end() { return iterator(mBasicBlocksList.end()); }
+    const_iterator end() const { return const_iterator(mBasicBlocksList.end()); }
 
     size_t size() const { return mBasicBlocksList.size(); }
     bool empty() const { return mBasicBlocksList.empty(); }
-    const BasicBlock &front() const { return *mBasicBlocksList.front(); }
-    BasicBlock &front() { return *mBasicBlocksList.front(); }
-    const BasicBlock &back() const { return *mBasicBlocksList.back(); }
-    BasicBlock &back() { return *mBasicBlocksList.back(); }
-    void push_back(BasicBlock *BB) { mBasicBlocksList.push_back(BB); }
-    void push_front(BasicBlock *BB) { mBasicBlocksList.push_front(BB); }
-    void pop_back() { mBasicBlocksList.pop_back(); }
-    void pop_front() { mBasicBlocksList.pop_front(); }
-    void clear() { mBasicBlocksList.clear(); }
+    const BasicBlock &front() const { return mBasicBlocksList.front(); }
+    BasicBlock &front() { return mBasicBlocksList.front(); }
+    const BasicBlock &back() const { return mBasicBlocksList.back(); }
+    BasicBlock &back() { return mBasicBlocksList.back(); }
+    void push_back(BasicBlock *BB);
+    void push_front(BasicBlock *BB) { insert(begin(), BB); }
+    void pop_back() { remove(&mBasicBlocksList.back()); }
+    void pop_front() { remove(&mBasicBlocksList.front()); }
+    iterator insert(iterator It, BasicBlock *BB);
+    iterator erase(iterator It);
+    void remove(BasicBlock *BB);
+    void clear();
+
+    // Get the iterator of a block in this function
+    static iterator getBasicBlockIterator(BasicBlock *BB);
+    static const_iterator getBasicBlockIterator(const BasicBlock *BB);
 
 public:
     // Argument iterators
@@ -200,6 +234,17 @@ public:
     // function is __declspec(naked)?
     void setNaked(bool HasNaked);
 
+public:
+    // Order
+    // Are the order indices of the blocks up to date?
+    bool isBlockOrderValid() const { return mBlockOrderValid; }
+
+    // Mark the order indices of the blocks out of date, they are renumbered on the next query
+    void invalidateBlockOrders() const { mBlockOrderValid = false; }
+
+    // Renumber the order indices of the blocks
+    void renumberBlocks() const;
+
 public:
     // Function Attribute
     // Add function attribute to this function.
@@ -228,14 +273,59 @@ public:
     // Insert a new function context to this function
     void insertFunctionContext(FunctionContext *FC);
 
+    // Give a global variable that is not in a module to this function, it is freed with the function
+    void insertOwnedGlobalVariable(GlobalVariable *GV);
+
+    // Get the global variables owned by this function
+    const std::vector<GlobalVariable *> &getOwnedGlobalVariableList() const { return mOwnedGlobalVariables; }
+
     // Drop all blocks in this function.
     void dropAllReferences();
 
     // Clear all basic blocks.
     void clearAllBasicBlock();
 
+public:
+    // Arena
+    // While an ArenaScope of a function is alive, the values built on the current thread are allocated from the arena
+    // of the function. They belong to the function: they are released with it in one step, without running their
+    // destructors, so they must not be used by another function. Functions and globals never live in an arena.
+    class ArenaScope
+    {
+    private:
+        ContextImpl *mPrevImpl;
+        ValueArena *mPrevArena;
+
+    public:
+        explicit ArenaScope(Function &F);
+        ArenaScope(const ArenaScope &) = delete;
+        ArenaScope &operator=(const ArenaScope &) = delete;
+        ~ArenaScope();
+    };
+
+    // Get the number of bytes allocated from the arena of this function
+    size_t getArenaBytesAllocated() const;
+
+private:
+    // Drop the blocks of the arena in one step, only the uses of values outside of the arena are unlinked.
+    // Returns false if a block or an instruction is on the heap, the blocks are left untouched then.
+    bool dropArenaValues();
+
+public:
+    // Binary
+    // Write the basic blocks of the function in the binary format, followed by the strings and the types they use.
+    // Returns false if the function has something the format can not describe.
+    bool writeBinaryBody(unknown::raw_ostream &OS, const BinaryBodyOptions &Options = {}) const;
+
+    // Read the basic blocks written by writeBinaryBody with the same options into the empty function.
+    // Returns false if the buffer is corrupted, the function is left untouched then.
+    bool readBinaryBody(unknown::StringRef Buffer, const BinaryBodyOptions &Options = {});
+
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == FunctionVal; }
+
     // Generate a new function name by order
     static std::string generateOrderedFunctionName(Context &C);
 
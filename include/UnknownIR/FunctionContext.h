@@ -61,6 +61,9 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == FunctionContextVal; }
+
     static FunctionContext *
     get(Type *Ty, const unknown::StringRef &CtxName = "", Function *F = nullptr, uint32_t CtxNo = 0);
 };
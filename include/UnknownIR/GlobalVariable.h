@@ -58,6 +58,12 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V)
+    {
+        return V->getValueID() >= GlobalVariableVal && V->getValueID() <= GlobalArrayVal;
+    }
+
     // Generate a new value name by order
     static std::string generateOrderedGlobalVarName(Context &C);
 
@@ -85,6 +91,7 @@ public:
         uint64_t GlobalArrayAddress = 0) :
         GlobalVariable(PointerType::get(C, ElmtTy), GlobalArrayName, GlobalArrayAddress), mElements(GlobalArrayElements)
     {
+        mValueID = GlobalArrayVal;
         if (ElmtTy->getTypeSize() != sizeof(T))
         {
             std::printf(
@@ -110,6 +117,7 @@ public:
         const unknown::StringRef &GlobalArrayName,
         uint64_t GlobalArrayAddress)
     {
+        // The globals belong to the module, so they never live in the arena of a function
         return new GlobalArray(C, ElmtTy, GlobalArrayElements, GlobalArrayName, GlobalArrayAddress);
     }
 
@@ -117,6 +125,14 @@ public:
     {
         return get(C, ElmtTy, GlobalArrayElements, generateOrderedGlobalVarName(C), 0);
     }
+
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V)
+    {
+        // The arrays of other element types have the same kind, the element size tells them apart
+        return V->getValueID() == GlobalArrayVal &&
+               unknown::cast<PointerType>(V->getType())->getElementType()->getTypeSize() == sizeof(T);
+    }
 };
 
 } // namespace uir
@@ -69,6 +69,12 @@ public:
     JmpAddrInstruction *createJmpAddr(ConstantInt *JmpDest, uint64_t InstAddress);
     JmpBBInstruction *createJmpBB(BasicBlock *DestBB, uint64_t InstAddress);
 
+    // Jcc
+    JccAddrInstruction *
+    createJccAddr(ConstantInt *JccDest, ConstantInt *JccNormal, FlagsVariable *FlagsVar, uint64_t InstAddress);
+    JccBBInstruction *
+    createJccBB(BasicBlock *JccDestBB, BasicBlock *JccNormalBB, FlagsVariable *FlagsVar, uint64_t InstAddress);
+
     // Load
     LoadInstruction *createLoad(Value *Ptr, uint64_t InstAddress);
 
@@ -15,18 +15,6 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
@@ -46,6 +34,13 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::JccAddr; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static JccAddrInstruction *get(Context &C, ConstantInt *JccDest, ConstantInt *JccNormal, FlagsVariable *FlagsVar);
 };
 
@@ -57,18 +52,6 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
@@ -97,6 +80,13 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::JccBB; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static JccBBInstruction *get(Context &C, BasicBlock *JccDestBB, BasicBlock *JccNormalBB, FlagsVariable *FlagsVar);
 };
 
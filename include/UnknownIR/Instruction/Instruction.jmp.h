@@ -14,18 +14,6 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
@@ -39,6 +27,13 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::JmpAddr; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static JmpAddrInstruction *get(Context &C, ConstantInt *JmpDest);
 };
 
@@ -50,18 +45,6 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
@@ -81,6 +64,13 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::JmpBB; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static JmpBBInstruction *get(Context &C, BasicBlock *DestBB);
 };
 
@@ -12,23 +12,18 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::Ret; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static ReturnInstruction *get(Context &C);
 };
 
@@ -40,18 +35,6 @@ public:
 
 public:
     // Virtual
-    // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const override;
-
-    // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const override;
-
-    // Is this instruction with result?
-    virtual bool hasResult() const override;
-
-    // Is this instruction with flags?
-    virtual bool hasFlags() const override;
-
     // Print the instruction
     virtual void printInst(unknown::raw_ostream &OS) const override;
 
@@ -65,6 +48,13 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I) { return I->getOpCodeID() == OpCodeID::RetIMM; }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
+
     static ReturnImmInstruction *get(Context &C, ConstantInt *ImmConstantInt);
 };
 
@@ -4,7 +4,9 @@
 #include <UnknownIR/FlagsVariable.h>
 
 #include <UnknownUtils/unknown/Support/raw_ostream.h>
+#include <UnknownUtils/unknown/ADT/SmallPtrSet.h>
 #include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/ADT/ilist_node.h>
 #include <unknown/tinyxml2/tinyxml2.h>
 
 namespace uir {
@@ -13,16 +15,23 @@ class BasicBlock;
 class LocalVariable;
 class Context;
 
-class Instruction : public LocalVariable
+class Instruction : public LocalVariable, public unknown::ilist_node<Instruction>
 {
+    friend class BasicBlock;
+
 protected:
     OpCodeID mOpCodeID;
     uint64_t mInstructionAddress;
     BasicBlock *mParent;
-    std::unique_ptr<FlagsVariable> mFlagsVariable;
-    std::unique_ptr<LocalVariable> mStackVariable;
     bool mEnablePrintOp;
 
+    // The flags/stack variable are owned by this instruction and only held by their uses, they are not operands
+    Use mFlagsVariableUse;
+    Use mStackVariableUse;
+
+    // The order of this instruction in its block, only meaningful while the order of the block is valid
+    mutable uint32_t mOrder;
+
 public:
     explicit Instruction(Context &C);
     explicit Instruction(Context &C, OpCodeID OpCodeId);
@@ -30,19 +39,21 @@ public:
     virtual ~Instruction();
 
 public:
-    // Virtual
+    // OpCode
     // Get the opcode name of this instruction
-    virtual unknown::StringRef getOpcodeName() const;
+    unknown::StringRef getOpcodeName() const { return getOpCodeComponent(mOpCodeID).mOpCodeName; }
 
     // Get the default number of operands
-    virtual uint32_t getDefaultNumberOfOperands() const;
+    uint32_t getDefaultNumberOfOperands() const { return getOpCodeComponent(mOpCodeID).mNumberOfOperands; }
 
     // Is this instruction with result?
-    virtual bool hasResult() const;
+    bool hasResult() const { return getOpCodeComponent(mOpCodeID).mHasResult; }
 
     // Is this instruction with flags?
-    virtual bool hasFlags() const;
+    bool hasFlags() const { return getOpCodeComponent(mOpCodeID).mHasFlags; }
 
+public:
+    // Virtual
     // Get the property 'inst' of the value
     virtual unknown::StringRef getPropertyInst() const;
 
@@ -85,7 +96,7 @@ public:
     void setParent(BasicBlock *BB);
 
     // Get the opcode of this instruction
-    const OpCodeID getOpCodeID() const;
+    const OpCodeID getOpCodeID() const { return mOpCodeID; }
 
     // Set the opcode of this instruction
     void setOpCodeID(OpCodeID OpCodeId);
@@ -143,6 +154,15 @@ public:
     // Clear all operands in this instruction.
     void clearAllOperands();
 
+    // Clear all operands in this instruction, the operands in FreedOperands were already freed by another instruction
+    // and the ones freed here are added to it.
+    void clearAllOperands(unknown::SmallPtrSetImpl<Value *> &FreedOperands);
+
+public:
+    // Order
+    // Is this instruction before the other instruction of the same block?
+    bool comesBefore(const Instruction *Other) const;
+
 public:
     // Enabled
     // Enable 'print detailed op'
@@ -150,6 +170,14 @@ public:
 
     // Is this instruction Enable 'print detailed op'?
     bool hasPrintOp() const;
+
+public:
+    // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return V->getValueID() == InstructionVal; }
+
+    // Is the operand freed with its last user? The shared values, such as constants, globals and blocks, are not.
+    static bool isOwnedOperand(const Value *OP);
 };
 
 class TerminatorInstruction : public Instruction
@@ -205,6 +233,18 @@ public:
 
     // Erase a successor into the terminator instruction.
     void eraseSuccessor(BasicBlock *Successor);
+
+public:
+    // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Instruction *I)
+    {
+        return I->getOpCodeID() >= OpCodeID::Ret && I->getOpCodeID() <= OpCodeID::JccBB;
+    }
+    static bool classof(const Value *V)
+    {
+        return unknown::isa<Instruction>(V) && classof(unknown::cast<Instruction>(V));
+    }
 };
 
 } // namespace uir
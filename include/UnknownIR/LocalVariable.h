@@ -25,9 +25,18 @@ public:
 
 public:
     // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V)
+    {
+        return V->getValueID() >= LocalVariableVal && V->getValueID() <= InstructionVal;
+    }
+
     // Generate a new value name by order
     static std::string generateOrderedLocalVarName(Context &C);
 
+    // Generate a new value index by order, the value is named after it
+    static uint32_t generateOrderedLocalVarIndex(Context &C);
+
     // Allocate a LocalVariable
     static LocalVariable *get(Type *Ty, const unknown::StringRef &LocalVariableName, uint64_t LocalVariableAddress);
     static LocalVariable *get(Type *Ty);
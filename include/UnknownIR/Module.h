@@ -36,6 +36,11 @@ public:
     // Context
     Context &getContext() const;
 
+public:
+    // Arena
+    // Get the number of bytes allocated from the arenas of the functions, see Function::ArenaScope
+    size_t getArenaBytesAllocated() const;
+
 public:
     // Iterators
     // Function Iterators
@@ -138,6 +143,26 @@ public:
     // Print the module
     void print(unknown::XMLPrinter &Printer) const;
 
+    // Print the module, the functions are printed on NumThreads threads, 0 means all hardware threads.
+    // The output is the same as the one of print.
+    void printParallel(unknown::raw_ostream &OS, uint32_t NumThreads = 0) const;
+
+    // Print the module to a file on NumThreads threads, the file is only kept if the whole module is written
+    bool printToFile(const unknown::StringRef &FilePath, uint32_t NumThreads = 1) const;
+
+private:
+    // Print the start tag, the attributes and the global variables of the module
+    void printHeader(unknown::XMLPrinter &Printer) const;
+
+public:
+    // Binary
+    // Write the module in the binary format, returns false if the module has something the format can not describe.
+    // The bodies of the functions can be loaded one by one with ModuleReader.
+    bool writeBinary(unknown::raw_ostream &OS) const;
+
+    // Write the module to a file in the binary format, the file is only kept if the whole module is written
+    bool writeBinaryToFile(const unknown::StringRef &FilePath) const;
+
 public:
     // Static
     static std::unique_ptr<Module> get(Context &C, const unknown::StringRef &ModuleName);
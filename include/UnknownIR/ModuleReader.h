@@ -0,0 +1,87 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <UnknownIR/Module.h>
+
+#include <UnknownUtils/unknown/ADT/DenseMap.h>
+#include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/Support/MemoryBuffer.h>
+
+namespace uir {
+
+// Read a module written by Module::writeBinary.
+// The global variables and the functions are created when the file is opened, the basic blocks of a function are only
+// read when the function is materialized. The file is mapped into memory and has to outlive the reader.
+// The reader is not thread safe.
+class ModuleReader
+{
+private:
+    // The index entry of a function
+    struct FunctionEntry
+    {
+        Function *mFunction;
+        uint64_t mBodyOffset;
+        uint64_t mBodySize;
+        bool mMaterialized;
+    };
+
+private:
+    Context &mContext;
+    std::unique_ptr<unknown::MemoryBuffer> mBuffer;
+    std::unique_ptr<Module> mModule;
+    std::vector<unknown::StringRef> mStrings;
+    std::vector<Type *> mTypes;
+    std::vector<GlobalVariable *> mGlobalVariables;
+    std::vector<FunctionEntry> mFunctionEntries;
+    unknown::DenseMap<const Function *, size_t> mFunctionIndices;
+
+public:
+    explicit ModuleReader(Context &C, std::unique_ptr<unknown::MemoryBuffer> Buffer);
+    ~ModuleReader();
+
+public:
+    // Get/Set
+    // Get the module, nullptr once it is taken
+    Module *getModule() const;
+
+    // Take the module, all functions are materialized first. Returns nullptr if one of them can not be read.
+    std::unique_ptr<Module> takeModule();
+
+    // Get the strings of the string table
+    const std::vector<unknown::StringRef> &getStrings() const { return mStrings; }
+
+    // Get the types of the type table
+    const std::vector<Type *> &getTypes() const { return mTypes; }
+
+    // Get the global variables of the module record
+    const std::vector<GlobalVariable *> &getGlobalVariables() const { return mGlobalVariables; }
+
+public:
+    // Materialize
+    // Are the basic blocks of the function read?
+    bool isMaterialized(const Function *F) const;
+
+    // Read the basic blocks of a function of the module, returns false if its body is corrupted
+    bool materialize(Function *F);
+
+    // Read the basic blocks of all functions of the module
+    bool materializeAll();
+
+private:
+    // Read the string table, the type table and the module record
+    bool readModule();
+
+public:
+    // Static
+    // Open a module in the binary format, returns nullptr if the header or the tables are corrupted
+    static std::unique_ptr<ModuleReader> get(Context &C, std::unique_ptr<unknown::MemoryBuffer> Buffer);
+
+    // Open a module file in the binary format, the file is mapped into memory
+    static std::unique_ptr<ModuleReader> get(Context &C, const unknown::StringRef &FilePath);
+
+    // Read a whole module file in the binary format
+    static std::unique_ptr<Module> readModuleFile(Context &C, const unknown::StringRef &FilePath);
+};
+
+} // namespace uir
@@ -14,6 +14,7 @@
 #include <optional>
 #include <memory>
 
+#include <UnknownUtils/unknown/ADT/StringRef.h>
 #include <UnknownUtils/unknown/Support/raw_ostream.h>
 
 namespace uir {
@@ -28,7 +29,7 @@ public:
 public:
     // Pure virtual functions
     // Get the name of this object
-    virtual std::string getName() const = 0;
+    virtual unknown::StringRef getName() const = 0;
 
     // Get the readable name of this object
     virtual std::string getReadableName() const = 0;
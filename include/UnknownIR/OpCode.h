@@ -1,4 +1,6 @@
 #pragma once
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -32,7 +34,10 @@ enum class OpCodeID : uint8_t
     JccBB,
 
     // Unknown
-    Unknown
+    Unknown,
+
+    // The number of opcodes
+    NumOpCodes
 };
 
 struct OpCodeComponent
@@ -110,6 +115,32 @@ const OpCodeComponent JccBBComponent      = {    OpCodeID::JccBB,       "uir.jcc
 // Unknown
 // ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 const OpCodeComponent UnknownComponent    = {    OpCodeID::Unknown,     "uir.unknown",      0,      false,      false};
+
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// All components, indexed by OpCodeID
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const OpCodeComponent OpCodeComponentTable[] = {
+    LoadComponent,      StoreComponent,     GBPComponent,
+    AddComponent,       SubComponent,
+    XorComponent,       OrComponent,        AndComponent,       NotComponent,
+    RetComponent,       RetIMMComponent,    JmpAddrComponent,   JmpBBComponent,     JccAddrComponent,   JccBBComponent,
+    UnknownComponent,
+};
 // clang-format on
 
+static_assert(
+    sizeof(OpCodeComponentTable) / sizeof(OpCodeComponentTable[0]) == static_cast<size_t>(OpCodeID::NumOpCodes),
+    "OpCodeComponentTable is out of sync with OpCodeID!");
+
+// Get the component of an opcode
+inline const OpCodeComponent &
+getOpCodeComponent(OpCodeID OpCodeId)
+{
+    assert(OpCodeId < OpCodeID::NumOpCodes && "Invalid opcode!");
+    const OpCodeComponent &Component = OpCodeComponentTable[static_cast<size_t>(OpCodeId)];
+    assert(Component.mOpCodeID == OpCodeId && "OpCodeComponentTable is out of order!");
+    return Component;
+}
+
 } // namespace uir
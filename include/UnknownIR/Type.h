@@ -117,6 +117,9 @@ public:
     // Static
     // Get or create an IntegerType instance.
     static IntegerType *get(Context &C, uint32_t NumBits);
+
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Type *T) { return T->getTypeID() == IntegerTyID; }
 };
 
 class PointerType : public Type
@@ -136,6 +139,9 @@ public:
 public:
     // Static
     static PointerType *get(Context &C, Type *ElementType);
+
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Type *T) { return T->getTypeID() == PointerTyID; }
 };
 
 } // namespace uir
@@ -11,6 +11,8 @@
 #include <UnknownIR/Instruction.h>
 #include <UnknownIR/IRBuilder.h>
 #include <UnknownIR/Module.h>
+#include <UnknownIR/ModuleReader.h>
+#include <UnknownIR/XMLModuleReader.h>
 #include <UnknownIR/BasicBlock.h>
 #include <UnknownIR/Function.h>
 #include <UnknownIR/Argument.h>
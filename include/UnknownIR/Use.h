@@ -0,0 +1,68 @@
+#pragma once
+#include <cassert>
+
+namespace uir {
+
+class Value;
+class User;
+
+// The edge between a user and one of the values it references.
+// The uses of a value are linked into an intrusive list headed by the value, so adding, removing and replacing a use
+// never allocates or hashes.
+class Use
+{
+private:
+    Value *mVal;
+    Use *mNext;
+    Use **mPrev;
+    User *mParent;
+
+public:
+    explicit Use(User *Parent);
+    explicit Use(User *Parent, Value *Val);
+    Use(const Use &) = delete;
+    Use &operator=(const Use &) = delete;
+    Use(Use &&Other);
+    Use &operator=(Use &&Other);
+    ~Use();
+
+public:
+    // Get/Set
+    // Get the value of this use
+    Value *get() const { return mVal; }
+    operator Value *() const { return mVal; }
+    Value *operator->() const { return mVal; }
+
+    // Set the value of this use and move it to the use list of the new value
+    void set(Value *Val);
+    Use &operator=(Value *Val)
+    {
+        set(Val);
+        return *this;
+    }
+
+    // Get the user of this use
+    User *getUser() const { return mParent; }
+
+    // Get the next use in the use list of the value
+    Use *getNext() const { return mNext; }
+
+    // Is this use in the use list of its value?
+    bool isLinked() const { return mPrev != nullptr; }
+
+public:
+    // Link/Unlink
+    // Unlink this use from the use list of its value, the value stays readable
+    void unlink();
+
+private:
+    // Link this use at the head of the list
+    void addToList(Use **List);
+
+    // Take over the value and the list position of another use
+    void takeOver(Use &Other);
+
+    friend class Value;
+};
+
+} // namespace uir
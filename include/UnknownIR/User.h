@@ -1,12 +1,17 @@
 #pragma once
 #include <UnknownIR/Value.h>
 
+#include <UnknownUtils/unknown/ADT/SmallVector.h>
+#include <UnknownUtils/unknown/ADT/iterator.h>
+
 namespace uir {
 
 class User : public Value
 {
 public:
-    using OperandListType = std::vector<Value *>;
+    // The operands are stored inline, the instructions have at most two operands
+    static constexpr unsigned NumInlineOperands = 2;
+    using OperandListType = unknown::SmallVector<Use, NumInlineOperands>;
 
 private:
     OperandListType mOperandList;
@@ -22,14 +27,34 @@ public:
     OperandListType &getOperandList();
     const OperandListType &getOperandList() const;
 
+private:
+    // Iterate over the values of the operands
+    template <typename ValueT, typename UseT>
+    struct value_op_iterator_impl : unknown::iterator_adaptor_base<
+                                        value_op_iterator_impl<ValueT, UseT>,
+                                        UseT *,
+                                        std::random_access_iterator_tag,
+                                        ValueT *,
+                                        std::ptrdiff_t,
+                                        ValueT *,
+                                        ValueT *>
+    {
+        explicit value_op_iterator_impl(UseT *U = nullptr) : value_op_iterator_impl::iterator_adaptor_base(U) {}
+
+        ValueT *operator*() const { return this->I->get(); }
+        ValueT *operator->() const { return operator*(); }
+    };
+
 public:
     // Iterator
-    using op_iterator = OperandListType::iterator;
-    using const_op_iterator = OperandListType::const_iterator;
+    using op_iterator = value_op_iterator_impl<Value, Use>;
+    using const_op_iterator = value_op_iterator_impl<const Value, const Use>;
     op_iterator op_begin();
     const_op_iterator op_begin() const;
     op_iterator op_end();
     const_op_iterator op_end() const;
+    unknown::iterator_range<op_iterator> operand_values();
+    unknown::iterator_range<const_op_iterator> operand_values() const;
     Value *op_back();
     Value *op_front();
     void op_push(Value *V);
@@ -53,10 +78,14 @@ public:
     const Value *getOperand(size_t Index) const;
     Value *getOperand(size_t Index);
 
+    // Get the use of the operand at the specified index.
+    const Use &getOperandUse(size_t Index) const;
+    Use &getOperandUse(size_t Index);
+
     // Set the operand at the specified index.
     void setOperand(size_t Index, Value *Val);
 
-    // Set the operand at the specified index and update the user list.
+    // Set the operand at the specified index, the operand must not be null.
     void setOperandAndUpdateUsers(size_t Index, Value *Val);
 
 public:
@@ -64,17 +93,22 @@ public:
     // Insert the specified value.
     void insertOperand(Value *Val);
 
-    // Insert the specified value and update the user list.
+    // Insert the specified value, the value must not be null.
     void insertOperandAndUpdateUsers(Value *Val);
 
     // Erase the specified value.
     void eraseOperand(Value *Val);
 
-    // Erase the specified value and update the user list.
+    // Erase the specified value, the value must not be null.
     void eraseOperandAndUpdateUsers(Value *Val);
 
-    // Drop all references to operands.
+    // Drop all references to operands, the operands stay readable until they are cleared.
     void dropAllReferences();
+
+public:
+    // Static
+    // Methods for support type inquiry through isa, cast, and dyn_cast
+    static bool classof(const Value *V) { return true; }
 };
 
 } // namespace uir
\ No newline at end of file
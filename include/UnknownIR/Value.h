@@ -1,9 +1,20 @@
 #pragma once
+#include <new>
+#include <utility>
+
+#include <UnknownIR/Context.h>
 #include <UnknownIR/Object.h>
 #include <UnknownIR/Type.h>
+#include <UnknownIR/Use.h>
 
+#include <UnknownUtils/unknown/Support/Casting.h>
 #include <UnknownUtils/unknown/Support/raw_ostream.h>
 #include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/ADT/iterator_range.h>
+
+namespace unknown {
+class XMLPrinter;
+} // namespace unknown
 
 namespace uir {
 
@@ -13,39 +24,89 @@ class User;
 class Value : public Object
 {
 public:
-    using UsersListType = std::unordered_set<User *>;
     using ExtraInfoListType = std::vector<std::string>;
 
+    // The kind of the most derived class of a value, used by isa/cast/dyn_cast instead of RTTI.
+    // The kinds of a class and its subclasses are contiguous, so classof can check a range.
+    enum ValueID : uint8_t
+    {
+        UserVal,
+        ConstantVal,
+        ConstantIntVal,
+        ArgumentVal,
+        FunctionContextVal,
+        FunctionVal,
+        BasicBlockVal,
+        GlobalVariableVal,
+        GlobalArrayVal,
+        LocalVariableVal,
+        FlagsVariableVal,
+        InstructionVal,
+    };
+
 protected:
     Type *mType;
-    std::string mValueName;
+
+    // The name is interned in the string pool of the context, nullptr if the value has no name
+    const char *mValueName;
 
 protected:
-    UsersListType mUsers;
+    // The head of the intrusive list of the uses of this value
+    Use *mUseList;
 
 protected:
-    ExtraInfoListType mExtraInfoList;
-    std::string mComment;
+    // The kind of this value, set by the constructor of each class
+    ValueID mValueID;
+
+private:
+    // Has this value a comment or extra info in the side table of the context?
+    bool mHasAnnotation : 1;
+
+    // The id of the arena of the function this value was built for, 0 if it is on the heap
+    uint32_t mArenaID;
 
 public:
     Value();
     explicit Value(Type *Ty, const unknown::StringRef &ValueName);
     virtual ~Value();
 
+    // Destroy the value, the memory of an arena value is released with the arena
+    void operator delete(Value *V, std::destroying_delete_t);
+
+protected:
+    // Construct a value, from the arena of the function being built on the current thread if there is one
+    template <typename T, typename... ArgsT>
+    static T *construct(Context &C, ArgsT &&...Args)
+    {
+        uint32_t ArenaID = 0;
+        if (void *Mem = C.allocate(sizeof(T), alignof(T), ArenaID))
+        {
+            T *V = ::new (Mem) T(std::forward<ArgsT>(Args)...);
+            static_cast<Value *>(V)->mArenaID = ArenaID;
+            return V;
+        }
+
+        return new T(std::forward<ArgsT>(Args)...);
+    }
+
 public:
     // Context
     Context &getContext() const;
 
-public:
-    // User
-    const UsersListType &getUsers() const;
-    UsersListType &getUsers();
+    // Get the kind of this value
+    ValueID getValueID() const { return mValueID; }
+
+    // Get the id of the arena of the function this value was built for, 0 if it is on the heap
+    uint32_t getArenaID() const { return mArenaID; }
 
 public:
     // Get/Set the name of the value
     bool hasName() const;
     void setName(const char *ValueName);
 
+    // Set the name of the value to the base name followed by the index
+    void setName(const unknown::StringRef &BaseName, uint32_t Index);
+
     // Get/Set the type of the value
     Type *getType() const;
     void setType(Type *Ty);
@@ -55,7 +116,7 @@ public:
     uint32_t getValueSize() const;
 
     // Get the extra info of this object
-    const ExtraInfoListType &getExtraInfoList() const;
+    const ExtraInfoListType getExtraInfoList() const;
 
     // Set the extra info of this object
     void setExtraInfoList(const ExtraInfoListType &ExtraInfo);
@@ -77,26 +138,154 @@ public:
     // Add the comment of this object
     void addComment(const unknown::StringRef &Comment);
 
+private:
+    // Update the side table entry of this object, it is created on first use
+    template <typename UpdateT>
+    void updateAnnotation(UpdateT Update);
+
+private:
+    // Iterate over the use list
+    template <typename UseT>
+    class use_iterator_impl
+    {
+        friend class Value;
+        template <typename>
+        friend class use_iterator_impl;
+
+    private:
+        UseT *U;
+
+        explicit use_iterator_impl(UseT *u) : U(u) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = UseT *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type *;
+        using reference = value_type &;
+
+        use_iterator_impl() : U() {}
+
+        bool operator==(const use_iterator_impl &x) const { return U == x.U; }
+        bool operator!=(const use_iterator_impl &x) const { return !operator==(x); }
+
+        use_iterator_impl &operator++()
+        {
+            assert(U && "Cannot increment end iterator!");
+            U = U->getNext();
+            return *this;
+        }
+
+        use_iterator_impl operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        UseT &operator*() const
+        {
+            assert(U && "Cannot dereference end iterator!");
+            return *U;
+        }
+
+        UseT *operator->() const { return &operator*(); }
+
+        operator use_iterator_impl<const UseT>() const { return use_iterator_impl<const UseT>(U); }
+    };
+
+    // Iterate over the users of the use list, a user is visited once per use
+    template <typename UserT>
+    class user_iterator_impl
+    {
+        friend class Value;
+        template <typename>
+        friend class user_iterator_impl;
+
+    private:
+        Use *U;
+
+        explicit user_iterator_impl(Use *u) : U(u) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = UserT *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type *;
+        using reference = value_type &;
+
+        user_iterator_impl() : U() {}
+
+        bool operator==(const user_iterator_impl &x) const { return U == x.U; }
+        bool operator!=(const user_iterator_impl &x) const { return !operator==(x); }
+
+        user_iterator_impl &operator++()
+        {
+            assert(U && "Cannot increment end iterator!");
+            U = U->getNext();
+            return *this;
+        }
+
+        user_iterator_impl operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        UserT *operator*() const
+        {
+            assert(U && "Cannot dereference end iterator!");
+            return U->getUser();
+        }
+
+        UserT *operator->() const { return operator*(); }
+
+        operator user_iterator_impl<const UserT>() const { return user_iterator_impl<const UserT>(U); }
+
+        Use &getUse() const
+        {
+            assert(U && "Cannot dereference end iterator!");
+            return *U;
+        }
+    };
+
 public:
     // Iterator
-    using user_iterator = UsersListType::iterator;
-    using const_user_iterator = UsersListType::const_iterator;
-    user_iterator user_begin();
-    const_user_iterator user_begin() const;
-    user_iterator user_end();
-    const_user_iterator user_end() const;
-    bool user_empty() const;
-    bool user_contains(User *U) const;
-    size_t user_size() const;
-    size_t user_count(User *U) const;
-    void user_insert(User *U);
-    void user_erase(User *U);
-    void user_clear();
+    using use_iterator = use_iterator_impl<Use>;
+    using const_use_iterator = use_iterator_impl<const Use>;
+    use_iterator use_begin() { return use_iterator(mUseList); }
+    const_use_iterator use_begin() const { return const_use_iterator(mUseList); }
+    use_iterator use_end() { return use_iterator(); }
+    const_use_iterator use_end() const { return const_use_iterator(); }
+    unknown::iterator_range<use_iterator> uses() { return {use_begin(), use_end()}; }
+    unknown::iterator_range<const_use_iterator> uses() const { return {use_begin(), use_end()}; }
+
+    using user_iterator = user_iterator_impl<User>;
+    using const_user_iterator = user_iterator_impl<const User>;
+    user_iterator user_begin() { return user_iterator(mUseList); }
+    const_user_iterator user_begin() const { return const_user_iterator(mUseList); }
+    user_iterator user_end() { return user_iterator(); }
+    const_user_iterator user_end() const { return const_user_iterator(); }
+    unknown::iterator_range<user_iterator> users() { return {user_begin(), user_end()}; }
+    unknown::iterator_range<const_user_iterator> users() const { return {user_begin(), user_end()}; }
+
+    bool use_empty() const { return mUseList == nullptr; }
+    bool user_empty() const { return mUseList == nullptr; }
+    bool hasOneUse() const { return mUseList && mUseList->getNext() == nullptr; }
+    bool user_contains(const User *U) const;
+    size_t getNumUses() const;
+
+private:
+    // Link a use into the use list of this value
+    void addUse(Use &U);
+
+    friend class Use;
 
 public:
     // Virtual functions
-    // Get the name of the value
-    virtual std::string getName() const override;
+    // Get the name of the value, it points into the string pool of the context
+    virtual unknown::StringRef getName() const override;
 
     // Get the readable name of the value
     virtual std::string getReadableName() const override;
@@ -130,6 +319,13 @@ public:
 
     // Change all uses of this to point to a new Value.
     virtual void replaceAllUsesWith(Value *V) = 0;
+
+protected:
+    // Push the extra info of this object as the attribute 'extra', if it has any
+    void pushExtraAttribute(unknown::XMLPrinter &Printer) const;
+
+    // Push the comment info of this object as the attribute 'comment', if it has any
+    void pushCommentAttribute(unknown::XMLPrinter &Printer) const;
 };
 
 } // namespace uir
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <UnknownIR/Module.h>
+
+#include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/ADT/StringSet.h>
+
+namespace uir {
+
+// Read the XML written by Module::print back into a module.
+// The XML is read in a single pass without building a document, the functions that are filtered out are skipped
+// without being parsed. The printed form does not hold the values of the flags, the addresses of the local variables
+// and the elements of the global arrays, so they are not restored. The predecessors are rebuilt from the branches.
+// The operands are matched by their readable names, and a global variable that is only used by the instructions is
+// added to the module, so it is printed with the global variables once the module is read.
+class XMLModuleReader
+{
+private:
+    Context &mContext;
+    unknown::StringSet<> mFunctionNames;
+    std::vector<std::pair<uint64_t, uint64_t>> mFunctionRanges;
+    std::string mError;
+
+public:
+    explicit XMLModuleReader(Context &C);
+    ~XMLModuleReader();
+
+public:
+    // Filter
+    // Load the function with this name, all functions are loaded if there is no filter
+    void addFunctionName(const unknown::StringRef &FunctionName);
+
+    // Load the functions that overlap the range [Begin, End), all functions are loaded if there is no filter
+    void addFunctionRange(uint64_t Begin, uint64_t End);
+
+    // Is there a filter?
+    bool hasFilter() const;
+
+    // Is the function loaded?
+    bool isFunctionSelected(const unknown::StringRef &FunctionName, uint64_t Begin, uint64_t End) const;
+
+public:
+    // Get/Set
+    // Get the error of the last read, empty if it succeeded
+    const std::string &getError() const { return mError; }
+
+public:
+    // Read
+    // Read a module printed by Module::print, returns nullptr if the XML is invalid
+    std::unique_ptr<Module> read(unknown::StringRef Buffer);
+
+    // Read a module file printed by Module::printToFile, the file is mapped into memory
+    std::unique_ptr<Module> readFile(const unknown::StringRef &FilePath);
+
+public:
+    // Static
+    // Read a whole module file printed by Module::printToFile
+    static std::unique_ptr<Module> readModuleFile(Context &C, const unknown::StringRef &FilePath);
+};
+
+} // namespace uir
@@ -0,0 +1,39 @@
+#pragma once
+#include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/Support/raw_ostream.h>
+#include <unknown/tinyxml2/tinyxml2.h>
+
+namespace uir {
+
+// An XML printer that writes each element to the output stream as it is printed.
+// The output is the same as the one of unknown::XMLPrinter, but the document is never held in memory.
+class XMLStreamPrinter : public unknown::XMLPrinter
+{
+private:
+    unknown::raw_ostream &mOS;
+
+public:
+    // The elements are indented as if they were nested Depth levels deep
+    explicit XMLStreamPrinter(unknown::raw_ostream &OS, int Depth = 0);
+    virtual ~XMLStreamPrinter();
+
+public:
+    // Write an element printed by another printer with the depth of the next child of the open element.
+    // The output is the same as if the element was printed by this printer, so elements can be printed in parallel.
+    void pushPrintedElement(unknown::StringRef Element);
+
+protected:
+    // Virtual
+    using unknown::XMLPrinter::Write;
+
+    // Write the data to the output stream
+    virtual void Write(const char *data, size_t size) override;
+
+    // Write a character to the output stream
+    virtual void Putc(char ch) override;
+
+    // Write the formatted string to the output stream
+    virtual void Print(const char *format, ...) override;
+};
+
+} // namespace uir
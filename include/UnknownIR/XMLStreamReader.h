@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <UnknownUtils/unknown/ADT/SmallVector.h>
+#include <UnknownUtils/unknown/ADT/StringRef.h>
+
+namespace uir {
+
+// A pull reader of the XML written by XMLStreamPrinter.
+// Each call of next() reads one tag of the buffer, the names and the attributes point into the buffer, so the document
+// is never held in memory. Text, comments and declarations between the tags are skipped.
+class XMLStreamReader
+{
+public:
+    enum class TokenKind
+    {
+        StartElement,
+        EndElement,
+        EndOfDocument,
+        Error
+    };
+
+private:
+    const char *mBegin;
+    const char *mPtr;
+    const char *mEnd;
+    TokenKind mTokenKind;
+    unknown::StringRef mName;
+    unknown::SmallVector<std::pair<unknown::StringRef, unknown::StringRef>, 8> mAttributes;
+    unknown::SmallVector<unknown::StringRef, 8> mOpenElements;
+    bool mPendingEnd;
+    std::string mError;
+
+public:
+    explicit XMLStreamReader(unknown::StringRef Buffer);
+    ~XMLStreamReader();
+
+public:
+    // Read
+    // Read the next tag, a self-closing element is read as a start and an end element
+    TokenKind next();
+
+    // Skip the children of the element that was just started, its end element becomes the current tag
+    bool skipElement();
+
+public:
+    // Get/Set
+    // Get the kind of the current tag
+    TokenKind getTokenKind() const { return mTokenKind; }
+
+    // Get the name of the current element
+    unknown::StringRef getName() const { return mName; }
+
+    // Get the number of the open elements, the current start element included
+    size_t getDepth() const { return mOpenElements.size(); }
+
+    // Get the offset of the current position in the buffer
+    uint64_t getOffset() const { return mPtr - mBegin; }
+
+    // Get the error, empty if there is none
+    const std::string &getError() const { return mError; }
+
+    // Get the value of an attribute of the current start element.
+    // The value points into the buffer unless it has entities, then it is decoded into Storage.
+    std::optional<unknown::StringRef>
+    getAttribute(unknown::StringRef Name, unknown::SmallVectorImpl<char> &Storage) const;
+
+    // Get the value of an attribute of the current start element, empty if it is missing
+    std::string getAttribute(unknown::StringRef Name) const;
+
+private:
+    // Read the attributes and the end of a start tag
+    TokenKind readStartTag();
+
+    // Read an end tag
+    TokenKind readEndTag();
+
+    // Skip to the end of a comment, a declaration or a processing instruction
+    bool skipMarkup();
+
+    // Stop reading
+    TokenKind fail(const unknown::StringRef &Error);
+
+public:
+    // Static
+    // Decode the entities of a value, returns false if one of them is invalid
+    static bool decodeEntities(unknown::StringRef Value, unknown::SmallVectorImpl<char> &Decoded);
+};
+
+} // namespace uir
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "unknown/ADT/StringRef.h"
+#include "unknown/Support/MemoryBuffer.h"
+#include "unknown/Symbol/SymbolParser.h"
+
+namespace unknown {
+
+// A symbol cache file is a flat array of fixed size function symbol records followed by one blob of names.
+// It is keyed by the identity of the symbol file: the GUID and the age of a PDB, the hash of a MAP file.
+//
+//   Header: magic, version, key, image base, number of symbols, size of the names
+//   Records: name, internal name, rva, size, frame and flags of each function symbol
+//   Names: NUL terminated names, a record points at them by offset and size
+//
+// All fields are little endian, so a cache file can be mapped and read on any host.
+
+////////////////////////////////////////////////////////////////////////////////////////
+//// Function
+// Get the path of the cache file of the symbol file identified by Key
+std::string
+GetSymbolCachePath(StringRef CacheDirectory, StringRef Key);
+
+// Read the function symbols of a cache file, returns false if it is missing, invalid or was written for another key.
+// The names point into the mapped cache file, which is handed out in Buffer.
+bool
+ReadSymbolCache(
+    StringRef CachePath,
+    StringRef Key,
+    uint64_t &ImageBase,
+    std::vector<SymbolParser::FunctionSymbol> &FunctionSymbols,
+    std::unique_ptr<MemoryBuffer> &Buffer);
+
+// Write the function symbols to a cache file, the file is removed if it could not be written
+bool
+WriteSymbolCache(
+    StringRef CachePath,
+    StringRef Key,
+    uint64_t ImageBase,
+    const std::vector<SymbolParser::FunctionSymbol> &FunctionSymbols);
+
+} // namespace unknown
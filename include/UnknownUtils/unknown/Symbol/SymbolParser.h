@@ -4,17 +4,22 @@
 #include <string>
 #include <memory>
 
+#include "unknown/ADT/ArrayRef.h"
 #include "unknown/ADT/StringRef.h"
+#include "unknown/Support/Allocator.h"
+#include "unknown/Support/MemoryBuffer.h"
 
 namespace unknown {
 
 class SymbolParser
 {
 public:
+    // The names point into the symbol file mapped by the parser or into its name arena, they are not always NUL
+    // terminated and stay valid until the parser parses again or is destroyed
     struct CommonSymbol
     {
-        std::string name = "";
-        std::string internal_name = "";
+        StringRef name;
+        StringRef internal_name;
         uint32_t rva = 0;
     };
 
@@ -50,22 +55,44 @@ protected:
     std::vector<CommonSymbol> mCommonSymbols;
     std::vector<FunctionSymbol> mFunctionSymbols;
     uint64_t mImageBase;
+    std::string mCacheDirectory;
+    std::unique_ptr<MemoryBuffer> mSymbolFileBuffer;
+    BumpPtrAllocator mNameAllocator;
 
 public:
     SymbolParser() : mImageBase(0) {}
-    ~SymbolParser() = default;
+    virtual ~SymbolParser() = default;
 
 public:
     // Parser
     virtual bool ParseCommonSymbols(StringRef SymFilePath) = 0;
     virtual bool ParseFunctionSymbols(StringRef SymFilePath) = 0;
 
+protected:
+    // Cache
+    // Load the function symbols cached for the symbol file identified by Key
+    bool ReadFunctionSymbolCache(StringRef Key);
+
+    // Cache the function symbols of the symbol file identified by Key
+    bool WriteFunctionSymbolCache(StringRef Key) const;
+
+    // Name
+    // Keep a name that does not live in a mapped file in the name arena
+    StringRef SaveSymbolName(StringRef Name);
+
+    // Drop the symbols of the last parse along with the mapped file and the arena their names point into
+    void ClearSymbols();
+
 public:
     // Get/Set
     uint64_t getImageBase() const { return mImageBase; }
     void setImageBase(uint64_t imageBase) { mImageBase = imageBase; }
-    std::vector<FunctionSymbol> &getFunctionSymbols() { return mFunctionSymbols; }
-    std::vector<CommonSymbol> &getAllSymbols() { return mCommonSymbols; }
+    ArrayRef<FunctionSymbol> getFunctionSymbols() const { return mFunctionSymbols; }
+    ArrayRef<CommonSymbol> getAllSymbols() const { return mCommonSymbols; }
+
+    // The function symbols are cached in this directory, an empty directory disables the cache
+    const std::string &getCacheDirectory() const { return mCacheDirectory; }
+    void setCacheDirectory(StringRef CacheDirectory) { mCacheDirectory = CacheDirectory.str(); }
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
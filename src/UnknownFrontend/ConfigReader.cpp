@@ -1,4 +1,8 @@
 #include "ConfigReader.h"
+#include "Error.h"
+
+#include <algorithm>
+#include <format>
 
 namespace ufrontend {
 
@@ -17,6 +21,7 @@ bool
 ConfigReader::ParseConfig()
 {
     mFunctionItems.clear();
+    buildFunctionIndex();
 
     if (mConfigFilePath.empty())
     {
@@ -44,6 +49,9 @@ ConfigReader::ParseConfig()
     // Parse function info
     ParseFunctionInfo(Root);
 
+    // Index the function info
+    buildFunctionIndex();
+
     return true;
 }
 
@@ -56,11 +64,15 @@ ConfigReader::ParseFunctionInfo(unknown::XMLElement *Root)
     for (unknown::XMLElement *CurrenteleElement = Root->FirstChildElement("f"); CurrenteleElement;
          CurrenteleElement = CurrenteleElement->NextSiblingElement("f"))
     {
+        // <f name = "..."/> is an exact name, <f pattern = "..."/> is a glob pattern.
+        // Note that '?' is a wildcard in a pattern, the '?' of a mangled name is written as "[?]".
         auto Name = CurrenteleElement->Attribute("name");
-        if (Name)
+        auto Pattern = CurrenteleElement->Attribute("pattern");
+        if (Name || Pattern)
         {
             FunctionItem Item{};
-            Item.Name = Name;
+            Item.Name = Name ? Name : Pattern;
+            Item.IsPattern = Name == nullptr;
             for (int i = 1; 1; ++i)
             {
                 auto AttrIdx = std::string("attribute") + std::to_string(i);
@@ -80,6 +92,145 @@ ConfigReader::ParseFunctionInfo(unknown::XMLElement *Root)
     }
 }
 
+////////////////////////////////////////////////////////////
+// Index
+// Build the index of the function items
+void
+ConfigReader::buildFunctionIndex()
+{
+    mFunctionNameMap.clear();
+    mFunctionPatternMatcher.clear();
+
+    for (uint32_t Index = 0; Index < mFunctionItems.size(); ++Index)
+    {
+        const auto &Item = mFunctionItems[Index];
+        if (!Item.IsPattern)
+        {
+            // The first item of a name wins
+            mFunctionNameMap.try_emplace(Item.Name, Index);
+        }
+        else if (!mFunctionPatternMatcher.add(Item.Name, Index))
+        {
+            std::cerr << std::format(UFRONTEND_ERROR_PREFIX "ConfigReader: invalid pattern {}", Item.Name)
+                      << std::endl;
+        }
+    }
+}
+
+// Add a pattern of the item, returns false if the pattern is not valid
+bool
+ConfigReader::FunctionPatternMatcher::add(unknown::StringRef Pattern, uint32_t ItemIndex)
+{
+    auto hasWildcard = [](unknown::StringRef Str) { return Str.find_first_of("?*[") != unknown::StringRef::npos; };
+
+    auto addLength = [](std::vector<size_t> &Lengths, size_t Length) {
+        auto It = std::lower_bound(Lengths.begin(), Lengths.end(), Length);
+        if (It == Lengths.end() || *It != Length)
+        {
+            Lengths.insert(It, Length);
+        }
+    };
+
+    // "foo*"
+    if (Pattern.endswith("*") && !hasWildcard(Pattern.drop_back()))
+    {
+        auto Prefix = Pattern.drop_back();
+        if (mPrefixMap.try_emplace(Prefix, ItemIndex).second)
+        {
+            addLength(mPrefixLengths, Prefix.size());
+        }
+        return true;
+    }
+
+    // "*foo"
+    if (Pattern.startswith("*") && !hasWildcard(Pattern.drop_front()))
+    {
+        auto Suffix = Pattern.drop_front();
+        if (mSuffixMap.try_emplace(Suffix, ItemIndex).second)
+        {
+            addLength(mSuffixLengths, Suffix.size());
+        }
+        return true;
+    }
+
+    auto GlobPat = unknown::GlobPattern::create(mSaver.save(Pattern));
+    if (!GlobPat)
+    {
+        unknown::consumeError(GlobPat.takeError());
+        return false;
+    }
+
+    mPatterns.emplace_back(std::move(*GlobPat), ItemIndex);
+    return true;
+}
+
+// Get the first item whose pattern matches the name
+std::optional<uint32_t>
+ConfigReader::FunctionPatternMatcher::match(unknown::StringRef Name) const
+{
+    std::optional<uint32_t> Result;
+    auto updateResult = [&Result](uint32_t ItemIndex) {
+        if (!Result || ItemIndex < *Result)
+        {
+            Result = ItemIndex;
+        }
+    };
+
+    for (auto Length : mPrefixLengths)
+    {
+        if (Length > Name.size())
+        {
+            break;
+        }
+        auto It = mPrefixMap.find(Name.take_front(Length));
+        if (It != mPrefixMap.end())
+        {
+            updateResult(It->second);
+        }
+    }
+
+    for (auto Length : mSuffixLengths)
+    {
+        if (Length > Name.size())
+        {
+            break;
+        }
+        auto It = mSuffixMap.find(Name.take_back(Length));
+        if (It != mSuffixMap.end())
+        {
+            updateResult(It->second);
+        }
+    }
+
+    // The patterns are in item order, so only the ones before the current result can win
+    for (const auto &Item : mPatterns)
+    {
+        if (Result && Item.second > *Result)
+        {
+            break;
+        }
+        if (Item.first.match(Name))
+        {
+            updateResult(Item.second);
+            break;
+        }
+    }
+
+    return Result;
+}
+
+// Clear all the patterns
+void
+ConfigReader::FunctionPatternMatcher::clear()
+{
+    mPrefixMap.clear();
+    mSuffixMap.clear();
+    mPrefixLengths.clear();
+    mSuffixLengths.clear();
+    mPatterns.clear();
+    mAllocator.Reset();
+}
+
 ////////////////////////////////////////////////////////////
 // Get/Set
 // Get the config file path
@@ -122,24 +273,25 @@ void
 ConfigReader::setFunctionItems(const std::vector<ConfigReader::FunctionItem> &Items)
 {
     mFunctionItems = Items;
+    buildFunctionIndex();
 }
 
-// Get the function attributes
-const std::vector<std::string>
-ConfigReader::getFunctionAttributes(const std::string &FunctionName) const
+// Get the function attributes, an exact name wins over the patterns
+unknown::ArrayRef<std::string>
+ConfigReader::getFunctionAttributes(unknown::StringRef FunctionName) const
 {
-    std::vector<std::string> Attributes;
+    auto It = mFunctionNameMap.find(FunctionName);
+    if (It != mFunctionNameMap.end())
+    {
+        return mFunctionItems[It->second].Attributes;
+    }
 
-    for (auto &Item : getFunctionItems())
+    if (auto ItemIndex = mFunctionPatternMatcher.match(FunctionName))
     {
-        if (Item.Name.compare(FunctionName) == 0)
-        {
-            Attributes = Item.Attributes;
-            break;
-        }
+        return mFunctionItems[*ItemIndex].Attributes;
     }
 
-    return Attributes;
+    return {};
 }
 
 ////////////////////////////////////////////////////////////
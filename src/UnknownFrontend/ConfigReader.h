@@ -6,6 +6,12 @@
 #include <vector>
 #include <optional>
 
+#include <UnknownUtils/unknown/ADT/ArrayRef.h>
+#include <UnknownUtils/unknown/ADT/StringMap.h>
+#include <UnknownUtils/unknown/ADT/StringRef.h>
+#include <UnknownUtils/unknown/Support/Allocator.h>
+#include <UnknownUtils/unknown/Support/GlobPattern.h>
+#include <UnknownUtils/unknown/Support/StringSaver.h>
 #include <UnknownUtils/unknown/tinyxml2/tinyxml2.h>
 
 namespace ufrontend {
@@ -15,8 +21,42 @@ class ConfigReader
 public:
     struct FunctionItem
     {
+        // The function name, or a glob pattern if IsPattern
         std::string Name;
         std::vector<std::string> Attributes;
+        bool IsPattern = false;
+    };
+
+private:
+    // Match a function name against all the glob patterns of the config at once
+    class FunctionPatternMatcher
+    {
+    private:
+        // The patterns refer to their saved strings
+        unknown::BumpPtrAllocator mAllocator;
+        unknown::StringSaver mSaver;
+
+        // "foo*" and "*foo" are looked up by hash for each distinct length, [Prefix/Suffix, ItemIndex]
+        unknown::StringMap<uint32_t> mPrefixMap;
+        unknown::StringMap<uint32_t> mSuffixMap;
+        std::vector<size_t> mPrefixLengths;
+        std::vector<size_t> mSuffixLengths;
+
+        // The other patterns are matched one by one, [Pattern, ItemIndex]
+        std::vector<std::pair<unknown::GlobPattern, uint32_t>> mPatterns;
+
+    public:
+        FunctionPatternMatcher() : mSaver(mAllocator) {}
+
+    public:
+        // Add a pattern of the item, returns false if the pattern is not valid
+        bool add(unknown::StringRef Pattern, uint32_t ItemIndex);
+
+        // Get the first item whose pattern matches the name
+        std::optional<uint32_t> match(unknown::StringRef Name) const;
+
+        // Clear all the patterns
+        void clear();
     };
 
 private:
@@ -25,6 +65,10 @@ private:
     unknown::XMLDocument mXMLDocument;
     std::vector<FunctionItem> mFunctionItems;
 
+    // [Name, ItemIndex]
+    unknown::StringMap<uint32_t> mFunctionNameMap;
+    FunctionPatternMatcher mFunctionPatternMatcher;
+
 public:
     ConfigReader(const std::string &ConfigFilePath);
     virtual ~ConfigReader();
@@ -37,6 +81,10 @@ private:
     // Parse
     void ParseFunctionInfo(unknown::XMLElement *Root);
 
+    // Index
+    // Build the index of the function items
+    void buildFunctionIndex();
+
 public:
     // Get/Set
     // Get the config file path
@@ -57,8 +105,8 @@ public:
     // Set the function items
     void setFunctionItems(const std::vector<FunctionItem> &Items);
 
-    // Get the function attributes
-    const std::vector<std::string> getFunctionAttributes(const std::string &FunctionName) const;
+    // Get the function attributes, an exact name wins over the patterns
+    unknown::ArrayRef<std::string> getFunctionAttributes(unknown::StringRef FunctionName) const;
 
 public:
     // Static
@@ -0,0 +1,273 @@
+#include "LiftCache.h"
+#include "Error.h"
+
+#include <format>
+
+#include <unknown/ADT/SmallString.h>
+#include <unknown/Support/Error.h>
+#include <unknown/Support/FileSystem.h>
+#include <unknown/Support/LEB128.h>
+#include <unknown/Support/MD5.h>
+#include <unknown/Support/MemoryBuffer.h>
+#include <unknown/Support/Path.h>
+#include <unknown/Support/raw_ostream.h>
+
+namespace ufrontend {
+
+namespace {
+
+// Bump it whenever the layout of the cache files or the output of the translators changes.
+// A cache file is the magic, the version and the body written by uir::Function::writeBinaryBody.
+constexpr uint32_t LiftCacheVersion = 2;
+
+// The hash of the frontend and UnknownIR sources set by the build, so a rebuilt translator does not read the functions
+// lifted by another build even if the version was not bumped
+#ifdef UFRONTEND_BUILD_ID
+constexpr const char *LiftCacheBuildID = UFRONTEND_BUILD_ID;
+#else
+constexpr const char *LiftCacheBuildID = "";
+#endif
+
+// The magic of the cache files
+constexpr char LiftCacheMagic[4] = {'U', 'L', 'C', 'F'};
+
+// The prefix that CachePruning looks for
+constexpr const char *LiftCacheFilePrefix = "llvmcache-";
+
+// The cache files keep the absolute addresses and leave out the annotations of the basic blocks
+constexpr uir::BinaryBodyOptions LiftCacheBodyOptions = {false, false};
+
+// Read a cache file into the function, returns false if it is not a valid cache file
+bool
+readCacheFile(unknown::StringRef Buffer, uir::Function *F)
+{
+    if (!Buffer.startswith(unknown::StringRef(LiftCacheMagic, sizeof(LiftCacheMagic))))
+    {
+        return false;
+    }
+    Buffer = Buffer.drop_front(sizeof(LiftCacheMagic));
+
+    unsigned Size = 0;
+    const char *Error = nullptr;
+    auto Version = unknown::decodeULEB128(Buffer.bytes_begin(), &Size, Buffer.bytes_end(), &Error);
+    if (Error || Version != LiftCacheVersion)
+    {
+        return false;
+    }
+
+    return F->readBinaryBody(Buffer.drop_front(Size), LiftCacheBodyOptions);
+}
+
+} // namespace
+
+LiftCache::LiftCache(const std::string &CacheDirectory, const unknown::CachePruningPolicy &PruningPolicy) :
+    mCacheDirectory(CacheDirectory), mPruningPolicy(PruningPolicy), mNumHits(0), mNumMisses(0)
+{
+    assert(!CacheDirectory.empty());
+}
+
+LiftCache::~LiftCache()
+{
+    //
+}
+
+////////////////////////////////////////////////////////////
+// Key
+// Compute the key of a function from everything its lifted body depends on
+std::string
+LiftCache::computeKey(
+    uir::Context &C,
+    uint64_t Address,
+    unknown::ArrayRef<uint8_t> Bytes,
+    const RelocationListType &Relocations,
+    const std::vector<std::string> &Attributes)
+{
+    unknown::MD5 Hasher;
+    auto updateULEB = [&Hasher](uint64_t Value) {
+        uint8_t Buffer[16];
+        auto Size = unknown::encodeULEB128(Value, Buffer);
+        Hasher.update(unknown::ArrayRef<uint8_t>(Buffer, Size));
+    };
+
+    updateULEB(LiftCacheVersion);
+    Hasher.update(LiftCacheBuildID);
+    updateULEB(static_cast<uint32_t>(C.getArch()));
+    updateULEB(static_cast<uint32_t>(C.getMode()));
+
+    // The instructions print absolute branch targets, so the address is a part of the key
+    updateULEB(Address);
+    updateULEB(Bytes.size());
+    Hasher.update(Bytes);
+
+    updateULEB(Relocations.size());
+    for (const auto &Relocation : Relocations)
+    {
+        updateULEB(Relocation.first);
+        updateULEB(Relocation.second);
+    }
+
+    updateULEB(Attributes.size());
+    for (const auto &Attr : Attributes)
+    {
+        updateULEB(Attr.size());
+        Hasher.update(Attr);
+    }
+
+    unknown::MD5::MD5Result Result;
+    Hasher.final(Result);
+    return Result.digest().str().str();
+}
+
+////////////////////////////////////////////////////////////
+// Load/Store
+// Rehydrate the basic blocks of the function from the cache, returns false on a miss
+bool
+LiftCache::load(const std::string &Key, uir::Function *F)
+{
+    assert(F);
+    assert(F->empty());
+
+    auto Path = getCacheFilePath(Key);
+    auto BufferOrErr = unknown::MemoryBuffer::getFile(Path, -1, false);
+    if (!BufferOrErr)
+    {
+        ++mNumMisses;
+        return false;
+    }
+
+    if (!readCacheFile((*BufferOrErr)->getBuffer(), F))
+    {
+        std::cerr << std::format(UFRONTEND_ERROR_PREFIX "LiftCache: {} is corrupted", Path) << std::endl;
+        unknown::sys::fs::remove(Path);
+        ++mNumMisses;
+        return false;
+    }
+
+    ++mNumHits;
+    return true;
+}
+
+// Save the basic blocks of the function into the cache
+bool
+LiftCache::store(const std::string &Key, const uir::Function *F)
+{
+    assert(F);
+
+    unknown::SmallString<0> Buffer;
+    unknown::raw_svector_ostream OS(Buffer);
+    OS.write(LiftCacheMagic, sizeof(LiftCacheMagic));
+    unknown::encodeULEB128(LiftCacheVersion, OS);
+    if (!F->writeBinaryBody(OS, LiftCacheBodyOptions))
+    {
+        return false;
+    }
+
+    // Write a unique file and rename it, so that no one reads a partial file
+    unknown::SmallString<128> TempModel(mCacheDirectory);
+    unknown::sys::path::append(TempModel, std::string(LiftCacheFilePrefix) + "tmp-%%%%%%%%");
+
+    int FD = -1;
+    unknown::SmallString<128> TempPath;
+    if (unknown::sys::fs::createUniqueFile(TempModel, FD, TempPath))
+    {
+        return false;
+    }
+
+    {
+        unknown::raw_fd_ostream TempOS(FD, /*shouldClose=*/true);
+        TempOS << Buffer;
+        TempOS.close();
+        if (TempOS.has_error())
+        {
+            TempOS.clear_error();
+            unknown::sys::fs::remove(TempPath);
+            return false;
+        }
+    }
+
+    if (unknown::sys::fs::rename(TempPath, getCacheFilePath(Key)))
+    {
+        unknown::sys::fs::remove(TempPath);
+        return false;
+    }
+
+    return true;
+}
+
+// Prune the cache directory with the pruning policy
+bool
+LiftCache::prune()
+{
+    return unknown::pruneCache(mCacheDirectory, mPruningPolicy);
+}
+
+////////////////////////////////////////////////////////////
+// Get/Set
+// Get the cache directory
+const std::string &
+LiftCache::getCacheDirectory() const
+{
+    return mCacheDirectory;
+}
+
+// Get the number of functions rehydrated from the cache
+const uint64_t
+LiftCache::getNumHits() const
+{
+    return mNumHits;
+}
+
+// Get the number of functions that were not found in the cache
+const uint64_t
+LiftCache::getNumMisses() const
+{
+    return mNumMisses;
+}
+
+// Get the path of the cache file of the key
+std::string
+LiftCache::getCacheFilePath(const std::string &Key) const
+{
+    unknown::SmallString<128> Path(mCacheDirectory);
+    unknown::sys::path::append(Path, LiftCacheFilePrefix + Key);
+    return Path.str().str();
+}
+
+////////////////////////////////////////////////////////////
+// Static
+// Create a lift cache, PruningPolicy uses the syntax of unknown::parseCachePruningPolicy
+std::unique_ptr<LiftCache>
+LiftCache::get(const std::string &CacheDirectory, const std::string &PruningPolicy)
+{
+    if (CacheDirectory.empty())
+    {
+        return nullptr;
+    }
+
+    unknown::CachePruningPolicy Policy;
+    if (!PruningPolicy.empty())
+    {
+        auto PolicyOrErr = unknown::parseCachePruningPolicy(PruningPolicy);
+        if (!PolicyOrErr)
+        {
+            std::cerr << std::format(
+                             UFRONTEND_ERROR_PREFIX "LiftCache: invalid pruning policy: {}",
+                             unknown::toString(PolicyOrErr.takeError()))
+                      << std::endl;
+            return nullptr;
+        }
+        Policy = *PolicyOrErr;
+    }
+
+    if (auto EC = unknown::sys::fs::create_directories(CacheDirectory))
+    {
+        std::cerr << std::format(
+                         UFRONTEND_ERROR_PREFIX "LiftCache: create {} failed: {}", CacheDirectory, EC.message())
+                  << std::endl;
+        return nullptr;
+    }
+
+    return std::make_unique<LiftCache>(CacheDirectory, Policy);
+}
+
+} // namespace ufrontend
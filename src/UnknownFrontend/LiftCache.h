@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <UnknownUtils/unknown/ADT/ArrayRef.h>
+#include <UnknownUtils/unknown/Support/CachePruning.h>
+
+#include <UnknownIR/UnknownIR.h>
+
+namespace ufrontend {
+
+// A persistent cache of lifted functions, one file per function in the cache directory
+class LiftCache
+{
+public:
+    // [RVA, Type]
+    using RelocationListType = std::vector<std::pair<uint64_t, uint32_t>>;
+
+private:
+    std::string mCacheDirectory;
+    unknown::CachePruningPolicy mPruningPolicy;
+    std::atomic<uint64_t> mNumHits;
+    std::atomic<uint64_t> mNumMisses;
+
+public:
+    LiftCache(const std::string &CacheDirectory, const unknown::CachePruningPolicy &PruningPolicy);
+    virtual ~LiftCache();
+
+public:
+    // Key
+    // Compute the key of a function from everything its lifted body depends on
+    static std::string computeKey(
+        uir::Context &C,
+        uint64_t Address,
+        unknown::ArrayRef<uint8_t> Bytes,
+        const RelocationListType &Relocations,
+        const std::vector<std::string> &Attributes);
+
+public:
+    // Load/Store
+    // Rehydrate the basic blocks of the function from the cache, returns false on a miss
+    bool load(const std::string &Key, uir::Function *F);
+
+    // Save the basic blocks of the function into the cache
+    bool store(const std::string &Key, const uir::Function *F);
+
+    // Prune the cache directory with the pruning policy
+    bool prune();
+
+public:
+    // Get/Set
+    // Get the cache directory
+    const std::string &getCacheDirectory() const;
+
+    // Get the number of functions rehydrated from the cache
+    const uint64_t getNumHits() const;
+
+    // Get the number of functions that were not found in the cache
+    const uint64_t getNumMisses() const;
+
+private:
+    // Get the path of the cache file of the key
+    std::string getCacheFilePath(const std::string &Key) const;
+
+public:
+    // Static
+    // Create a lift cache, PruningPolicy uses the syntax of unknown::parseCachePruningPolicy
+    static std::unique_ptr<LiftCache> get(const std::string &CacheDirectory, const std::string &PruningPolicy = "");
+};
+
+} // namespace ufrontend
@@ -1,6 +1,12 @@
 #include "TranslatorImpl.h"
 #include "Error.h"
 
+#include <algorithm>
+#include <format>
+
+#include <unknown/Support/FileSystem.h>
+#include <unknown/Support/JSON.h>
+
 namespace ufrontend {
 
 UnknownFrontendTranslatorImpl::UnknownFrontendTranslatorImpl(
@@ -16,10 +22,26 @@ UnknownFrontendTranslatorImpl::UnknownFrontendTranslatorImpl(
     mSymbolFile(SymbolFile),
     mConfigFile(ConfigFile),
     mEnableAnalyzeAllFunctions(AnalyzeAllFunctions),
+    mEnableLazyDecodeDetail(true),
     mCapstoneHandle(0),
     mCurPtrBegin(0),
     mCurPtrEnd(0),
-    mCurFunction(nullptr)
+    mCurFunction(nullptr),
+    mNumDecodedInstructions(0),
+    mNumDetailDecodedInstructions(0),
+    mNumDecodeCacheHits(0),
+    mNumTranslatedFunctions(0),
+    mNumTranslatedBasicBlocks(0),
+    mNumUnknownInstructions(0),
+    mNumCopiedBytes(0),
+    mEnableStatistics(false),
+    mDecodeNanoseconds(0),
+    mTimerGroup("ufrontend", "UnknownFrontend phases"),
+    mParseConfigTimer("parse-config", "Config parse", mTimerGroup),
+    mParseSymbolTimer("parse-symbol", "PDB/MAP symbol parse", mTimerGroup),
+    mParseBinaryTimer("parse-binary", "Binary parse", mTimerGroup),
+    mTranslateTimer("translate", "Translate", mTimerGroup),
+    mPrintTimer("print", "Module print", mTimerGroup)
 {
     switch (C.getArch())
     {
@@ -40,26 +62,10 @@ UnknownFrontendTranslatorImpl::~UnknownFrontendTranslatorImpl()
     closeCapstoneHandle();
 
     // Clear mVirtualRegisterInfoMap
-    for (auto &Item : mVirtualRegisterInfoMap)
-    {
-        auto &VParentRegInfo = Item.second;
-
-        for (auto &VRegInfoItem : VParentRegInfo)
-        {
-            auto &VRegInfo = VRegInfoItem.second;
-            if (VRegInfo.RegPtr != nullptr && VRegInfo.RegPtr->user_empty())
-            {
-                delete VRegInfo.RegPtr;
-                VRegInfo.RegPtr = nullptr;
-            }
+    resetVirtualRegisterInfo();
 
-            if (VRegInfo.SavedRegVal != nullptr && VRegInfo.SavedRegVal->user_empty())
-            {
-                delete VRegInfo.SavedRegVal;
-                VRegInfo.SavedRegVal = nullptr;
-            }
-        }
-    }
+    // The timers are reported by printStatistics, not when they are destroyed
+    mTimerGroup.clear();
 }
 
 ////////////////////////////////////////////////////////////
@@ -86,6 +92,8 @@ UnknownFrontendTranslatorImpl::initConfig()
         return;
     }
 
+    unknown::TimeRegion Region(mParseConfigTimer);
+
     mConfigReader = ConfigReader::get(mConfigFile);
     assert(mConfigReader);
 
@@ -96,6 +104,47 @@ UnknownFrontendTranslatorImpl::initConfig()
     }
 }
 
+////////////////////////////////////////////////////////////
+// Print
+// Print the module on NumThreads threads, the time is reported as the print phase of the statistics
+void
+UnknownFrontendTranslatorImpl::printModule(const uir::Module &M, unknown::raw_ostream &OS, uint32_t NumThreads)
+{
+    unknown::TimeRegion Region(mPrintTimer);
+    M.printParallel(OS, NumThreads);
+}
+
+////////////////////////////////////////////////////////////
+// Cache
+// Enable the on-disk cache of lifted functions
+bool
+UnknownFrontendTranslatorImpl::enableLiftCache(const std::string &CacheDirectory, const std::string &PruningPolicy)
+{
+    mLiftCache = LiftCache::get(CacheDirectory, PruningPolicy);
+    return mLiftCache != nullptr;
+}
+
+// Enable the on-disk cache of the parsed function symbols
+bool
+UnknownFrontendTranslatorImpl::enableSymbolCache(const std::string &CacheDirectory)
+{
+    if (CacheDirectory.empty())
+    {
+        return false;
+    }
+
+    if (auto EC = unknown::sys::fs::create_directories(CacheDirectory))
+    {
+        std::cerr << std::format(
+                         UFRONTEND_ERROR_PREFIX "SymbolCache: create {} failed: {}", CacheDirectory, EC.message())
+                  << std::endl;
+        return false;
+    }
+
+    mSymbolCacheDirectory = CacheDirectory;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////
 // Get/Set
 // Get the context of this translator
@@ -210,6 +259,251 @@ UnknownFrontendTranslatorImpl::setEnableAnalyzeAllFunctions(bool Set)
     mEnableAnalyzeAllFunctions = Set;
 }
 
+// Get EnableLazyDecodeDetail
+const bool
+UnknownFrontendTranslatorImpl::getEnableLazyDecodeDetail() const
+{
+    return mEnableLazyDecodeDetail;
+}
+
+// Set EnableLazyDecodeDetail
+void
+UnknownFrontendTranslatorImpl::setEnableLazyDecodeDetail(bool Set)
+{
+    mEnableLazyDecodeDetail = Set;
+}
+
+////////////////////////////////////////////////////////////
+// Statistics
+// Get the number of instructions decoded by the disassembler
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumDecodedInstructions() const
+{
+    return mNumDecodedInstructions;
+}
+
+// Get the number of instructions decoded with operand detail
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumDetailDecodedInstructions() const
+{
+    return mNumDetailDecodedInstructions;
+}
+
+// Get the number of instructions served from the decoded-instruction cache
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumDecodeCacheHits() const
+{
+    return mNumDecodeCacheHits;
+}
+
+// Get the number of functions rehydrated from the lift cache
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumLiftCacheHits() const
+{
+    return mLiftCache ? mLiftCache->getNumHits() : 0;
+}
+
+// Get the number of functions that were not found in the lift cache
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumLiftCacheMisses() const
+{
+    return mLiftCache ? mLiftCache->getNumMisses() : 0;
+}
+
+// Get the number of functions translated
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumTranslatedFunctions() const
+{
+    return mNumTranslatedFunctions;
+}
+
+// Get the number of basic blocks created
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumTranslatedBasicBlocks() const
+{
+    return mNumTranslatedBasicBlocks;
+}
+
+// Get the number of instructions that fell back to the unknown instruction
+const uint64_t
+UnknownFrontendTranslatorImpl::getNumUnknownInstructions() const
+{
+    return mNumUnknownInstructions;
+}
+
+// Get EnableStatistics
+const bool
+UnknownFrontendTranslatorImpl::getEnableStatistics() const
+{
+    return mEnableStatistics;
+}
+
+// Set EnableStatistics
+void
+UnknownFrontendTranslatorImpl::setEnableStatistics(bool Set)
+{
+    mEnableStatistics = Set;
+}
+
+// Print the phase timers and the counters
+void
+UnknownFrontendTranslatorImpl::printStatistics(unknown::raw_ostream &OS)
+{
+    mTimerGroup.print(OS);
+
+    OS << "===" << std::string(73, '-') << "===\n";
+    OS << "                          UnknownFrontend counters\n";
+    OS << "===" << std::string(73, '-') << "===\n";
+
+    auto printCounter = [&OS](uint64_t Value, unknown::StringRef Description) {
+        OS << std::format("{:>14}  {}\n", Value, Description.str());
+    };
+    printCounter(getNumTranslatedFunctions(), "functions translated");
+    printCounter(getNumTranslatedBasicBlocks(), "basic blocks created");
+    printCounter(getNumDecodedInstructions(), "instructions decoded");
+    printCounter(getNumDetailDecodedInstructions(), "instructions decoded with detail");
+    printCounter(getNumDecodeCacheHits(), "decode cache hits");
+    printCounter(getNumUnknownInstructions(), "unknown instruction fallbacks");
+    printCounter(mNumCopiedBytes, "bytes copied into the decode cache");
+    printCounter(getNumLiftCacheHits(), "lift cache hits");
+    printCounter(getNumLiftCacheMisses(), "lift cache misses");
+    if (mEnableStatistics)
+    {
+        OS << std::format("{:>14.3f}  seconds decoding\n", mDecodeNanoseconds / 1e9);
+    }
+
+    // The opcodes by translation count
+    std::vector<uint32_t> InsnIDs;
+    for (uint32_t InsnID = 0; InsnID < mNumTranslatedInstructionsByID.size(); ++InsnID)
+    {
+        if (mNumTranslatedInstructionsByID[InsnID])
+        {
+            InsnIDs.push_back(InsnID);
+        }
+    }
+    std::stable_sort(InsnIDs.begin(), InsnIDs.end(), [this](uint32_t LHS, uint32_t RHS) {
+        return mNumTranslatedInstructionsByID[LHS] > mNumTranslatedInstructionsByID[RHS];
+    });
+
+    OS << "\n";
+    for (auto InsnID : InsnIDs)
+    {
+        OS << std::format("{:>14}  {}", mNumTranslatedInstructionsByID[InsnID], getInstructionName(InsnID));
+        if (mEnableStatistics && InsnID < mTranslateNanosecondsByID.size())
+        {
+            OS << std::format(" ({:.3f} seconds)", mTranslateNanosecondsByID[InsnID] / 1e9);
+        }
+        OS << "\n";
+    }
+    OS << "\n";
+    OS.flush();
+}
+
+// Print the phase timers and the counters as a JSON document
+void
+UnknownFrontendTranslatorImpl::printStatisticsJSON(unknown::raw_ostream &OS)
+{
+    unknown::json::Object Phases;
+    for (auto Timer : {&mParseConfigTimer, &mParseSymbolTimer, &mParseBinaryTimer, &mTranslateTimer, &mPrintTimer})
+    {
+        auto Time = Timer->getTotalTime();
+        Phases[Timer->getName()] = unknown::json::Object{
+            {"wall", Time.getWallTime()},
+            {"user", Time.getUserTime()},
+            {"sys", Time.getSystemTime()},
+        };
+    }
+
+    unknown::json::Object Counters{
+        {"functions", static_cast<int64_t>(getNumTranslatedFunctions())},
+        {"blocks", static_cast<int64_t>(getNumTranslatedBasicBlocks())},
+        {"decoded-instructions", static_cast<int64_t>(getNumDecodedInstructions())},
+        {"detail-decoded-instructions", static_cast<int64_t>(getNumDetailDecodedInstructions())},
+        {"decode-cache-hits", static_cast<int64_t>(getNumDecodeCacheHits())},
+        {"unknown-instructions", static_cast<int64_t>(getNumUnknownInstructions())},
+        {"copied-bytes", static_cast<int64_t>(mNumCopiedBytes)},
+        {"lift-cache-hits", static_cast<int64_t>(getNumLiftCacheHits())},
+        {"lift-cache-misses", static_cast<int64_t>(getNumLiftCacheMisses())},
+    };
+    if (mEnableStatistics)
+    {
+        Counters["decode-seconds"] = mDecodeNanoseconds / 1e9;
+    }
+
+    unknown::json::Object Opcodes;
+    for (uint32_t InsnID = 0; InsnID < mNumTranslatedInstructionsByID.size(); ++InsnID)
+    {
+        if (mNumTranslatedInstructionsByID[InsnID] == 0)
+        {
+            continue;
+        }
+
+        unknown::json::Object Opcode{{"count", static_cast<int64_t>(mNumTranslatedInstructionsByID[InsnID])}};
+        if (mEnableStatistics && InsnID < mTranslateNanosecondsByID.size())
+        {
+            Opcode["seconds"] = mTranslateNanosecondsByID[InsnID] / 1e9;
+        }
+        Opcodes[getInstructionName(InsnID)] = std::move(Opcode);
+    }
+
+    unknown::json::Object Root{
+        {"phases", std::move(Phases)},
+        {"counters", std::move(Counters)},
+        {"opcodes", std::move(Opcodes)},
+    };
+    OS << unknown::json::Value(std::move(Root)) << "\n";
+    OS.flush();
+}
+
+////////////////////////////////////////////////////////////
+// Statistics
+// Count the translation of an instruction, Nanoseconds is only used if mEnableStatistics
+void
+UnknownFrontendTranslatorImpl::countTranslatedInstruction(uint32_t InsnID, uint64_t Nanoseconds)
+{
+    if (InsnID >= mNumTranslatedInstructionsByID.size())
+    {
+        mNumTranslatedInstructionsByID.resize(InsnID + 1, 0);
+    }
+    ++mNumTranslatedInstructionsByID[InsnID];
+
+    if (mEnableStatistics)
+    {
+        if (InsnID >= mTranslateNanosecondsByID.size())
+        {
+            mTranslateNanosecondsByID.resize(InsnID + 1, 0);
+        }
+        mTranslateNanosecondsByID[InsnID] += Nanoseconds;
+    }
+}
+
+// Add the counters of a worker translator to this translator
+void
+UnknownFrontendTranslatorImpl::mergeStatistics(const UnknownFrontendTranslatorImpl &Worker)
+{
+    mNumDecodedInstructions += Worker.mNumDecodedInstructions;
+    mNumDetailDecodedInstructions += Worker.mNumDetailDecodedInstructions;
+    mNumDecodeCacheHits += Worker.mNumDecodeCacheHits;
+    mNumTranslatedFunctions += Worker.mNumTranslatedFunctions;
+    mNumTranslatedBasicBlocks += Worker.mNumTranslatedBasicBlocks;
+    mNumUnknownInstructions += Worker.mNumUnknownInstructions;
+    mNumCopiedBytes += Worker.mNumCopiedBytes;
+    mDecodeNanoseconds += Worker.mDecodeNanoseconds;
+
+    auto mergeByID = [](std::vector<uint64_t> &To, const std::vector<uint64_t> &From) {
+        if (To.size() < From.size())
+        {
+            To.resize(From.size(), 0);
+        }
+        for (size_t Index = 0; Index < From.size(); ++Index)
+        {
+            To[Index] += From[Index];
+        }
+    };
+    mergeByID(mNumTranslatedInstructionsByID, Worker.mNumTranslatedInstructionsByID);
+    mergeByID(mTranslateNanosecondsByID, Worker.mTranslateNanosecondsByID);
+}
+
 ////////////////////////////////////////////////////////////
 // Register
 // Get the register name with index by register id
@@ -305,4 +599,28 @@ UnknownFrontendTranslatorImpl::getVirtualRegisterInfo(uint32_t RegID)
     return &mVirtualRegisterInfoMap[ParentRegID];
 }
 
+// Reset the virtual register information before translating a new function
+void
+UnknownFrontendTranslatorImpl::resetVirtualRegisterInfo()
+{
+    for (auto &Item : mVirtualRegisterInfoMap)
+    {
+        auto &VParentRegInfo = Item.second;
+
+        for (auto &VRegInfoItem : VParentRegInfo)
+        {
+            // The saved register values are owned by their basic blocks, only the register pointers are ours
+            auto &VRegInfo = VRegInfoItem.second;
+            if (VRegInfo.RegPtr != nullptr && VRegInfo.RegPtr->user_empty())
+            {
+                delete VRegInfo.RegPtr;
+                VRegInfo.RegPtr = nullptr;
+            }
+        }
+    }
+
+    mVirtualRegisterInfoMap.clear();
+    mRegisterCounterMap.clear();
+}
+
 } // namespace ufrontend
@@ -1,11 +1,13 @@
 #pragma once
 #include <capstone/capstone.h>
 
+#include <UnknownUtils/unknown/Support/Timer.h>
 #include <UnknownUtils/unknown/Target/Target.h>
 
 #include <UnknownFrontend/UnknownFrontend.h>
 
 #include "ConfigReader.h"
+#include "LiftCache.h"
 
 namespace ufrontend {
 
@@ -35,6 +37,7 @@ protected:
     std::string mSymbolFile;
     std::string mConfigFile;
     bool mEnableAnalyzeAllFunctions;
+    bool mEnableLazyDecodeDetail;
 
 protected:
     csh mCapstoneHandle;
@@ -46,9 +49,41 @@ protected:
 protected:
     uir::Function *mCurFunction;
 
+protected:
+    uint64_t mNumDecodedInstructions;
+    uint64_t mNumDetailDecodedInstructions;
+    uint64_t mNumDecodeCacheHits;
+    uint64_t mNumTranslatedFunctions;
+    uint64_t mNumTranslatedBasicBlocks;
+    uint64_t mNumUnknownInstructions;
+    uint64_t mNumCopiedBytes;
+
+    // Only collected if mEnableStatistics
+    bool mEnableStatistics;
+    uint64_t mDecodeNanoseconds;
+
+    // [InsnID, Count]
+    std::vector<uint64_t> mNumTranslatedInstructionsByID;
+
+    // [InsnID, Nanoseconds], only collected if mEnableStatistics
+    std::vector<uint64_t> mTranslateNanosecondsByID;
+
+protected:
+    // The timers of the phases, only the translator that runs a phase starts its timer
+    unknown::TimerGroup mTimerGroup;
+    unknown::Timer mParseConfigTimer;
+    unknown::Timer mParseSymbolTimer;
+    unknown::Timer mParseBinaryTimer;
+    unknown::Timer mTranslateTimer;
+    unknown::Timer mPrintTimer;
+
 protected:
     std::unique_ptr<unknown::Target> mTarget;
-    std::unique_ptr<ufrontend::ConfigReader> mConfigReader;
+    std::shared_ptr<ufrontend::ConfigReader> mConfigReader;
+    std::shared_ptr<ufrontend::LiftCache> mLiftCache;
+
+    // The function symbols are cached in this directory, empty if the symbol cache is disabled
+    std::string mSymbolCacheDirectory;
 
 public:
     UnknownFrontendTranslatorImpl(
@@ -91,6 +126,16 @@ public:
     // Translate
     // Translate the given binary into UnknownIR
     virtual std::unique_ptr<uir::Module> translateBinary(const std::string &ModuleName) override { return {}; }
+    virtual std::unique_ptr<uir::Module>
+    translateBinary(const std::string &ModuleName, uint32_t NumThreads) override
+    {
+        return {};
+    }
+    virtual std::unique_ptr<uir::Module>
+    translateBinary(const std::string &ModuleName, const FunctionSinkType &Sink, uint32_t NumThreads = 1) override
+    {
+        return {};
+    }
 
     // Translate one instruction into UnknownIR
     virtual bool
@@ -118,6 +163,20 @@ public:
         return false;
     }
 
+public:
+    // Print
+    // Print the module on NumThreads threads, 0 means all hardware threads.
+    // The time is reported as the print phase of the statistics.
+    virtual void printModule(const uir::Module &M, unknown::raw_ostream &OS, uint32_t NumThreads = 1) override;
+
+public:
+    // Cache
+    // Enable the on-disk cache of lifted functions
+    virtual bool enableLiftCache(const std::string &CacheDirectory, const std::string &PruningPolicy = "") override;
+
+    // Enable the on-disk cache of the parsed function symbols
+    virtual bool enableSymbolCache(const std::string &CacheDirectory) override;
+
 public:
     // Get/Set
     // Get the capstone handle
@@ -168,6 +227,61 @@ public:
     // Set EnableAnalyzeAllFunctions
     virtual void setEnableAnalyzeAllFunctions(bool Set) override;
 
+    // Get EnableLazyDecodeDetail
+    virtual const bool getEnableLazyDecodeDetail() const override;
+
+    // Set EnableLazyDecodeDetail
+    virtual void setEnableLazyDecodeDetail(bool Set) override;
+
+public:
+    // Statistics
+    // Get the number of instructions decoded by the disassembler
+    virtual const uint64_t getNumDecodedInstructions() const override;
+
+    // Get the number of instructions decoded with operand detail
+    virtual const uint64_t getNumDetailDecodedInstructions() const override;
+
+    // Get the number of instructions served from the decoded-instruction cache
+    virtual const uint64_t getNumDecodeCacheHits() const override;
+
+    // Get the number of functions rehydrated from the lift cache
+    virtual const uint64_t getNumLiftCacheHits() const override;
+
+    // Get the number of functions that were not found in the lift cache
+    virtual const uint64_t getNumLiftCacheMisses() const override;
+
+    // Get the number of functions translated
+    virtual const uint64_t getNumTranslatedFunctions() const override;
+
+    // Get the number of basic blocks created
+    virtual const uint64_t getNumTranslatedBasicBlocks() const override;
+
+    // Get the number of instructions that fell back to the unknown instruction
+    virtual const uint64_t getNumUnknownInstructions() const override;
+
+    // Get EnableStatistics
+    virtual const bool getEnableStatistics() const override;
+
+    // Set EnableStatistics
+    virtual void setEnableStatistics(bool Set) override;
+
+    // Print the phase timers and the counters
+    virtual void printStatistics(unknown::raw_ostream &OS) override;
+
+    // Print the phase timers and the counters as a JSON document
+    virtual void printStatisticsJSON(unknown::raw_ostream &OS) override;
+
+protected:
+    // Statistics
+    // Count the translation of an instruction, Nanoseconds is only used if mEnableStatistics
+    void countTranslatedInstruction(uint32_t InsnID, uint64_t Nanoseconds);
+
+    // Add the counters of a worker translator to this translator
+    void mergeStatistics(const UnknownFrontendTranslatorImpl &Worker);
+
+    // Get the name of an instruction id for the statistics
+    virtual std::string getInstructionName(uint32_t InsnID) const { return std::to_string(InsnID); }
+
 protected:
     // Register
     // Get the register name by register id
@@ -191,6 +305,9 @@ protected:
     // Get the virtual register information by register id
     virtual std::optional<std::unordered_map<uint32_t, VirtualRegisterInfo> *> getVirtualRegisterInfo(uint32_t RegID);
 
+    // Reset the virtual register information before translating a new function
+    virtual void resetVirtualRegisterInfo();
+
     // Get the register id by register name
     virtual uint32_t getRegisterID(const std::string &RegName) const = 0;
 
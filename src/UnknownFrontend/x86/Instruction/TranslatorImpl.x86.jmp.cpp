@@ -0,0 +1,28 @@
+#include <x86/TranslatorImpl.x86.h>
+
+#include <unknown/ADT/ScopeExit.h>
+
+namespace ufrontend {
+
+// Jmp
+bool
+UnknownFrontendTranslatorImplX86::translateJmpInstruction(const cs_insn *Insn, uir::BasicBlock *BB)
+{
+    if (Insn->id != X86_INS_JMP)
+    {
+        return false;
+    }
+
+    auto &X86Info = Insn->detail->x86;
+    if (X86Info.op_count == 1 && X86Info.operands[0].type == X86_OP_IMM)
+    {
+        // jmp imm
+        // The edge is built with the CFG of the function
+        return true;
+    }
+
+    // jmp reg/mem
+    return translateUnknownX86Instruction(Insn, BB);
+}
+
+} // namespace ufrontend
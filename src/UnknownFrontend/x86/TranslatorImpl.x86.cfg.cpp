@@ -0,0 +1,298 @@
+#include "TranslatorImpl.x86.h"
+#include "Error.h"
+
+namespace ufrontend {
+
+////////////////////////////////////////////////////////////
+// CFG
+// Clear the CFG of the current function
+void
+UnknownFrontendTranslatorImplX86::clearCFG()
+{
+    mBasicBlockMap.clear();
+    mBlockExitInfoMap.clear();
+    mInstructionPositionMap.clear();
+    mBlockIntervalMap.clear();
+}
+
+// Get the basic block that starts at the address, translating or splitting as needed
+uir::BasicBlock *
+UnknownFrontendTranslatorImplX86::getOrCreateBasicBlock(
+    uint64_t Address,
+    uint64_t MaxAddress,
+    std::vector<uint64_t> &Worklist)
+{
+    // Already a block leader
+    auto ItBB = mBasicBlockMap.find(Address);
+    if (ItBB != mBasicBlockMap.end())
+    {
+        return ItBB->second;
+    }
+
+    // The address lands inside a decoded block, split it instead of decoding the bytes again
+    if (auto BB = mBlockIntervalMap.lookup(Address, nullptr))
+    {
+        return splitBasicBlock(BB, Address);
+    }
+
+    // Translate a new basic block
+    setCurPtrBegin(Address);
+    setCurPtrEnd(MaxAddress);
+    auto BB = translateOneBasicBlock("", Address, MaxAddress);
+    if (BB == nullptr)
+    {
+        return nullptr;
+    }
+
+    mBasicBlockMap[Address] = BB;
+    mBlockIntervalMap.insert(Address, BB->getBasicBlockAddressEnd() - 1, BB);
+
+    // Queue the successors
+    const auto &Info = mBlockExitInfoMap[BB];
+    if (Info.Kind == BlockExitInfo::ExitKind::FallThrough || Info.Kind == BlockExitInfo::ExitKind::Jcc)
+    {
+        Worklist.push_back(Info.NextAddress);
+    }
+    if (Info.Kind == BlockExitInfo::ExitKind::Jmp || Info.Kind == BlockExitInfo::ExitKind::Jcc)
+    {
+        Worklist.push_back(Info.TargetAddress);
+    }
+
+    return BB;
+}
+
+// Split the basic block at the address of one of its instructions
+uir::BasicBlock *
+UnknownFrontendTranslatorImplX86::splitBasicBlock(uir::BasicBlock *BB, uint64_t Address)
+{
+    assert(BB);
+    assert(Address > BB->getBasicBlockAddressBegin() && Address < BB->getBasicBlockAddressEnd());
+
+    auto ItPos = mInstructionPositionMap.find(Address);
+    if (ItPos == mInstructionPositionMap.end())
+    {
+        std::cerr << std::format(
+                         UFRONTEND_ERROR_PREFIX "splitBasicBlock: 0x{:X} is not an instruction boundary", Address)
+                  << std::endl;
+        return nullptr;
+    }
+
+    auto NewBB = uir::BasicBlock::get(getContext(), "", Address, BB->getBasicBlockAddressEnd());
+    assert(NewBB);
+    ++mNumTranslatedBasicBlocks;
+
+    // Move the tail of the instruction list into the new block
+    const auto &Pos = ItPos->second;
+    auto SplitIt = BB->begin();
+    if (Pos.HasPrev && (*Pos.PrevIt)->getParent() == BB)
+    {
+        SplitIt = std::next(Pos.PrevIt);
+    }
+    NewBB->splice(NewBB->end(), BB, SplitIt, BB->end());
+    BB->setBasicBlockAddressEnd(Address);
+
+    // The new block leaves the way the old one did, and the old one falls through into it
+    mBlockExitInfoMap[NewBB] = mBlockExitInfoMap[BB];
+
+    BlockExitInfo FallThroughInfo;
+    FallThroughInfo.Kind = BlockExitInfo::ExitKind::FallThrough;
+    FallThroughInfo.NextAddress = Address;
+    mBlockExitInfoMap[BB] = FallThroughInfo;
+
+    // Update the decoded ranges
+    auto ItInterval = mBlockIntervalMap.find(Address);
+    assert(ItInterval.valid() && ItInterval.value() == BB);
+    ItInterval.setStop(Address - 1);
+    mBlockIntervalMap.insert(Address, NewBB->getBasicBlockAddressEnd() - 1, NewBB);
+
+    mBasicBlockMap[Address] = NewBB;
+
+    return NewBB;
+}
+
+// Record how the basic block is left by its last instruction
+void
+UnknownFrontendTranslatorImplX86::updateBlockExitInfo(uir::BasicBlock *BB, const cs_insn *Insn, bool IsTerminatorInsn)
+{
+    assert(BB);
+    assert(Insn);
+
+    BlockExitInfo Info;
+    Info.BranchAddress = Insn->address;
+    Info.NextAddress = Insn->address + Insn->size;
+
+    if (!IsTerminatorInsn)
+    {
+        Info.Kind = BlockExitInfo::ExitKind::FallThrough;
+    }
+    else if (auto TranslateFunction = getInstructionInfo(Insn->id).TranslateFunction;
+             TranslateFunction == &UnknownFrontendTranslatorImplX86::translateJmpInstruction ||
+             TranslateFunction == &UnknownFrontendTranslatorImplX86::translateJccInstruction)
+    {
+        // Only direct branches have edges
+        auto &X86Info = Insn->detail->x86;
+        if (X86Info.op_count == 1 && X86Info.operands[0].type == X86_OP_IMM)
+        {
+            Info.Kind = Insn->id == X86_INS_JMP ? BlockExitInfo::ExitKind::Jmp : BlockExitInfo::ExitKind::Jcc;
+            Info.TargetAddress = static_cast<uint64_t>(X86Info.operands[0].imm.imm);
+            Info.Condition = getJccCondition(Insn->id);
+        }
+    }
+
+    mBlockExitInfoMap[BB] = Info;
+}
+
+// Get the condition tested by a Jcc instruction
+uir::FlagsVariable::ConditionKind
+UnknownFrontendTranslatorImplX86::getJccCondition(uint32_t InsnID)
+{
+    using ConditionKind = uir::FlagsVariable::ConditionKind;
+
+    switch (InsnID)
+    {
+    case X86_INS_JA:
+        return ConditionKind::Above;
+    case X86_INS_JAE:
+        return ConditionKind::AboveOrEqual;
+    case X86_INS_JB:
+        return ConditionKind::Below;
+    case X86_INS_JBE:
+        return ConditionKind::BelowOrEqual;
+    case X86_INS_JE:
+        return ConditionKind::Equal;
+    case X86_INS_JNE:
+        return ConditionKind::NotEqual;
+    case X86_INS_JG:
+        return ConditionKind::Greater;
+    case X86_INS_JGE:
+        return ConditionKind::GreaterOrEqual;
+    case X86_INS_JL:
+        return ConditionKind::Less;
+    case X86_INS_JLE:
+        return ConditionKind::LessOrEqual;
+    case X86_INS_JO:
+        return ConditionKind::Overflow;
+    case X86_INS_JNO:
+        return ConditionKind::NotOverflow;
+    case X86_INS_JP:
+        return ConditionKind::Parity;
+    case X86_INS_JNP:
+        return ConditionKind::NotParity;
+    case X86_INS_JS:
+        return ConditionKind::Sign;
+    case X86_INS_JNS:
+        return ConditionKind::NotSign;
+    default:
+        return ConditionKind::None;
+    }
+}
+
+// Insert the basic blocks into the function and connect them
+void
+UnknownFrontendTranslatorImplX86::finalizeCFG(uir::Function *F)
+{
+    assert(F);
+
+    auto getBasicBlock = [this](uint64_t Address) -> uir::BasicBlock * {
+        auto It = mBasicBlockMap.find(Address);
+        return It != mBasicBlockMap.end() ? It->second : nullptr;
+    };
+
+    auto getAddressConstant = [this](uint64_t Address) {
+        auto Bits = getContext().getModeBits();
+        return uir::ConstantInt::get(uir::Type::getIntNTy(getContext(), Bits), unknown::APInt(Bits, Address));
+    };
+
+    // A block that only leaves the function, so that a branch with one internal successor keeps its edge
+    auto createExitBasicBlock = [this, F, &getAddressConstant](uint64_t Address, uint64_t BranchAddress) {
+        auto ExitBB = uir::BasicBlock::get(getContext(), "", Address, Address);
+        assert(ExitBB);
+        F->insertBasicBlock(ExitBB);
+
+        uir::IRBuilder IRB(ExitBB);
+        IRB.createJmpAddr(getAddressConstant(Address), BranchAddress);
+        return ExitBB;
+    };
+
+    // Insert the basic blocks in address order
+    for (auto &Item : mBasicBlockMap)
+    {
+        F->insertBasicBlock(Item.second);
+    }
+
+    // Build the terminators and the predecessors
+    for (auto &Item : mBasicBlockMap)
+    {
+        auto BB = Item.second;
+        const auto &Info = mBlockExitInfoMap[BB];
+
+        uir::IRBuilder IRB(BB);
+        switch (Info.Kind)
+        {
+        case BlockExitInfo::ExitKind::FallThrough: {
+            if (auto NextBB = getBasicBlock(Info.NextAddress))
+            {
+                IRB.createJmpBB(NextBB, Info.NextAddress);
+                NextBB->predecessor_push(BB);
+            }
+            break;
+        }
+        case BlockExitInfo::ExitKind::Jmp: {
+            if (auto DestBB = getBasicBlock(Info.TargetAddress))
+            {
+                IRB.createJmpBB(DestBB, Info.BranchAddress);
+                DestBB->predecessor_push(BB);
+            }
+            else
+            {
+                // Jump out of the function
+                IRB.createJmpAddr(getAddressConstant(Info.TargetAddress), Info.BranchAddress);
+            }
+            break;
+        }
+        case BlockExitInfo::ExitKind::Jcc: {
+            auto DestBB = getBasicBlock(Info.TargetAddress);
+            auto NormalBB = getBasicBlock(Info.NextAddress);
+            if (DestBB && NormalBB && DestBB == NormalBB)
+            {
+                // Both edges reach the same block
+                IRB.createJmpBB(DestBB, Info.BranchAddress);
+                DestBB->predecessor_push(BB);
+            }
+            else if (DestBB || NormalBB)
+            {
+                // The successor outside of the function is reached through an exit block
+                if (DestBB == nullptr)
+                {
+                    DestBB = createExitBasicBlock(Info.TargetAddress, Info.BranchAddress);
+                }
+                if (NormalBB == nullptr)
+                {
+                    NormalBB = createExitBasicBlock(Info.NextAddress, Info.BranchAddress);
+                }
+
+                IRB.createJccBB(
+                    DestBB, NormalBB, uir::FlagsVariable::get(getContext(), Info.Condition), Info.BranchAddress);
+                DestBB->predecessor_push(BB);
+                NormalBB->predecessor_push(BB);
+            }
+            else
+            {
+                // Both edges jump out of the function
+                IRB.createJccAddr(
+                    getAddressConstant(Info.TargetAddress),
+                    getAddressConstant(Info.NextAddress),
+                    uir::FlagsVariable::get(getContext(), Info.Condition),
+                    Info.BranchAddress);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    clearCFG();
+}
+
+} // namespace ufrontend
@@ -1,7 +1,15 @@
 #include "TranslatorImpl.x86.h"
 #include "Error.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 #include <unknown/ADT/ScopeExit.h>
+#include <unknown/Support/ThreadPool.h>
+#include <unknown/Support/Threading.h>
 
 namespace ufrontend {
 
@@ -12,7 +20,13 @@ UnknownFrontendTranslatorImplX86::UnknownFrontendTranslatorImplX86(
     const std::string &SymbolFile,
     const std::string &ConfigFile,
     bool AnalyzeAllFunctions) :
-    UnknownFrontendTranslatorImpl(C, Platform, BinaryFile, SymbolFile, ConfigFile, AnalyzeAllFunctions), mUsePDB(false)
+    UnknownFrontendTranslatorImpl(C, Platform, BinaryFile, SymbolFile, ConfigFile, AnalyzeAllFunctions),
+    mUsePDB(false),
+    mLastSectionView(nullptr),
+    mInsnSlot(nullptr),
+    mInsnSlotDetail(nullptr),
+    mCapstoneDetail(false),
+    mBlockIntervalMap(mBlockIntervalAllocator)
 {
     //
 }
@@ -40,14 +54,32 @@ UnknownFrontendTranslatorImplX86::openCapstoneHandle()
         return;
     }
 
+    // The slot only gets a detail buffer if the detail is on when it is allocated
     cs_option(CapstoneHandle, CS_OPT_DETAIL, CS_OPT_ON);
+    mCapstoneDetail = true;
 
     mCapstoneHandle = CapstoneHandle;
+
+    // Allocate the reusable instruction slot
+    mInsnSlot = cs_malloc(CapstoneHandle);
+    assert(mInsnSlot);
+    mInsnSlotDetail = mInsnSlot->detail;
 }
 
 void
 UnknownFrontendTranslatorImplX86::closeCapstoneHandle()
 {
+    clearDecodedInstructions();
+
+    if (mInsnSlot)
+    {
+        // Give the detail buffer back to the slot so that capstone frees it
+        mInsnSlot->detail = mInsnSlotDetail;
+        cs_free(mInsnSlot, 1);
+        mInsnSlot = nullptr;
+        mInsnSlotDetail = nullptr;
+    }
+
     auto CapstoneHandle = mCapstoneHandle;
     if (CapstoneHandle != 0)
     {
@@ -61,6 +93,159 @@ UnknownFrontendTranslatorImplX86::closeCapstoneHandle()
     }
 }
 
+////////////////////////////////////////////////////////////
+// Worker
+// Create a worker translator that shares the binary, symbols and config with this translator
+std::unique_ptr<UnknownFrontendTranslatorImplX86>
+UnknownFrontendTranslatorImplX86::createWorkerTranslator() const
+{
+    auto Worker = std::make_unique<UnknownFrontendTranslatorImplX86>(
+        getContext(),
+        getPlatform(),
+        getBinaryFile(),
+        getSymbolFile(),
+        getConfigFile(),
+        getEnableAnalyzeAllFunctions());
+    assert(Worker);
+
+    // Share the parsed inputs, they are only read while translating
+    Worker->mConfigReader = mConfigReader;
+    Worker->mSymbolParser = mSymbolParser;
+    Worker->mBinary = mBinary;
+    Worker->mRelocationList = mRelocationList;
+    Worker->mLiftCache = mLiftCache;
+    Worker->setUsePDB(hasUsePDB());
+    Worker->setEnableLazyDecodeDetail(getEnableLazyDecodeDetail());
+    Worker->setEnableStatistics(getEnableStatistics());
+
+    // Each worker owns its capstone handle and register state
+    Worker->openCapstoneHandle();
+
+    return Worker;
+}
+
+////////////////////////////////////////////////////////////
+// Decode
+// Decode one instruction from the given bytes into the reusable slot
+const cs_insn *
+UnknownFrontendTranslatorImplX86::decodeInstruction(const uint8_t *Bytes, size_t Size, uint64_t Address)
+{
+    assert(Bytes);
+    assert(mInsnSlot);
+
+    bool LazyDetail = getEnableLazyDecodeDetail();
+    if (!disassembleInstruction(Bytes, Size, Address, !LazyDetail))
+    {
+        return nullptr;
+    }
+    ++mNumDecodedInstructions;
+
+    // The unknown instructions only need the mnemonic, so only the ones with a semantic translator are decoded
+    // again with the operand detail
+    if (LazyDetail && getInstructionInfo(mInsnSlot->id).TranslateFunction)
+    {
+        if (!disassembleInstruction(Bytes, Size, Address, true))
+        {
+            return nullptr;
+        }
+    }
+
+    return mInsnSlot;
+}
+
+// Disassemble one instruction into the reusable slot, with or without operand detail
+bool
+UnknownFrontendTranslatorImplX86::disassembleInstruction(
+    const uint8_t *Bytes,
+    size_t Size,
+    uint64_t Address,
+    bool WithDetail)
+{
+    if (mCapstoneDetail != WithDetail)
+    {
+        cs_option(getCapstoneHandle(), CS_OPT_DETAIL, WithDetail ? CS_OPT_ON : CS_OPT_OFF);
+        mCapstoneDetail = WithDetail;
+    }
+
+    // Without the detail the slot has no detail buffer, so nothing reads a stale one
+    mInsnSlot->detail = WithDetail ? mInsnSlotDetail : nullptr;
+
+    const uint8_t *Code = Bytes;
+    size_t CodeSize = Size;
+    uint64_t CodeAddress = Address;
+    if (!cs_disasm_iter(getCapstoneHandle(), &Code, &CodeSize, &CodeAddress, mInsnSlot))
+    {
+        return false;
+    }
+
+    if (WithDetail)
+    {
+        ++mNumDetailDecodedInstructions;
+    }
+    return true;
+}
+
+// Decode one instruction in the image, reusing the instruction if it was already decoded in this function
+const cs_insn *
+UnknownFrontendTranslatorImplX86::decodeInstruction(uint64_t Address, uint64_t MaxAddress)
+{
+    auto It = mDecodedInstructionMap.find(Address);
+    if (It != mDecodedInstructionMap.end())
+    {
+        ++mNumDecodeCacheHits;
+        return &It->second->Insn;
+    }
+
+    // Decode straight out of the section memory
+    auto Bytes = getBytesView(Address, MaxAddress - Address);
+    if (Bytes.empty())
+    {
+        return nullptr;
+    }
+
+    std::chrono::steady_clock::time_point DecodeBegin;
+    if (getEnableStatistics())
+    {
+        DecodeBegin = std::chrono::steady_clock::now();
+    }
+
+    auto Insn = decodeInstruction(Bytes.data(), Bytes.size(), Address);
+
+    if (getEnableStatistics())
+    {
+        mDecodeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - DecodeBegin)
+                                  .count();
+    }
+
+    if (Insn == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Keep a copy so that re-entering this address never decodes the bytes again
+    auto Decoded = std::make_unique<DecodedInstruction>();
+    Decoded->Insn = *Insn;
+    mNumCopiedBytes += sizeof(cs_insn);
+    if (Insn->detail)
+    {
+        Decoded->Detail = *Insn->detail;
+        Decoded->Insn.detail = &Decoded->Detail;
+        mNumCopiedBytes += sizeof(cs_detail);
+    }
+
+    auto &Slot = mDecodedInstructionMap[Address];
+    Slot = std::move(Decoded);
+    return &Slot->Insn;
+}
+
+// Clear the decoded-instruction cache
+void
+UnknownFrontendTranslatorImplX86::clearDecodedInstructions()
+{
+    mDecodedInstructionMap.clear();
+}
+
 ////////////////////////////////////////////////////////////
 // Symbol Parser
 void
@@ -68,6 +253,8 @@ UnknownFrontendTranslatorImplX86::initSymbolParser()
 {
     assert(!getSymbolFile().empty());
 
+    unknown::TimeRegion Region(mParseSymbolTimer);
+
     bool UsePDB = false;
     if (getSymbolFile().rfind(".pdb") != std::string::npos)
     {
@@ -87,6 +274,7 @@ UnknownFrontendTranslatorImplX86::initSymbolParser()
 
     mSymbolParser = unknown::CreateSymbolParserForPE(UsePDB);
     assert(mSymbolParser);
+    mSymbolParser->setCacheDirectory(mSymbolCacheDirectory);
 
     if (!mSymbolParser->ParseFunctionSymbols(getSymbolFile()))
     {
@@ -102,8 +290,131 @@ UnknownFrontendTranslatorImplX86::initBinary()
 {
     assert(!getBinaryFile().empty());
 
+    unknown::TimeRegion Region(mParseBinaryTimer);
+
     mBinary = LIEF::PE::Parser::parse(getBinaryFile());
     assert(mBinary);
+
+    mSectionViewMap.clear();
+    mLastSectionView = nullptr;
+
+    initRelocations();
+}
+
+////////////////////////////////////////////////////////////
+// Image
+// Get the section view that contains the address
+const UnknownFrontendTranslatorImplX86::SectionView *
+UnknownFrontendTranslatorImplX86::getSectionView(uint64_t Address)
+{
+    // Fast path, most lookups hit the same section as the last one
+    if (mLastSectionView && Address >= mLastSectionView->AddressBegin && Address < mLastSectionView->AddressEnd)
+    {
+        return mLastSectionView;
+    }
+
+    // Look up the cached views
+    auto It = mSectionViewMap.upper_bound(Address);
+    if (It != mSectionViewMap.begin())
+    {
+        auto &View = std::prev(It)->second;
+        if (Address >= View.AddressBegin && Address < View.AddressEnd)
+        {
+            mLastSectionView = &View;
+            return mLastSectionView;
+        }
+    }
+
+    // Map the section only once
+    auto ImageBase = mBinary->imagebase();
+    for (const auto &Section : mBinary->sections())
+    {
+        auto Content = Section.content();
+        uint64_t AddressBegin = ImageBase + Section.virtual_address();
+        uint64_t AddressEnd = AddressBegin + Content.size();
+        if (Address < AddressBegin || Address >= AddressEnd)
+        {
+            continue;
+        }
+
+        SectionView View;
+        View.AddressBegin = AddressBegin;
+        View.AddressEnd = AddressEnd;
+        View.Data = Content.data();
+
+        auto ItView = mSectionViewMap.insert_or_assign(AddressBegin, View).first;
+        mLastSectionView = &ItView->second;
+        return mLastSectionView;
+    }
+
+    return nullptr;
+}
+
+// Get a view of the bytes in [Address, Address + Size), clipped to the end of the section
+std::span<const uint8_t>
+UnknownFrontendTranslatorImplX86::getBytesView(uint64_t Address, size_t Size)
+{
+    auto View = getSectionView(Address);
+    if (View == nullptr)
+    {
+        return {};
+    }
+
+    size_t MaxSize = View->AddressEnd - Address;
+    return {View->Data + (Address - View->AddressBegin), std::min(Size, MaxSize)};
+}
+
+// Get the end address of the section that contains the address
+uint64_t
+UnknownFrontendTranslatorImplX86::getSectionEndAddress(uint64_t Address)
+{
+    auto View = getSectionView(Address);
+    if (View == nullptr)
+    {
+        return 0;
+    }
+
+    return View->AddressEnd;
+}
+
+// Collect the base relocations of the image
+void
+UnknownFrontendTranslatorImplX86::initRelocations()
+{
+    auto RelocationList = std::make_shared<LiftCache::RelocationListType>();
+    assert(RelocationList);
+
+    for (const auto &Relocation : mBinary->relocations())
+    {
+        for (const auto &Entry : Relocation.entries())
+        {
+            RelocationList->push_back(
+                {Relocation.virtual_address() + Entry.position(), static_cast<uint32_t>(Entry.type())});
+        }
+    }
+    std::sort(RelocationList->begin(), RelocationList->end());
+
+    mRelocationList = RelocationList;
+}
+
+// Get the base relocations in [Address, Address + Size)
+LiftCache::RelocationListType
+UnknownFrontendTranslatorImplX86::getRelocations(uint64_t Address, size_t Size) const
+{
+    if (!mRelocationList)
+    {
+        return {};
+    }
+
+    // The relocations are image-relative
+    uint64_t RVABegin = Address - mBinary->imagebase();
+    uint64_t RVAEnd = RVABegin + Size;
+
+    auto compareRVA = [](const std::pair<uint64_t, uint32_t> &Item, uint64_t RVA) { return Item.first < RVA; };
+    auto ItBegin = std::lower_bound(mRelocationList->begin(), mRelocationList->end(), RVABegin, compareRVA);
+    auto ItEnd = std::lower_bound(ItBegin, mRelocationList->end(), RVAEnd, compareRVA);
+
+    return {ItBegin, ItEnd};
 }
 
 ////////////////////////////////////////////////////////////
@@ -134,71 +445,165 @@ UnknownFrontendTranslatorImplX86::getBasePointerRegisterName() const
 
 ////////////////////////////////////////////////////////////
 // Translate
-// Init the instruction translator
-void
-UnknownFrontendTranslatorImplX86::initTranslateInstruction()
-{
-    mX86InstructionTranslatorMap = {
-        // Ret
-        {X86_INS_RET, {&UnknownFrontendTranslatorImplX86::translateRetInstruction, true}},
-
-        // Mov
-        {X86_INS_MOV, {&UnknownFrontendTranslatorImplX86::translateMovInstruction, false}},
-
-        // Push/Pop
-        {X86_INS_PUSH, {&UnknownFrontendTranslatorImplX86::translatePushInstruction, false}},
-        {X86_INS_POP, {&UnknownFrontendTranslatorImplX86::translatePopInstruction, false}},
-
-        // Jcc
-        {X86_INS_JAE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JA, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JBE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JB, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JGE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JG, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JLE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JL, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JNE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JNO, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JNP, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JNS, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JO, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JP, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}},
-        {X86_INS_JS, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true}}
+// Translate the given binary into UnknownIR
+std::unique_ptr<uir::Module>
+UnknownFrontendTranslatorImplX86::translateBinary(const std::string &ModuleName)
+{
+    return translateBinary(ModuleName, [](uir::Function &F) { return true; });
+}
 
-    };
+std::unique_ptr<uir::Module>
+UnknownFrontendTranslatorImplX86::translateBinary(const std::string &ModuleName, uint32_t NumThreads)
+{
+    return translateBinary(ModuleName, [](uir::Function &F) { return true; }, NumThreads);
 }
 
-// Translate the given binary into UnknownIR
 std::unique_ptr<uir::Module>
-UnknownFrontendTranslatorImplX86::translateBinary(const std::string &ModuleName)
+UnknownFrontendTranslatorImplX86::translateBinary(
+    const std::string &ModuleName,
+    const FunctionSinkType &Sink,
+    uint32_t NumThreads)
 {
+    assert(Sink);
+
+    unknown::TimeRegion Region(mTranslateTimer);
+
+    if (NumThreads == 0)
+    {
+        NumThreads = unknown::hardware_concurrency();
+    }
+
     auto Module = uir::Module::get(getContext(), ModuleName);
     assert(Module);
 
-    for (auto &FunctionSymbol : mSymbolParser->getFunctionSymbols())
+    // Hand the function to the sink, and keep it only if the sink asks for it
+    auto sinkFunction = [&Sink, &Module](std::unique_ptr<uir::Function> F) {
+        if (Sink(*F))
+        {
+            // Insert the function into the module
+            Module->insertFunction(F.release());
+        }
+    };
+
+    auto FunctionSymbols = mSymbolParser->getFunctionSymbols();
+
+    if (NumThreads <= 1)
     {
-        auto F = std::make_unique<uir::Function>(getContext());
-        assert(F);
+        for (auto &FunctionSymbol : FunctionSymbols)
+        {
+            auto F = std::make_unique<uir::Function>(getContext());
+            assert(F);
+
+            // Translate the function into UnknownIR, its values live in its arena
+            bool TransRes = false;
+            {
+                uir::Function::ArenaScope Scope(*F);
+                TransRes = translateOneFunction(FunctionSymbol, F.get());
+            }
 
-        // Translate the function into UnknownIR
-        bool TransRes = translateOneFunction(FunctionSymbol, F.get());
-        if (TransRes)
+            if (TransRes)
+            {
+                if (!F->empty())
+                {
+                    sinkFunction(std::move(F));
+                }
+            }
+            else
+            {
+                std::cerr << std::format(
+                                 UFRONTEND_ERROR_PREFIX "translateOneFunction: {} failed", F->getFunctionName())
+                          << std::endl;
+            }
+        }
+    }
+    else
+    {
+        // One slot per symbol, so the functions reach the sink in symbol order.
+        // The workers stay within a window of the next function to sink, which bounds the functions held in memory.
+        const size_t Window = NumThreads * 4;
+        std::vector<std::unique_ptr<uir::Function>> Functions(FunctionSymbols.size());
+        std::vector<bool> Translated(FunctionSymbols.size(), false);
+        std::vector<std::unique_ptr<UnknownFrontendTranslatorImplX86>> Workers;
+        std::atomic<size_t> NextIndex = 0;
+        size_t NextSinkIndex = 0;
+        std::mutex Mutex;
+        std::condition_variable CV;
+
+        unknown::ThreadPool Pool(NumThreads);
+        for (uint32_t i = 0; i < NumThreads; ++i)
         {
-            if (!F->empty())
+            Workers.push_back(createWorkerTranslator());
+            auto Worker = Workers.back().get();
+
+            Pool.async([&, Worker]() {
+                for (size_t Index = NextIndex++; Index < FunctionSymbols.size(); Index = NextIndex++)
+                {
+                    {
+                        std::unique_lock<std::mutex> Lock(Mutex);
+                        CV.wait(Lock, [&]() { return Index < NextSinkIndex + Window; });
+                    }
+
+                    auto F = std::make_unique<uir::Function>(getContext());
+                    assert(F);
+
+                    // Translate the function into UnknownIR, its values live in its arena
+                    bool TransRes = false;
+                    {
+                        uir::Function::ArenaScope Scope(*F);
+                        TransRes = Worker->translateOneFunction(FunctionSymbols[Index], F.get());
+                    }
+
+                    if (!TransRes)
+                    {
+                        std::cerr << std::format(
+                                         UFRONTEND_ERROR_PREFIX "translateOneFunction: {} failed", F->getFunctionName())
+                                  << std::endl;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> Lock(Mutex);
+                        if (TransRes && !F->empty())
+                        {
+                            Functions[Index] = std::move(F);
+                        }
+                        Translated[Index] = true;
+                    }
+                    CV.notify_all();
+                }
+            });
+        }
+
+        // Sink the functions on this thread, so the sink does not need to be thread-safe
+        while (NextSinkIndex < FunctionSymbols.size())
+        {
+            std::unique_ptr<uir::Function> F;
             {
-                // Insert the function into the module
-                Module->insertFunction(F.release());
+                std::unique_lock<std::mutex> Lock(Mutex);
+                CV.wait(Lock, [&]() { return Translated[NextSinkIndex]; });
+                F = std::move(Functions[NextSinkIndex]);
+                ++NextSinkIndex;
+            }
+            CV.notify_all();
+
+            if (F)
+            {
+                sinkFunction(std::move(F));
             }
         }
-        else
+        Pool.wait();
+
+        for (auto &Worker : Workers)
         {
-            std::cerr << std::format(UFRONTEND_ERROR_PREFIX "translateOneFunction: {} failed", F->getFunctionName())
-                      << std::endl;
+            mergeStatistics(*Worker);
         }
     }
 
+    // Bound the lift cache
+    if (mLiftCache)
+    {
+        mLiftCache->prune();
+    }
+
     return Module;
 }
 
@@ -213,20 +618,9 @@ UnknownFrontendTranslatorImplX86::translateOneInstruction(
     assert(Bytes);
     assert(BB);
 
-    cs_insn *Insn = nullptr;
-
     // Disasm
-    size_t DisasmCount = cs_disasm(getCapstoneHandle(), const_cast<const uint8_t *>(Bytes), Size, Address, 1, &Insn);
-    auto DeferredInsn = unknown::make_scope_exit([&Insn]() {
-        if (Insn)
-        {
-            cs_free(Insn, 1);
-            Insn = nullptr;
-        }
-    });
-
-    bool DisasmRes = DisasmCount == 1;
-    if (!DisasmRes)
+    auto Insn = decodeInstruction(Bytes, Size, Address);
+    if (Insn == nullptr)
     {
         std::cerr << std::format(UFRONTEND_ERROR_PREFIX "disasm: 0x{:X} failed", Address) << std::endl;
         return false;
@@ -261,10 +655,10 @@ UnknownFrontendTranslatorImplX86::translateOneInstruction(
         setCurPtrEnd(Address + Insn->size);
         if (getCurPtrEnd() <= getCurPtrBegin())
         {
-            auto CurSection = mBinary->get_section(getCurPtrBegin());
-            if (CurSection)
+            auto SectionEnd = getSectionEndAddress(getCurPtrBegin());
+            if (SectionEnd)
             {
-                setCurPtrEnd(mBinary->imagebase() + CurSection->virtual_address() + CurSection->sizeof_raw_data());
+                setCurPtrEnd(SectionEnd);
             }
         }
         assert(getCurPtrEnd());
@@ -273,18 +667,33 @@ UnknownFrontendTranslatorImplX86::translateOneInstruction(
 
     bool TransRes = false;
 
-    auto ItTrans = mX86InstructionTranslatorMap.find(Insn->id);
-    if (ItTrans != mX86InstructionTranslatorMap.end())
+    std::chrono::steady_clock::time_point TranslateBegin;
+    if (getEnableStatistics())
+    {
+        TranslateBegin = std::chrono::steady_clock::now();
+    }
+
+    const auto &TransInfo = getInstructionInfo(Insn->id);
+    if (TransInfo.TranslateFunction)
     {
-        auto &TransInfo = ItTrans->second;
         IsBlockTerminatorInsn = TransInfo.IsBlockTerminatorInsn;
         TransRes = (this->*TransInfo.TranslateFunction)(Insn, BB);
     }
     else
     {
         TransRes = translateUnknownX86Instruction(Insn, BB);
+        ++mNumUnknownInstructions;
     }
 
+    uint64_t TranslateNanoseconds = 0;
+    if (getEnableStatistics())
+    {
+        TranslateNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - TranslateBegin)
+                                   .count();
+    }
+    countTranslatedInstruction(Insn->id, TranslateNanoseconds);
+
     return TransRes;
 }
 
@@ -310,10 +719,10 @@ UnknownFrontendTranslatorImplX86::translateOneBasicBlock(
         setCurPtrEnd(MaxAddress);
         if (getCurPtrEnd() <= getCurPtrBegin())
         {
-            auto CurSection = mBinary->get_section(getCurPtrBegin());
-            if (CurSection)
+            auto SectionEnd = getSectionEndAddress(getCurPtrBegin());
+            if (SectionEnd)
             {
-                setCurPtrEnd(mBinary->imagebase() + CurSection->virtual_address() + CurSection->sizeof_raw_data());
+                setCurPtrEnd(SectionEnd);
             }
         }
         assert(getCurPtrEnd());
@@ -324,46 +733,44 @@ UnknownFrontendTranslatorImplX86::translateOneBasicBlock(
     assert(NewBB);
 
     // Translate
+    size_t NumInsns = 0;
+    const cs_insn *LastInsn = nullptr;
+    bool HasTerminatorInsn = false;
     while (getCurPtrBegin() < getCurPtrEnd())
     {
-        cs_insn *Insn = nullptr;
-
         uint64_t Address = getCurPtrBegin();
         uint64_t MaxAddress = getCurPtrEnd();
-        size_t Size = MaxAddress - Address;
 
-        uint8_t *Bytes = new uint8_t[Size]{};
-        assert(Bytes);
-        auto DeferredBytes = unknown::make_scope_exit([&Bytes]() {
-            if (Bytes)
-            {
-                delete[] Bytes;
-                Bytes = nullptr;
-            }
-        });
-
-        auto Contents = mBinary->get_content_from_virtual_address(Address, Size);
-        assert(!Contents.empty());
-        std::copy(Contents.begin(), Contents.end(), Bytes);
+        // Stop at the leader of a basic block that was already translated
+        if (NumInsns && mBlockIntervalMap.lookup(Address, nullptr))
+        {
+            break;
+        }
 
         // Disasm
-        size_t DisasmCount =
-            cs_disasm(getCapstoneHandle(), const_cast<const uint8_t *>(Bytes), Size, Address, 1, &Insn);
-        auto DeferredInsn = unknown::make_scope_exit([&Insn]() {
-            if (Insn)
-            {
-                cs_free(Insn, 1);
-                Insn = nullptr;
-            }
-        });
-
-        bool DisasmRes = DisasmCount == 1;
-        if (!DisasmRes)
+        auto Insn = decodeInstruction(Address, MaxAddress);
+        if (Insn == nullptr)
         {
             std::cerr << std::format(UFRONTEND_ERROR_PREFIX "disasm: 0x{:X} failed", Address) << std::endl;
+            LastInsn = nullptr;
             break;
         }
 
+        // Overlapping instructions are not supported, the bytes already belong to another basic block
+        if (auto ItInterval = mBlockIntervalMap.find(Address);
+            ItInterval.valid() && ItInterval.start() < Address + Insn->size)
+        {
+            break;
+        }
+
+        // Remember where the IR of the instruction starts, so that the block can be split here
+        auto &Pos = mInstructionPositionMap[Address];
+        Pos.HasPrev = !NewBB->empty();
+        if (Pos.HasPrev)
+        {
+            Pos.PrevIt = std::prev(NewBB->end());
+        }
+
         // Translate one instruction
         bool IsTerminatorInsn = false;
         bool TransRes = translateOneInstruction(Insn, Address, NewBB.get(), IsTerminatorInsn);
@@ -371,27 +778,45 @@ UnknownFrontendTranslatorImplX86::translateOneBasicBlock(
         {
             std::cerr << std::format(UFRONTEND_ERROR_PREFIX "translateOneInstruction: 0x{:X} failed", Address)
                       << std::endl;
+            LastInsn = nullptr;
             break;
         }
 
+        ++NumInsns;
+        LastInsn = Insn;
+
         // Update ptr
         setCurPtrBegin(Address + Insn->size);
 
         if (IsTerminatorInsn)
         {
+            HasTerminatorInsn = true;
             break;
         }
     }
 
-    if (NewBB->empty())
+    // A block that holds only a branch has no IR yet, so check the decoded instructions instead
+    if (NumInsns == 0)
     {
         NewBB.reset(nullptr);
         return nullptr;
     }
 
+    // Record how the basic block is left
+    if (LastInsn)
+    {
+        updateBlockExitInfo(NewBB.get(), LastInsn, HasTerminatorInsn);
+    }
+    else
+    {
+        mBlockExitInfoMap[NewBB.get()] = BlockExitInfo();
+    }
+
     // Update the end address of the basic block
     NewBB->setBasicBlockAddressEnd(getCurPtrBegin());
 
+    ++mNumTranslatedBasicBlocks;
+
     return NewBB.release();
 }
 
@@ -412,8 +837,15 @@ UnknownFrontendTranslatorImplX86::translateOneFunction(
         return true;
     }
 
-    // Clear mRegisterCounterMap
-    mRegisterCounterMap.clear();
+    // Reset the register state of the previous function
+    resetVirtualRegisterInfo();
+
+    // The register state is reset again when the function is done, it may be destroyed with its arena before the next
+    // function is translated
+    auto ResetRegisters = unknown::make_scope_exit([this]() { resetVirtualRegisterInfo(); });
+
+    // Clear the decoded-instruction cache of the previous function
+    clearDecodedInstructions();
 
     // Set the current function
     setCurFunction(F);
@@ -425,10 +857,10 @@ UnknownFrontendTranslatorImplX86::translateOneFunction(
     // Update the end pointer if it's not valid
     if (getCurPtrEnd() <= getCurPtrBegin())
     {
-        auto CurSection = mBinary->get_section(getCurPtrBegin());
-        if (CurSection)
+        auto SectionEnd = getSectionEndAddress(getCurPtrBegin());
+        if (SectionEnd)
         {
-            setCurPtrEnd(mBinary->imagebase() + CurSection->virtual_address() + CurSection->sizeof_raw_data());
+            setCurPtrEnd(SectionEnd);
         }
     }
 
@@ -436,33 +868,69 @@ UnknownFrontendTranslatorImplX86::translateOneFunction(
     assert(getCurPtrEnd());
     assert(getCurPtrEnd() > getCurPtrBegin());
 
-    while (getCurPtrBegin() < getCurPtrEnd())
+    // Recursive descent from the entry, only the reachable code is translated
+    const uint64_t FunctionBegin = getCurPtrBegin();
+    const uint64_t FunctionEnd = getCurPtrEnd();
+
+    // Rehydrate the function from the lift cache if its content has not changed
+    std::string LiftCacheKey;
+    if (mLiftCache)
     {
-        // Translate a basic block
-        auto BB = translateOneBasicBlock("", getCurPtrBegin(), getCurPtrEnd());
-        if (BB == nullptr)
+        auto Bytes = getBytesView(FunctionBegin, FunctionEnd - FunctionBegin);
+        LiftCacheKey = LiftCache::computeKey(
+            getContext(),
+            FunctionBegin,
+            {Bytes.data(), Bytes.size()},
+            getRelocations(FunctionBegin, Bytes.size()),
+            F->getFunctionAttributesList());
+
+        if (mLiftCache->load(LiftCacheKey, F))
         {
-            break;
+            // Update function context
+            UpdateFunctionContext(F);
+
+            ++mNumTranslatedFunctions;
+            return true;
         }
+    }
+
+    clearCFG();
 
-        // Insert a basic block into the function
-        if (!BB->empty())
+    std::vector<uint64_t> Worklist = {FunctionBegin};
+    while (!Worklist.empty())
+    {
+        uint64_t Leader = Worklist.back();
+        Worklist.pop_back();
+
+        // The targets outside of the function are left to the terminators
+        if (Leader < FunctionBegin || Leader >= FunctionEnd)
         {
-            F->insertBasicBlock(BB);
+            continue;
         }
 
-        // Update ptr
-        setCurPtrBegin(BB->getBasicBlockAddressEnd());
+        // Translate or split a basic block
+        getOrCreateBasicBlock(Leader, FunctionEnd, Worklist);
     }
 
+    // Insert the basic blocks into the function and build the edges
+    finalizeCFG(F);
+
     if (F->empty())
     {
         return false;
     }
 
+    // Save the function into the lift cache
+    if (mLiftCache)
+    {
+        mLiftCache->store(LiftCacheKey, F);
+    }
+
     // Update function context
     UpdateFunctionContext(F);
 
+    ++mNumTranslatedFunctions;
+
     return true;
 }
 
@@ -507,6 +975,16 @@ UnknownFrontendTranslatorImplX86::setUsePDB(bool HasUsePDB)
     mUsePDB = HasUsePDB;
 }
 
+////////////////////////////////////////////////////////////
+// Statistics
+// Get the name of an instruction id for the statistics
+std::string
+UnknownFrontendTranslatorImplX86::getInstructionName(uint32_t InsnID) const
+{
+    auto Name = cs_insn_name(getCapstoneHandle(), InsnID);
+    return Name ? Name : std::to_string(InsnID);
+}
+
 ////////////////////////////////////////////////////////////
 // Register
 // Get the register name by register id
@@ -645,8 +1123,16 @@ UnknownFrontendTranslatorImplX86::loadRegister(uint32_t RegID, uint64_t Address,
             uir::IRBuilder IRB(BB);
             auto SavedRegVal = IRB.createLoad(RegisterPtr.value(), Address);
 
-            // Set new name
-            SavedRegVal->setName(getRegisterNameWithIndexByDefault(RegisterPtr.value()->getName()).c_str());
+            // Set new name, rax3
+            auto RegName = RegisterPtr.value()->getName();
+            if (!RegName.empty())
+            {
+                SavedRegVal->setName(RegName, mRegisterCounterMap[getRegisterID(RegName)]++);
+            }
+            else
+            {
+                SavedRegVal->setName("");
+            }
 
             // Save SavedRegVal
             VRegInfoMap[VRegID].SavedRegVal = SavedRegVal;
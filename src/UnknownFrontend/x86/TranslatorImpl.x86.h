@@ -1,22 +1,127 @@
 #pragma once
 
+#include <array>
+#include <initializer_list>
+#include <span>
+#include <utility>
+
 #include <LIEF/PE.hpp>
 
+#include <UnknownUtils/unknown/ADT/IntervalMap.h>
 #include <UnknownUtils/unknown/Symbol/SymbolParser.h>
 
 #include <TranslatorImpl.h>
 
 namespace ufrontend {
 
+class UnknownFrontendTranslatorImplX86;
+
+// The translator and the properties of one x86 instruction
+struct X86InstructionInfo
+{
+    bool (UnknownFrontendTranslatorImplX86::*TranslateFunction)(const cs_insn *Insn, uir::BasicBlock *BB) = nullptr;
+    bool IsBlockTerminatorInsn = false;
+    bool IsFlagsConsumer = false;
+};
+// [X86_INS_*, X86InstructionInfo]
+using X86InstructionInfoTableType = std::array<X86InstructionInfo, X86_INS_ENDING>;
+
+// Build the dispatch table from the registered translators
+constexpr X86InstructionInfoTableType
+createX86InstructionInfoTable(std::initializer_list<std::pair<uint32_t, X86InstructionInfo>> Translators)
+{
+    X86InstructionInfoTableType Table{};
+    for (const auto &Item : Translators)
+    {
+        Table[Item.first] = Item.second;
+    }
+    return Table;
+}
+
 class UnknownFrontendTranslatorImplX86 : public UnknownFrontendTranslatorImpl
 {
 private:
-    std::unique_ptr<unknown::SymbolParser> mSymbolParser;
-    std::unique_ptr<LIEF::PE::Binary> mBinary;
+    std::shared_ptr<unknown::SymbolParser> mSymbolParser;
+    std::shared_ptr<LIEF::PE::Binary> mBinary;
 
 private:
     bool mUsePDB;
 
+private:
+    // A read-only view of the raw data of a section, mapped by virtual address
+    struct SectionView
+    {
+        uint64_t AddressBegin = 0;
+        uint64_t AddressEnd = 0;
+        const uint8_t *Data = nullptr;
+    };
+    // [AddressBegin, SectionView]
+    std::map<uint64_t, SectionView> mSectionViewMap;
+
+    // The last section view we hit
+    const SectionView *mLastSectionView;
+
+    // The base relocations of the image sorted by RVA, shared with the workers
+    std::shared_ptr<const LiftCache::RelocationListType> mRelocationList;
+
+private:
+    // The reusable instruction slot for the disassembler
+    cs_insn *mInsnSlot;
+
+    // The detail buffer of the slot, detached while decoding without detail
+    cs_detail *mInsnSlotDetail;
+
+    // Is CS_OPT_DETAIL on?
+    bool mCapstoneDetail;
+
+    // A decoded instruction that owns a copy of its detail
+    struct DecodedInstruction
+    {
+        cs_insn Insn;
+        cs_detail Detail;
+    };
+    // [Address, DecodedInstruction]
+    std::unordered_map<uint64_t, std::unique_ptr<DecodedInstruction>> mDecodedInstructionMap;
+
+private:
+    // How a basic block is left
+    struct BlockExitInfo
+    {
+        enum class ExitKind
+        {
+            None,
+            FallThrough,
+            Jmp,
+            Jcc
+        };
+        ExitKind Kind = ExitKind::None;
+        uint64_t BranchAddress = 0;
+        uint64_t TargetAddress = 0;
+        uint64_t NextAddress = 0;
+        uir::FlagsVariable::ConditionKind Condition = uir::FlagsVariable::ConditionKind::None;
+    };
+
+    // Where the IR of an instruction starts in its basic block
+    struct InstructionPosition
+    {
+        bool HasPrev = false;
+        uir::BasicBlock::iterator PrevIt;
+    };
+
+    // [AddressBegin, BasicBlock]
+    std::map<uint64_t, uir::BasicBlock *> mBasicBlockMap;
+
+    // [BasicBlock, BlockExitInfo]
+    std::unordered_map<uir::BasicBlock *, BlockExitInfo> mBlockExitInfoMap;
+
+    // [Address, InstructionPosition]
+    std::unordered_map<uint64_t, InstructionPosition> mInstructionPositionMap;
+
+    // The decoded ranges of the current function, [AddressBegin, AddressEnd - 1] -> BasicBlock
+    using BlockIntervalMapType = unknown::IntervalMap<uint64_t, uir::BasicBlock *>;
+    BlockIntervalMapType::Allocator mBlockIntervalAllocator;
+    BlockIntervalMapType mBlockIntervalMap;
+
 public:
     UnknownFrontendTranslatorImplX86(
         uir::Context &C,
@@ -40,6 +145,62 @@ protected:
     // Binary
     virtual void initBinary() override;
 
+protected:
+    // Worker
+    // Create a worker translator that shares the binary, symbols and config with this translator
+    std::unique_ptr<UnknownFrontendTranslatorImplX86> createWorkerTranslator() const;
+
+protected:
+    // Decode
+    // Decode one instruction from the given bytes into the reusable slot
+    const cs_insn *decodeInstruction(const uint8_t *Bytes, size_t Size, uint64_t Address);
+
+    // Disassemble one instruction into the reusable slot, with or without operand detail
+    bool disassembleInstruction(const uint8_t *Bytes, size_t Size, uint64_t Address, bool WithDetail);
+
+    // Decode one instruction in the image, reusing the instruction if it was already decoded in this function
+    const cs_insn *decodeInstruction(uint64_t Address, uint64_t MaxAddress);
+
+    // Clear the decoded-instruction cache
+    void clearDecodedInstructions();
+
+protected:
+    // CFG
+    // Clear the CFG of the current function
+    void clearCFG();
+
+    // Get the basic block that starts at the address, translating or splitting as needed
+    uir::BasicBlock *getOrCreateBasicBlock(uint64_t Address, uint64_t MaxAddress, std::vector<uint64_t> &Worklist);
+
+    // Split the basic block at the address of one of its instructions
+    uir::BasicBlock *splitBasicBlock(uir::BasicBlock *BB, uint64_t Address);
+
+    // Record how the basic block is left by its last instruction
+    void updateBlockExitInfo(uir::BasicBlock *BB, const cs_insn *Insn, bool IsTerminatorInsn);
+
+    // Get the condition tested by a Jcc instruction
+    static uir::FlagsVariable::ConditionKind getJccCondition(uint32_t InsnID);
+
+    // Insert the basic blocks into the function and connect them
+    void finalizeCFG(uir::Function *F);
+
+protected:
+    // Image
+    // Get the section view that contains the address
+    const SectionView *getSectionView(uint64_t Address);
+
+    // Get a view of the bytes in [Address, Address + Size), clipped to the end of the section
+    std::span<const uint8_t> getBytesView(uint64_t Address, size_t Size);
+
+    // Get the end address of the section that contains the address
+    uint64_t getSectionEndAddress(uint64_t Address);
+
+    // Collect the base relocations of the image
+    void initRelocations();
+
+    // Get the base relocations in [Address, Address + Size)
+    LiftCache::RelocationListType getRelocations(uint64_t Address, size_t Size) const;
+
 protected:
     // x86-specific pointer
     const uint32_t getStackPointerRegister() const;
@@ -48,15 +209,14 @@ protected:
     const uint32_t getBasePointerRegister() const;
     const unknown::StringRef getBasePointerRegisterName() const;
 
-protected:
-    // Translate
-    // Init the instruction translator
-    virtual void initTranslateInstruction() override;
-
 public:
     // Translate
     // Translate the given binary into UnknownIR
     virtual std::unique_ptr<uir::Module> translateBinary(const std::string &ModuleName) override;
+    virtual std::unique_ptr<uir::Module>
+    translateBinary(const std::string &ModuleName, uint32_t NumThreads) override;
+    virtual std::unique_ptr<uir::Module>
+    translateBinary(const std::string &ModuleName, const FunctionSinkType &Sink, uint32_t NumThreads = 1) override;
 
     // Translate one instruction into UnknownIR
     virtual bool
@@ -83,6 +243,11 @@ protected:
     // We use pdb?
     void setUsePDB(bool HasUsePDB);
 
+protected:
+    // Statistics
+    // Get the name of an instruction id for the statistics
+    virtual std::string getInstructionName(uint32_t InsnID) const override;
+
 protected:
     // Register
     // Get the register name by register id
@@ -155,15 +320,55 @@ private:
     bool translatePushInstruction(const cs_insn *Insn, uir::BasicBlock *BB);
     bool translatePopInstruction(const cs_insn *Insn, uir::BasicBlock *BB);
 
+    // Jmp
+    bool translateJmpInstruction(const cs_insn *Insn, uir::BasicBlock *BB);
+
     // Jcc
     bool translateJccInstruction(const cs_insn *Insn, uir::BasicBlock *BB);
 
-    struct InstructionInfo
+    using InstructionInfo = X86InstructionInfo;
+
+    // The instruction translators, indexed by X86_INS_*
+    static constexpr X86InstructionInfoTableType mX86InstructionInfoTable = createX86InstructionInfoTable({
+        // [X86_INS_*, {TranslateFunction, IsBlockTerminatorInsn, IsFlagsConsumer}]
+        // Ret
+        {X86_INS_RET, {&UnknownFrontendTranslatorImplX86::translateRetInstruction, true}},
+
+        // Mov
+        {X86_INS_MOV, {&UnknownFrontendTranslatorImplX86::translateMovInstruction, false}},
+
+        // Push/Pop
+        {X86_INS_PUSH, {&UnknownFrontendTranslatorImplX86::translatePushInstruction, false}},
+        {X86_INS_POP, {&UnknownFrontendTranslatorImplX86::translatePopInstruction, false}},
+
+        // Jmp
+        {X86_INS_JMP, {&UnknownFrontendTranslatorImplX86::translateJmpInstruction, true}},
+
+        // Jcc
+        {X86_INS_JAE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JA, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JBE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JB, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JGE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JG, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JLE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JL, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JNE, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JNO, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JNP, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JNS, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JO, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JP, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}},
+        {X86_INS_JS, {&UnknownFrontendTranslatorImplX86::translateJccInstruction, true, true}}
+    });
+
+    // Get the information of the instruction, the unregistered ones have no translate function
+    static const InstructionInfo &getInstructionInfo(uint32_t InsnID)
     {
-        decltype(&translateUnknownX86Instruction) TranslateFunction = nullptr;
-        bool IsBlockTerminatorInsn = false;
-    };
-    std::unordered_map<uint32_t, InstructionInfo> mX86InstructionTranslatorMap;
+        return InsnID < mX86InstructionInfoTable.size() ? mX86InstructionInfoTable[InsnID]
+                                                        : mX86InstructionInfoTable[X86_INS_INVALID];
+    }
 };
 
 } // namespace ufrontend
@@ -1,10 +1,12 @@
 #include <Argument.h>
 #include <Function.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
 
 namespace uir {
 
@@ -14,8 +16,7 @@ namespace uir {
 Argument::Argument(Type *Ty, const unknown::StringRef &ArgName, Function *F, uint32_t ArgNo) :
     Constant(Ty, ArgName), mParent(F), mArgNo(ArgNo)
 {
-    //
-    //
+    mValueID = ArgumentVal;
 }
 
 Argument::~Argument()
@@ -125,9 +126,8 @@ Argument::getPropertyArgNo() const
 void
 Argument::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the arg
@@ -143,29 +143,17 @@ Argument::print(unknown::XMLPrinter &Printer) const
 
     // argno
     {
-        Printer.PushAttribute(getPropertyArgNo().data(), std::format("{}", getArgNo()).c_str());
+        Printer.PushAttribute(getPropertyArgNo().data(), getArgNo());
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     Printer.CloseElement();
@@ -176,7 +164,7 @@ Argument::print(unknown::XMLPrinter &Printer) const
 Argument *
 Argument::get(Type *Ty, const unknown::StringRef &ArgName, Function *F, uint32_t ArgNo)
 {
-    return new Argument(Ty, ArgName, F, ArgNo);
+    return construct<Argument>(Ty->getContext(), Ty, ArgName, F, ArgNo);
 }
 
 } // namespace uir
@@ -1,11 +1,13 @@
 #include <BasicBlock.h>
 #include <Instruction.h>
 #include <Function.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
 
 namespace uir {
 
@@ -24,14 +26,22 @@ BasicBlock::BasicBlock(
     uint64_t BasicBlockAddressEnd,
     Function *Parent /*= nullptr*/) :
     Constant(Type::getLabelTy(C), BasicBlockName),
-    mBasicBlockName(BasicBlockName),
+    mBasicBlockName(nullptr),
     mBasicBlockAddressBegin(BasicBlockAddressBegin),
     mBasicBlockAddressEnd(BasicBlockAddressEnd),
-    mParent(Parent)
+    mParent(Parent),
+    mOrder(0),
+    mInstOrderValid(true)
 {
-    if (mBasicBlockName.empty())
+    mValueID = BasicBlockVal;
+
+    if (BasicBlockName.empty())
+    {
+        setBasicBlockName(BasicBlock::generateOrderedBasicBlockName(C));
+    }
+    else
     {
-        mBasicBlockName = BasicBlock::generateOrderedBasicBlockName(C);
+        setBasicBlockName(BasicBlockName);
     }
 }
 
@@ -40,6 +50,116 @@ BasicBlock::~BasicBlock()
     clearAllInstructions();
 }
 
+////////////////////////////////////////////////////////////
+// InstList
+// Insert an instruction at the end of this block
+void
+BasicBlock::push_back(Instruction *I)
+{
+    assert(I && "I != nullptr");
+
+    // Appending keeps the order valid
+    if (mInstOrderValid)
+    {
+        I->mOrder = mInstList.empty() ? 0 : mInstList.back().mOrder + 1;
+    }
+
+    mInstList.push_back(*I);
+    I->setParent(this);
+}
+
+// Insert an instruction before the specified position
+BasicBlock::iterator
+BasicBlock::insert(iterator It, Instruction *I)
+{
+    assert(I && "I != nullptr");
+    assert(I->getParent() == nullptr && "Instruction is already in a block!");
+
+    if (It == end())
+    {
+        push_back(I);
+        return iterator(I->getIterator());
+    }
+
+    invalidateOrders();
+    I->setParent(this);
+    return iterator(mInstList.insert(It.getNodeIterator(), *I));
+}
+
+// Remove the instruction at the specified position, but does not delete it
+BasicBlock::iterator
+BasicBlock::erase(iterator It)
+{
+    auto I = *It;
+    auto Next = iterator(mInstList.erase(It.getNodeIterator()));
+    I->setParent(nullptr);
+    return Next;
+}
+
+// Remove the instructions [First, Last), but does not delete them
+BasicBlock::iterator
+BasicBlock::erase(iterator First, iterator Last)
+{
+    while (First != Last)
+    {
+        First = erase(First);
+    }
+
+    return Last;
+}
+
+// Remove an instruction of this block, but does not delete it
+void
+BasicBlock::remove(Instruction *I)
+{
+    assert(I && I->getParent() == this && "Instruction is not in this block!");
+
+    // Removing keeps the order valid
+    mInstList.remove(*I);
+    I->setParent(nullptr);
+}
+
+// Remove all instructions, but does not delete them
+void
+BasicBlock::clear()
+{
+    erase(begin(), end());
+    mInstOrderValid = true;
+}
+
+// Move the instructions [First, Last) of another block before I
+void
+BasicBlock::splice(iterator It, BasicBlock *From, iterator First, iterator Last)
+{
+    assert(From && "From != nullptr");
+
+    if (First == Last)
+    {
+        return;
+    }
+
+    for (auto InstIt = First; InstIt != Last; ++InstIt)
+    {
+        (*InstIt)->setParent(this);
+    }
+
+    mInstList.splice(It.getNodeIterator(), From->mInstList, First.getNodeIterator(), Last.getNodeIterator());
+    invalidateOrders();
+}
+
+// Get the iterator of an instruction in this block
+BasicBlock::iterator
+BasicBlock::getInstIterator(Instruction *I)
+{
+    return iterator(I->getIterator());
+}
+
+BasicBlock::const_iterator
+BasicBlock::getInstIterator(const Instruction *I)
+{
+    return const_iterator(I->getIterator());
+}
+
 ////////////////////////////////////////////////////////////
 // Predecessors iterators
 BasicBlock::predecessor_iterator
@@ -128,7 +248,7 @@ BasicBlock::getBasicBlockName() const
 void
 BasicBlock::setBasicBlockName(const unknown::StringRef &BlockName)
 {
-    mBasicBlockName = BlockName;
+    mBasicBlockName = getContext().mImpl->internValueName(BlockName);
 }
 
 // Get the parent of this block
@@ -202,7 +322,7 @@ BasicBlock::getTerminator()
         return nullptr;
     }
 
-    return dynamic_cast<TerminatorInstruction *>(Inst);
+    return unknown::dyn_cast<TerminatorInstruction>(Inst);
 }
 
 // Get the terminator instruction of this block
@@ -220,7 +340,7 @@ BasicBlock::getTerminator() const
         return nullptr;
     }
 
-    return dynamic_cast<const TerminatorInstruction *>(Inst);
+    return unknown::dyn_cast<TerminatorInstruction>(Inst);
 }
 
 // Get the first predecessor of this block
@@ -237,6 +357,36 @@ BasicBlock::getFirstPredecessor() const
     return *predecessor_begin();
 }
 
+////////////////////////////////////////////////////////////
+// Order
+// Is this block before the other block of the same function?
+bool
+BasicBlock::comesBefore(const BasicBlock *Other) const
+{
+    assert(mParent && "BasicBlock has no parent!");
+    assert(Other->mParent == mParent && "Cross-function block order comparison!");
+
+    if (!mParent->isBlockOrderValid())
+    {
+        mParent->renumberBlocks();
+    }
+
+    return mOrder < Other->mOrder;
+}
+
+// Renumber the order indices of the instructions
+void
+BasicBlock::renumberInstructions() const
+{
+    uint32_t Order = 0;
+    for (auto &I : mInstList)
+    {
+        I.mOrder = Order++;
+    }
+
+    mInstOrderValid = true;
+}
+
 ////////////////////////////////////////////////////////////
 // Remove/Erase/Insert
 // Remove the block from the its parent, but does not delete it.
@@ -248,12 +398,7 @@ BasicBlock::removeFromParent()
         return;
     }
 
-    if (mParent->getBasicBlockList().empty())
-    {
-        return;
-    }
-
-    mParent->getBasicBlockList().remove(this);
+    mParent->remove(this);
 }
 
 // Remove the block from the its parent and delete it.
@@ -265,20 +410,7 @@ BasicBlock::eraseFromParent()
         return;
     }
 
-    if (mParent->getBasicBlockList().empty())
-    {
-        return;
-    }
-
-    for (auto It = mParent->getBasicBlockList().begin(); It != mParent->getBasicBlockList().end(); ++It)
-    {
-        if (*It == this)
-        {
-            mParent->getBasicBlockList().erase(It);
-            this->setParent(nullptr);
-            --It;
-        }
-    }
+    mParent->remove(this);
 }
 
 // Insert an unlinked BasicBlock into a function immediately before/after the specified BasicBlock.
@@ -290,22 +422,13 @@ BasicBlock::insertBeforeOrAfter(BasicBlock *InsertPos, bool Before)
         return;
     }
 
-    auto InsertPosIt = InsertPos->getParent()->getBasicBlockList().begin();
-    for (; InsertPosIt != InsertPos->getParent()->getBasicBlockList().end(); ++InsertPosIt)
+    auto InsertPosIt = Function::getBasicBlockIterator(InsertPos);
+    if (!Before)
     {
-        if (*InsertPosIt == InsertPos)
-        {
-            if (!Before)
-            {
-                ++InsertPosIt;
-            }
-
-            break;
-        }
+        ++InsertPosIt;
     }
 
-    InsertPos->getParent()->getBasicBlockList().insert(InsertPosIt, this);
-    this->setParent(InsertPos->getParent());
+    InsertPos->getParent()->insert(InsertPosIt, this);
 }
 
 // Insert an unlinked BasicBlock into a function immediately before the specified BasicBlock.
@@ -327,7 +450,6 @@ void
 BasicBlock::insertInst(Instruction *I)
 {
     push(I);
-    I->setParent(this);
 }
 
 // Drop all instructions in this block.
@@ -352,6 +474,14 @@ BasicBlock::dropAllReferences()
 // Clear all instructions in this block.
 void
 BasicBlock::clearAllInstructions()
+{
+    unknown::SmallPtrSet<Value *, 16> FreedOperands;
+    clearAllInstructions(FreedOperands);
+}
+
+// Clear all instructions in this block, the operands shared with other blocks are only freed once.
+void
+BasicBlock::clearAllInstructions(unknown::SmallPtrSetImpl<Value *> &FreedOperands)
 {
     if (empty())
     {
@@ -361,33 +491,28 @@ BasicBlock::clearAllInstructions()
     // Drop all instructions in this block
     dropAllReferences();
 
-    // Clear all operands
+    // Clear all operands, an operand shared by several instructions is freed once
     for (auto InstIt = begin(); InstIt != end(); ++InstIt)
     {
         auto Inst = *InstIt;
         if (Inst)
         {
-            Inst->clearAllOperands();
+            Inst->clearAllOperands(FreedOperands);
         }
     }
 
+    // Clear instruction list, the instructions are unlinked before they are freed
+    std::vector<Instruction *> InstList(begin(), end());
+    clear();
+
     // Free all instructions
-    std::vector<Instruction *> FreeInstList;
-    for (auto InstIt = begin(); InstIt != end(); ++InstIt)
+    for (auto Inst : InstList)
     {
-        auto Inst = *InstIt;
         if (Inst && Inst->user_empty())
         {
-            if (std::find(FreeInstList.begin(), FreeInstList.end(), Inst) == FreeInstList.end())
-            {
-                FreeInstList.push_back(Inst);
-                delete Inst;
-            }
+            delete Inst;
         }
     }
-
-    // Clear instruction list
-    clear();
 }
 
 ////////////////////////////////////////////////////////////
@@ -414,9 +539,8 @@ BasicBlock::getPropertyBB() const
 void
 BasicBlock::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the BasicBlock
@@ -432,31 +556,17 @@ BasicBlock::print(unknown::XMLPrinter &Printer) const
 
     // range
     {
-        auto Range =
-            std::format("0x{:X}", getBasicBlockAddressBegin()) + "-" + std::format("0x{:X}", getBasicBlockAddressEnd());
-        Printer.PushAttribute(getPropertyRange().data(), Range.c_str());
+        pushRangeAttribute(Printer, getPropertyRange().data(), getBasicBlockAddressBegin(), getBasicBlockAddressEnd());
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     // inst
@@ -479,7 +589,7 @@ BasicBlock::print(unknown::XMLPrinter &Printer) const
 std::string
 BasicBlock::generateOrderedBasicBlockName(Context &C)
 {
-    auto CurIdx = C.mImpl->mOrderedBlockNameIndex++;
+    auto CurIdx = C.mImpl->getFunctionNameIndex().mOrderedBlockNameIndex++;
     return std::to_string(CurIdx);
 }
 
@@ -487,7 +597,7 @@ BasicBlock::generateOrderedBasicBlockName(Context &C)
 BasicBlock *
 BasicBlock::get(Context &C)
 {
-    return new BasicBlock(C);
+    return construct<BasicBlock>(C, C);
 }
 
 // Creates a new BasicBlock.
@@ -506,7 +616,7 @@ BasicBlock::get(
     uint64_t BasicBlockAddressEnd,
     Function *Parent)
 {
-    return new BasicBlock(C, BasicBlockName, BasicBlockAddressBegin, BasicBlockAddressEnd, Parent);
+    return construct<BasicBlock>(C, C, BasicBlockName, BasicBlockAddressBegin, BasicBlockAddressEnd, Parent);
 }
 
 // Creates a new BasicBlock.
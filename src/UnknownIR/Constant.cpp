@@ -6,6 +6,7 @@
 #include <Internal/InternalErrors/InternalErrors.h>
 #include <Internal/InternalConfig/InternalConfig.h>
 
+#include <unknown/ADT/SmallString.h>
 #include <unknown/ADT/StringExtras.h>
 
 namespace uir {
@@ -14,8 +15,7 @@ namespace uir {
 //
 Constant::Constant(Type *Ty, const unknown::StringRef &ConstantName) : User(Ty, ConstantName)
 {
-    //
-    //
+    mValueID = ConstantVal;
 }
 
 Constant::~Constant()
@@ -30,16 +30,16 @@ Constant::~Constant()
 Constant *
 Constant::get(Type *Ty, const unknown::StringRef &ConstantName)
 {
-    return new Constant(Ty, ConstantName);
+    return construct<Constant>(Ty->getContext(), Ty, ConstantName);
 }
 
 ////////////////////////////////////////////////////////////
 //     ConstantInt
 //
-ConstantInt::ConstantInt(Type *Ty, const unknown::APInt &Val) : Constant(Ty, "0x" + Val.toString(16, false)), mVal(Val)
+ConstantInt::ConstantInt(Type *Ty, const unknown::APInt &Val) : Constant(Ty, ""), mVal(Val)
 {
-    //
-    //
+    mValueID = ConstantIntVal;
+    updateName();
 }
 
 ConstantInt::~ConstantInt()
@@ -73,6 +73,7 @@ void
 ConstantInt::setValue(const unknown::APInt &Val)
 {
     mVal = Val;
+    updateName();
 }
 
 // Return the bitwidth of this constant.
@@ -82,6 +83,16 @@ ConstantInt::getBitWidth() const
     return getValueBits();
 }
 
+// Name the constant after its value, it is uniqued, so this happens once per value and thread
+void
+ConstantInt::updateName()
+{
+    // 0x7B
+    unknown::SmallString<32> Name("0x");
+    mVal.toString(Name, 16, false);
+    setName(Name.c_str());
+}
+
 ////////////////////////////////////////////////////////////
 // Virtual functions
 // Get the readable name of this object
@@ -89,7 +100,7 @@ std::string
 ConstantInt::getReadableName() const
 {
     // 0x7b i32
-    std::string ReadableName = getName();
+    std::string ReadableName = getName().str();
     ReadableName += " ";
     ReadableName += mType->getTypeName();
 
@@ -102,16 +113,10 @@ ConstantInt::getReadableName() const
 ConstantInt *
 ConstantInt::get(Context &Context, const unknown::APInt &Val)
 {
-    ContextImpl *Impl = Context.mImpl;
-    ConstantInt *Slot = Impl->mIntConstants[Val];
-    if (Slot == nullptr)
-    {
-        // Get the corresponding integer type for the bit width of the value.
-        IntegerType *IntTy = IntegerType::get(Context, Val.getBitWidth());
-        Slot = new ConstantInt(IntTy, Val);
-    }
-    assert(Slot->getType() == IntegerType::get(Context, Val.getBitWidth()));
-    return Slot;
+    // One object per constant in the whole context, so constants built on different threads compare equal
+    ConstantInt *CI = Context.mImpl->mConstantInts.get(Context, Val);
+    assert(CI->getType() == IntegerType::get(Context, Val.getBitWidth()));
+    return CI;
 }
 
 // Get a ConstantInt from a value
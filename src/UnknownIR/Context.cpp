@@ -91,4 +91,21 @@ Context::getModeBits()
     return 64;
 }
 
+/////////////////////////////////////////////////////////
+// Arena
+// Allocate the memory of a value from the arena of the function being built on the current thread
+void *
+Context::allocate(size_t Size, size_t Alignment, uint32_t &ArenaID)
+{
+    // Only the arena of a function of this context is used
+    auto &Current = getCurrentValueArena();
+    if (Current.Impl != mImpl || Current.Arena == nullptr)
+    {
+        return nullptr;
+    }
+
+    ArenaID = Current.Arena->getID();
+    return Current.Arena->allocate(Size, Alignment);
+}
+
 } // namespace uir
@@ -1,4 +1,7 @@
 #include "ContextImpl.h"
+#include <atomic>
+
+#include <Constant.h>
 #include <Context.h>
 #include <Type.h>
 
@@ -7,12 +10,149 @@
 
 namespace uir {
 
+////////////////////////////////////////////////////////////
+//     ConstantIntTable
+//
+ConstantIntTable::~ConstantIntTable()
+{
+    clear();
+}
+
+// Get the uniqued constant, it is created on first use
+ConstantInt *
+ConstantIntTable::get(Context &C, const unknown::APInt &Val)
+{
+    // Flags, bytes and small offsets are looked up without hashing or locking
+    std::atomic<ConstantInt *> *SmallSlot = nullptr;
+    if (Val.ule(NumSmallConstantInts - 1))
+    {
+        uint32_t WidthIndex = NumSmallConstantIntWidths;
+        switch (Val.getBitWidth())
+        {
+        case 1:
+            WidthIndex = 0;
+            break;
+        case 8:
+            WidthIndex = 1;
+            break;
+        case 16:
+            WidthIndex = 2;
+            break;
+        case 32:
+            WidthIndex = 3;
+            break;
+        case 64:
+            WidthIndex = 4;
+            break;
+        default:
+            break;
+        }
+
+        if (WidthIndex < NumSmallConstantIntWidths)
+        {
+            SmallSlot = &mSmallConstantInts[WidthIndex][Val.getZExtValue()];
+            if (ConstantInt *CI = SmallSlot->load(std::memory_order_acquire))
+            {
+                return CI;
+            }
+        }
+    }
+
+    // The constants are created under the lock of their shard, so each one is created once
+    Shard &S = getShard(Val);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    if (SmallSlot)
+    {
+        ConstantInt *CI = SmallSlot->load(std::memory_order_relaxed);
+        if (CI == nullptr)
+        {
+            CI = new ConstantInt(IntegerType::get(C, Val.getBitWidth()), Val);
+            SmallSlot->store(CI, std::memory_order_release);
+        }
+
+        return CI;
+    }
+
+    // The constants are shared by every module, so they never live in a module arena
+    ConstantInt *&CI = S.ConstantInts[Val];
+    if (CI == nullptr)
+    {
+        CI = new ConstantInt(IntegerType::get(C, Val.getBitWidth()), Val);
+    }
+
+    return CI;
+}
+
+// Destroy the constants
+void
+ConstantIntTable::clear()
+{
+    for (auto &SmallConstantInts : mSmallConstantInts)
+    {
+        for (auto &CI : SmallConstantInts)
+        {
+            delete CI.exchange(nullptr);
+        }
+    }
+
+    for (auto &S : mShards)
+    {
+        std::lock_guard<std::mutex> Lock(S.Mutex);
+        for (auto &CI : S.ConstantInts)
+        {
+            delete CI.second;
+        }
+
+        S.ConstantInts.clear();
+    }
+}
+
+// Get the shard of a constant
+ConstantIntTable::Shard &
+ConstantIntTable::getShard(const unknown::APInt &Val)
+{
+    return mShards[unknown::DenseMapAPIntKeyInfo::getHashValue(Val) % NumShards];
+}
+
+////////////////////////////////////////////////////////////
+//     ValueNamePool
+//
+// Intern a name, the returned string lives as long as the pool
+const char *
+ValueNamePool::intern(unknown::StringRef Name)
+{
+    Shard &S = mShards[unknown::hash_value(Name) % NumShards];
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+
+    // The keys of the pool are null terminated
+    return S.Names.insert(Name).first->getKeyData();
+}
+
+////////////////////////////////////////////////////////////
+//     ValueArena
+//
+ValueArena::ValueArena() : mID(0)
+{
+    // The values keep the id of their arena, the ids are not reused so a value is never taken for one of a later arena
+    static std::atomic<uint32_t> NextID = 1;
+    mID = NextID++;
+}
+
+// Get the arena the current thread builds values in
+CurrentValueArena &
+getCurrentValueArena()
+{
+    thread_local CurrentValueArena Current;
+    return Current;
+}
+
+////////////////////////////////////////////////////////////
+//     ContextImpl
+//
 ContextImpl::ContextImpl(Context &C) :
     mContext(C),
-    mOrderedLocalVarNameIndex(0),
     mOrderedGlobalVarNameIndex(0),
     mOrderedFunctionNameIndex(0),
-    mOrderedBlockNameIndex(0),
     mVoidTy(C, "void", Type::VoidTyID, 0),
     mFloatTy(C, "float", Type::FloatTyID, 32),
     mDoubleTy(C, "double", Type::DoubleTyID, 64),
@@ -25,10 +165,14 @@ ContextImpl::ContextImpl(Context &C) :
     mInt64Ty(C, "i64", 64),
     mInt128Ty(C, "i128", 128)
 {
+    clearOrderedNameIndex();
 }
 
 ContextImpl::~ContextImpl()
 {
+    // The constants are destroyed while their types are still alive
+    mConstantInts.clear();
+
     clearOrderedNameIndex();
 
     for (auto &IntTy : mIntegerTypes)
@@ -50,26 +194,38 @@ ContextImpl::~ContextImpl()
 
         PtrTy.second = nullptr;
     }
-
-    for (auto &CI : mIntConstants)
-    {
-        if (CI.second)
-        {
-            delete CI.second;
-        }
-
-        CI.second = nullptr;
-    }
 }
 
 // Clear all the name index.
 void
 ContextImpl::clearOrderedNameIndex()
 {
-    mOrderedLocalVarNameIndex = 0;
     mOrderedGlobalVarNameIndex = 0;
     mOrderedFunctionNameIndex = 0;
-    mOrderedBlockNameIndex = 0;
+    clearFunctionNameIndex();
+}
+
+// Clear the name index of the function being built on the current thread.
+void
+ContextImpl::clearFunctionNameIndex()
+{
+    getFunctionNameIndex() = FunctionNameIndex{};
+}
+
+// Get the name index of the function being built on the current thread.
+ContextImpl::FunctionNameIndex &
+ContextImpl::getFunctionNameIndex()
+{
+    // Each thread numbers the blocks and locals of its own function
+    thread_local std::unordered_map<const ContextImpl *, FunctionNameIndex> NameIndexMap;
+    return NameIndexMap[this];
+}
+
+// Intern a value name, the returned string lives as long as this context.
+const char *
+ContextImpl::internValueName(unknown::StringRef Name)
+{
+    return mValueNames.intern(Name);
 }
 
 } // namespace uir
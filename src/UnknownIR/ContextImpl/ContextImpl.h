@@ -1,17 +1,150 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include <string>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <Type.h>
 
 #include <UnknownUtils/unknown/ADT/APInt.h>
+#include <UnknownUtils/unknown/ADT/DenseMap.h>
+#include <UnknownUtils/unknown/ADT/Hashing.h>
+#include <UnknownUtils/unknown/ADT/StringSet.h>
+#include <UnknownUtils/unknown/Support/Allocator.h>
+
+namespace unknown {
+
+// Hash an APInt by its bit width and value, so constants of different widths never compare
+struct DenseMapAPIntKeyInfo
+{
+    static inline APInt getEmptyKey()
+    {
+        APInt V(nullptr, 0);
+        V.U.VAL = 0;
+        return V;
+    }
+
+    static inline APInt getTombstoneKey()
+    {
+        APInt V(nullptr, 0);
+        V.U.VAL = 1;
+        return V;
+    }
+
+    static unsigned getHashValue(const APInt &Key) { return static_cast<unsigned>(hash_value(Key)); }
+
+    static bool isEqual(const APInt &LHS, const APInt &RHS)
+    {
+        return LHS.getBitWidth() == RHS.getBitWidth() && LHS == RHS;
+    }
+};
+
+} // namespace unknown
 
 namespace uir {
 
 class Context;
+class ContextImpl;
 class ConstantInt;
+class Value;
+
+// The widths of the small constants looked up without hashing
+static constexpr uint32_t NumSmallConstantIntWidths = 5;
+static constexpr uint64_t NumSmallConstantInts = 256;
+
+// The uniqued integer constants of a context, one object per (BitWidth, Value) shared by all threads.
+// The small constants are read without locking, the others are spread over shards so the threads rarely wait.
+class ConstantIntTable
+{
+private:
+    static constexpr size_t NumShards = 16;
+
+    // The constants of one shard and the lock of its slots
+    struct Shard
+    {
+        std::mutex Mutex;
+        unknown::DenseMap<unknown::APInt, ConstantInt *, unknown::DenseMapAPIntKeyInfo> ConstantInts;
+    };
+
+    // [WidthIndex][Value], the constants 0..255 of i1/i8/i16/i32/i64
+    std::atomic<ConstantInt *> mSmallConstantInts[NumSmallConstantIntWidths][NumSmallConstantInts] = {};
+
+    // [(BitWidth, Value), ConstantInt], all other constants
+    Shard mShards[NumShards];
+
+public:
+    ConstantIntTable() = default;
+    ~ConstantIntTable();
+
+public:
+    // Get the uniqued constant, it is created on first use
+    ConstantInt *get(Context &C, const unknown::APInt &Val);
+
+    // Destroy the constants
+    void clear();
+
+private:
+    // Get the shard of a constant
+    Shard &getShard(const unknown::APInt &Val);
+};
+
+// The pool of the value names of a context, a name is stored once however many values share it.
+// The names are spread over shards, so the threads building functions rarely wait on each other.
+class ValueNamePool
+{
+private:
+    static constexpr size_t NumShards = 16;
+
+    // The names of one shard and the lock of its set
+    struct Shard
+    {
+        std::mutex Mutex;
+        unknown::StringSet<unknown::BumpPtrAllocator> Names;
+    };
+
+    Shard mShards[NumShards];
+
+public:
+    // Intern a name, the returned string lives as long as the pool
+    const char *intern(unknown::StringRef Name);
+};
+
+// The arena of the values built for one function, see Function::ArenaScope.
+// A function is built by one thread at a time, so the arena needs no lock.
+class ValueArena
+{
+private:
+    // The id stored in the values allocated from this arena, 0 is the heap
+    uint32_t mID;
+
+    unknown::BumpPtrAllocator mAllocator;
+
+public:
+    ValueArena();
+
+public:
+    // Get the id of this arena
+    uint32_t getID() const { return mID; }
+
+    // Allocate the memory of a value
+    void *allocate(size_t Size, size_t Alignment) { return mAllocator.Allocate(Size, Alignment); }
+
+    // Get the number of bytes allocated from this arena
+    size_t getBytesAllocated() const { return mAllocator.getBytesAllocated(); }
+};
+
+// The arena the current thread builds values in, the one of the innermost Function::ArenaScope
+struct CurrentValueArena
+{
+    ContextImpl *Impl = nullptr;
+    ValueArena *Arena = nullptr;
+};
+
+// Get the arena the current thread builds values in
+CurrentValueArena &getCurrentValueArena();
 
 class ContextImpl
 {
@@ -19,11 +152,16 @@ private:
     Context &mContext;
 
 public:
+    // Ordered index of the function being built on one thread
+    struct FunctionNameIndex
+    {
+        uint64_t mOrderedLocalVarNameIndex = 0;
+        uint64_t mOrderedBlockNameIndex = 0;
+    };
+
     // Ordered index
-    uint64_t mOrderedLocalVarNameIndex;
     uint64_t mOrderedGlobalVarNameIndex;
     uint64_t mOrderedFunctionNameIndex;
-    uint64_t mOrderedBlockNameIndex;
 
     // Basic type instances
     Type mVoidTy;
@@ -40,14 +178,32 @@ public:
     IntegerType mInt64Ty;
     IntegerType mInt128Ty;
 
-    // IntegerTypes map
-    std::unordered_map<uint32_t, IntegerType *> mIntegerTypes;
+    // [NumBits, IntegerType], the widths without a built-in type
+    unknown::DenseMap<uint32_t, IntegerType *> mIntegerTypes;
 
     // PointerType map
     std::unordered_map<Type *, PointerType *> mPointerTypes;
 
-    // IntConstants map
-    std::map<unknown::APInt, ConstantInt *> mIntConstants;
+    // The comment and extra info of a value, most values have neither
+    struct ValueAnnotation
+    {
+        std::vector<std::string> ExtraInfoList;
+        std::string Comment;
+    };
+
+    // [ArenaID, [Value, Annotation]], only the values with mHasAnnotation have an entry.
+    // The entries are grouped by arena, so the ones of a released arena are erased in one step.
+    std::unordered_map<uint32_t, std::unordered_map<const Value *, ValueAnnotation>> mValueAnnotations;
+
+    // The pool of the value names
+    ValueNamePool mValueNames;
+
+    // Functions may be built on several threads at once
+    std::mutex mTypesMutex;
+    std::mutex mValueAnnotationsMutex;
+
+    // The uniqued integer constants
+    ConstantIntTable mConstantInts;
 
 public:
     explicit ContextImpl(Context &C);
@@ -56,6 +212,15 @@ public:
 public:
     // Clear all the name index.
     void clearOrderedNameIndex();
+
+    // Clear the name index of the function being built on the current thread.
+    void clearFunctionNameIndex();
+
+    // Get the name index of the function being built on the current thread.
+    FunctionNameIndex &getFunctionNameIndex();
+
+    // Intern a value name, the returned string lives as long as this context.
+    const char *internValueName(unknown::StringRef Name);
 };
 
 } // namespace uir
\ No newline at end of file
@@ -12,6 +12,7 @@ namespace uir {
 //
 FlagsVariable::FlagsVariable(Type *Ty) : LocalVariable(Ty, "flags", 0)
 {
+    mValueID = FlagsVariableVal;
     mFlags.FlagsValue = 0;
 }
 
@@ -93,18 +94,81 @@ FlagsVariable::setOverflowFlag(bool Set)
     mFlags.OverflowFlag = Set ? 1 : 0;
 }
 
+FlagsVariable::ConditionKind
+FlagsVariable::getCondition() const
+{
+    return static_cast<ConditionKind>(mFlags.Condition);
+}
+
+void
+FlagsVariable::setCondition(ConditionKind Condition)
+{
+    mFlags.FlagsValue = 0;
+    mFlags.Condition = static_cast<uint8_t>(Condition);
+
+    switch (Condition)
+    {
+    case ConditionKind::Above:
+    case ConditionKind::BelowOrEqual:
+        setCarryFlag();
+        setZeroFlag();
+        break;
+    case ConditionKind::AboveOrEqual:
+    case ConditionKind::Below:
+        setCarryFlag();
+        break;
+    case ConditionKind::Equal:
+    case ConditionKind::NotEqual:
+        setZeroFlag();
+        break;
+    case ConditionKind::Greater:
+    case ConditionKind::LessOrEqual:
+        setZeroFlag();
+        setSignFlag();
+        setOverflowFlag();
+        break;
+    case ConditionKind::GreaterOrEqual:
+    case ConditionKind::Less:
+        setSignFlag();
+        setOverflowFlag();
+        break;
+    case ConditionKind::Overflow:
+    case ConditionKind::NotOverflow:
+        setOverflowFlag();
+        break;
+    case ConditionKind::Parity:
+    case ConditionKind::NotParity:
+        setParityFlag();
+        break;
+    case ConditionKind::Sign:
+    case ConditionKind::NotSign:
+        setSignFlag();
+        break;
+    default:
+        break;
+    }
+}
+
 ////////////////////////////////////////////////////////////
 // Static
 FlagsVariable *
 FlagsVariable::get(Type *Ty)
 {
-    return new FlagsVariable(Ty);
+    return construct<FlagsVariable>(Ty->getContext(), Ty);
 }
 
 FlagsVariable *
 FlagsVariable::get(Context &C)
 {
-    return new FlagsVariable(C);
+    return construct<FlagsVariable>(C, C);
+}
+
+FlagsVariable *
+FlagsVariable::get(Context &C, ConditionKind Condition)
+{
+    auto FlagsVar = get(C);
+    FlagsVar->setCondition(Condition);
+    return FlagsVar;
 }
 
 } // namespace uir
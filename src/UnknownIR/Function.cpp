@@ -2,12 +2,17 @@
 #include <BasicBlock.h>
 #include <Argument.h>
 #include <FunctionContext.h>
+#include <GlobalVariable.h>
 #include <Module.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
+
+#include <unknown/ADT/SmallPtrSet.h>
 
 namespace uir {
 
@@ -27,19 +32,121 @@ Function::Function(
     mFunctionAddressEnd(FunctionAddressEnd),
     mHasSEH(false),
     mHasAsyncEH(false),
-    mHasNaked(false)
+    mHasNaked(false),
+    mBlockOrderValid(true)
 {
-    // Clear ordered block name index.
-    C.mImpl->mOrderedBlockNameIndex = 0;
+    mValueID = FunctionVal;
 
-    // Clear ordered local variable name index.
-    C.mImpl->mOrderedLocalVarNameIndex = 0;
+    // Clear ordered block and local variable name index.
+    C.mImpl->clearFunctionNameIndex();
 }
 
 Function::~Function()
 {
+    // The blocks of the arena are dropped in one step, the ones on the heap are cleared one by one
+    dropArenaValues();
+
     // Clear all basic blocks.
     clearAllBasicBlock();
+
+    // The blocks no longer use the owned global variables
+    for (auto GV : mOwnedGlobalVariables)
+    {
+        delete GV;
+    }
+
+    if (mArena)
+    {
+        // The annotations of the arena values are erased in one step, then their memory is released
+        ContextImpl *Impl = getContext().mImpl;
+        {
+            std::lock_guard<std::mutex> Lock(Impl->mValueAnnotationsMutex);
+            Impl->mValueAnnotations.erase(mArena->getID());
+        }
+
+        mArena.reset();
+    }
+}
+
+////////////////////////////////////////////////////////////
+// BasicBlocksList
+// Insert a block at the end of this function
+void
+Function::push_back(BasicBlock *BB)
+{
+    assert(BB && "BB != nullptr");
+
+    // Appending keeps the order valid
+    if (mBlockOrderValid)
+    {
+        BB->mOrder = mBasicBlocksList.empty() ? 0 : mBasicBlocksList.back().mOrder + 1;
+    }
+
+    mBasicBlocksList.push_back(*BB);
+    BB->setParent(this);
+}
+
+// Insert a block before the specified position
+Function::iterator
+Function::insert(iterator It, BasicBlock *BB)
+{
+    assert(BB && "BB != nullptr");
+
+    if (It == end())
+    {
+        push_back(BB);
+        return iterator(BB->getIterator());
+    }
+
+    invalidateBlockOrders();
+    BB->setParent(this);
+    return iterator(mBasicBlocksList.insert(It.getNodeIterator(), *BB));
+}
+
+// Remove the block at the specified position, but does not delete it
+Function::iterator
+Function::erase(iterator It)
+{
+    auto BB = *It;
+    auto Next = iterator(mBasicBlocksList.erase(It.getNodeIterator()));
+    BB->setParent(nullptr);
+    return Next;
+}
+
+// Remove a block of this function, but does not delete it
+void
+Function::remove(BasicBlock *BB)
+{
+    assert(BB && BB->getParent() == this && "BasicBlock is not in this function!");
+
+    // Removing keeps the order valid
+    mBasicBlocksList.remove(*BB);
+    BB->setParent(nullptr);
+}
+
+// Remove all blocks, but does not delete them
+void
+Function::clear()
+{
+    for (auto It = begin(); It != end();)
+    {
+        It = erase(It);
+    }
+
+    mBlockOrderValid = true;
+}
+
+// Get the iterator of a block in this function
+Function::iterator
+Function::getBasicBlockIterator(BasicBlock *BB)
+{
+    return iterator(BB->getIterator());
+}
+
+Function::const_iterator
+Function::getBasicBlockIterator(const BasicBlock *BB)
+{
+    return const_iterator(BB->getIterator());
 }
 
 ////////////////////////////////////////////////////////////
@@ -175,6 +282,21 @@ Function::setNaked(bool HasNaked)
     mHasNaked = HasNaked;
 }
 
+////////////////////////////////////////////////////////////
+// Order
+// Renumber the order indices of the blocks
+void
+Function::renumberBlocks() const
+{
+    uint32_t Order = 0;
+    for (auto &BB : mBasicBlocksList)
+    {
+        BB.mOrder = Order++;
+    }
+
+    mBlockOrderValid = true;
+}
+
 ////////////////////////////////////////////////////////////
 // Function Attribute
 // Add function attribute to this function.
@@ -261,7 +383,6 @@ void
 Function::insertBasicBlock(BasicBlock *BB)
 {
     push_back(BB);
-    BB->setParent(this);
 }
 
 // Insert a new arg to this function
@@ -280,6 +401,13 @@ Function::insertFunctionContext(FunctionContext *FC)
     FC->setParent(this);
 }
 
+// Give a global variable that is not in a module to this function, it is freed with the function
+void
+Function::insertOwnedGlobalVariable(GlobalVariable *GV)
+{
+    mOwnedGlobalVariables.push_back(GV);
+}
+
 // Drop all blocks in this function.
 void
 Function::dropAllReferences()
@@ -320,73 +448,178 @@ Function::dropAllReferences()
 void
 Function::clearAllBasicBlock()
 {
-    if (empty())
+    // The blocks of the arena may already be dropped, the arguments and the function contexts are still freed
+    if (!empty())
     {
-        return;
-    }
+        // Drop all blocks in this function
+        dropAllReferences();
 
-    // Drop all blocks in this function
-    dropAllReferences();
-
-    // Clear all basic blocks
-    for (auto BB : *this)
-    {
-        if (BB)
+        // Clear all basic blocks, the operands shared by the blocks are freed once
+        unknown::SmallPtrSet<Value *, 16> FreedOperands;
+        for (auto BB : *this)
         {
-            BB->clearAllInstructions();
+            if (BB)
+            {
+                BB->clearAllInstructions(FreedOperands);
+            }
         }
-    }
 
-    // Free all basic blocks
-    std::vector<BasicBlock *> FreeBBList;
-    for (auto BB : *this)
-    {
-        if (BB && BB->user_empty())
+        // Free all basic blocks, the blocks are unlinked before they are freed
+        std::vector<BasicBlock *> BBList(begin(), end());
+        clear();
+        for (auto BB : BBList)
         {
-            if (std::find(FreeBBList.begin(), FreeBBList.end(), BB) == FreeBBList.end())
+            if (BB && BB->user_empty())
             {
-                FreeBBList.push_back(BB);
                 delete BB;
             }
         }
     }
 
     // Free all args
-    std::vector<Argument *> FreeArgsList;
+    unknown::SmallPtrSet<Argument *, 16> FreeArgsList;
     for (auto ArgIt = arg_begin(); ArgIt != arg_end(); ++ArgIt)
     {
         auto Arg = *ArgIt;
         if (Arg && Arg->user_empty())
         {
-            if (std::find(FreeArgsList.begin(), FreeArgsList.end(), Arg) == FreeArgsList.end())
+            if (FreeArgsList.insert(Arg).second)
             {
-                FreeArgsList.push_back(Arg);
                 delete Arg;
             }
         }
     }
 
     // Free all FCs
-    std::vector<FunctionContext *> FreeFCsList;
+    unknown::SmallPtrSet<FunctionContext *, 16> FreeFCsList;
     for (auto FCIt = fc_begin(); FCIt != fc_end(); ++FCIt)
     {
         auto FC = *FCIt;
         if (FC && FC->user_empty())
         {
-            if (std::find(FreeFCsList.begin(), FreeFCsList.end(), FC) == FreeFCsList.end())
+            if (FreeFCsList.insert(FC).second)
             {
-                FreeFCsList.push_back(FC);
                 delete FC;
             }
         }
     }
 
     // Clear list
-    clear();
     arg_clear();
     fc_clear();
 }
 
+////////////////////////////////////////////////////////////
+// Arena
+Function::ArenaScope::ArenaScope(Function &F)
+{
+    if (!F.mArena)
+    {
+        F.mArena = std::make_unique<ValueArena>();
+    }
+
+    auto &Current = getCurrentValueArena();
+    mPrevImpl = Current.Impl;
+    mPrevArena = Current.Arena;
+    Current.Impl = F.getContext().mImpl;
+    Current.Arena = F.mArena.get();
+}
+
+Function::ArenaScope::~ArenaScope()
+{
+    auto &Current = getCurrentValueArena();
+    Current.Impl = mPrevImpl;
+    Current.Arena = mPrevArena;
+}
+
+// Get the number of bytes allocated from the arena of this function
+size_t
+Function::getArenaBytesAllocated() const
+{
+    return mArena ? mArena->getBytesAllocated() : 0;
+}
+
+// Drop the blocks of the arena in one step
+bool
+Function::dropArenaValues()
+{
+    if (!mArena)
+    {
+        return false;
+    }
+
+    // A block or an instruction on the heap must be destroyed, so the function is then cleared one value at a time
+    const uint32_t ArenaID = mArena->getID();
+    for (auto &BB : mBasicBlocksList)
+    {
+        if (BB.getArenaID() != ArenaID)
+        {
+            return false;
+        }
+
+        for (auto &I : BB.mInstList)
+        {
+            if (I.getArenaID() != ArenaID)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (auto &BB : mBasicBlocksList)
+    {
+        for (auto &I : BB.mInstList)
+        {
+            // The uses of the arena values are released with them, only the values outside of the arena are unlinked.
+            // The operands that are left without users are freed as clearAllOperands does.
+            for (auto &U : I.getOperandList())
+            {
+                Value *OP = U.get();
+                if (OP == nullptr || OP->getArenaID() == ArenaID)
+                {
+                    continue;
+                }
+
+                U.unlink();
+                if (OP->user_empty() && Instruction::isOwnedOperand(OP))
+                {
+                    delete OP;
+                }
+            }
+
+            // The flags/stack variables outside of the arena are freed with their instruction
+            if (auto FV = I.getFlagsVariable(); FV && FV->getArenaID() != ArenaID)
+            {
+                I.setFlagsVariable(nullptr);
+            }
+
+            if (auto SV = I.getStackVariable(); SV && SV->getArenaID() != ArenaID)
+            {
+                I.setStackVariable(nullptr);
+            }
+
+            // The storage of the lists is the only memory of the arena values on the heap
+            if (I.getOperandList().capacity() > User::NumInlineOperands)
+            {
+                User::OperandListType Operands(std::move(I.getOperandList()));
+            }
+
+            if (auto TI = unknown::dyn_cast<TerminatorInstruction>(&I))
+            {
+                TerminatorInstruction::SuccessorsListType().swap(TI->getSuccessorsList());
+            }
+        }
+
+        BasicBlock::PredecessorsListType().swap(BB.mPredecessorsList);
+    }
+
+    // The nodes are released with the arena
+    mBasicBlocksList.clear();
+    mBlockOrderValid = true;
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////
 // Static
 // Generate a new function name by order
@@ -442,9 +675,8 @@ Function::getPropertyContext() const
 void
 Function::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the function
@@ -460,52 +692,37 @@ Function::print(unknown::XMLPrinter &Printer) const
 
     // range
     {
-        auto Range =
-            std::format("0x{:X}", getFunctionBeginAddress()) + "-" + std::format("0x{:X}", getFunctionEndAddress());
-        Printer.PushAttribute(getPropertyRange().data(), Range.c_str());
+        pushRangeAttribute(Printer, getPropertyRange().data(), getFunctionBeginAddress(), getFunctionEndAddress());
     }
 
     // attributes
     {
-        std::stringstream SS;
-        for (auto It = attr_begin(); It != attr_end(); ++It)
-        {
-            auto Attr = *It;
-            if (Attr.empty())
+        pushPrintedAttribute(Printer, getPropertyAttributes().data(), [this](unknown::raw_ostream &OS) {
+            for (auto It = attr_begin(); It != attr_end(); ++It)
             {
-                continue;
+                auto Attr = *It;
+                if (Attr.empty())
+                {
+                    continue;
+                }
+
+                OS << Attr;
+                if (Attr != attr_back())
+                {
+                    OS << UIR_SEPARATOR;
+                }
             }
-
-            SS << Attr;
-            if (Attr != attr_back())
-            {
-                SS << UIR_SEPARATOR;
-            }
-        }
-
-        Printer.PushAttribute(getPropertyAttributes().data(), SS.str().c_str());
+        });
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     // arguments
@@ -554,6 +771,7 @@ Function::get(
     uint64_t FunctionAddressBegin,
     uint64_t FunctionAddressEnd)
 {
+    // A function owns its own arena, so it never lives in the arena of another one
     return new Function(C, FunctionName, Parent, FunctionAddressBegin, FunctionAddressEnd);
 }
 
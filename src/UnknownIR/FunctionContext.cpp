@@ -1,10 +1,12 @@
 #include <FunctionContext.h>
 #include <Function.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
 
 namespace uir {
 
@@ -14,8 +16,7 @@ namespace uir {
 FunctionContext::FunctionContext(Type *Ty, const unknown::StringRef &CtxName, Function *F, uint32_t CtxNo) :
     Constant(Ty, CtxName), mParent(F), mCtxNo(CtxNo)
 {
-    //
-    //
+    mValueID = FunctionContextVal;
 }
 
 FunctionContext::~FunctionContext()
@@ -124,9 +125,8 @@ FunctionContext::getPropertyFCNo() const
 void
 FunctionContext::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the fc
@@ -142,29 +142,17 @@ FunctionContext::print(unknown::XMLPrinter &Printer) const
 
     // ctxno
     {
-        Printer.PushAttribute(getPropertyFCNo().data(), std::format("{}", mCtxNo).c_str());
+        Printer.PushAttribute(getPropertyFCNo().data(), mCtxNo);
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     Printer.CloseElement();
@@ -175,7 +163,7 @@ FunctionContext::print(unknown::XMLPrinter &Printer) const
 FunctionContext *
 FunctionContext::get(Type *Ty, const unknown::StringRef &CtxName, Function *F, uint32_t CtxNo)
 {
-    return new FunctionContext(Ty, CtxName, F, CtxNo);
+    return construct<FunctionContext>(Ty->getContext(), Ty, CtxName, F, CtxNo);
 }
 
 } // namespace uir
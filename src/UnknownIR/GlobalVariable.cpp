@@ -1,10 +1,12 @@
 #include <GlobalVariable.h>
 #include <Module.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
 
 namespace uir {
 
@@ -24,8 +26,7 @@ GlobalVariable::GlobalVariable(
     Module *Parent) :
     Constant(Ty, GlobalVariableName), mGlobalVariableAddress(GlobalVariableAddress), mParent(Parent)
 {
-    //
-    //
+    mValueID = GlobalVariableVal;
 }
 
 GlobalVariable::~GlobalVariable()
@@ -115,7 +116,7 @@ GlobalVariable::getReadableName() const
 {
     // %global i32
     std::string ReadableName = UIR_GLOBAL_VARIABLE_NAME_PREFIX;
-    ReadableName += mValueName;
+    ReadableName += getName();
     ReadableName += " ";
     ReadableName += mType->getTypeName();
 
@@ -133,9 +134,8 @@ GlobalVariable::getPropertyGV() const
 void
 GlobalVariable::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the gv
@@ -151,29 +151,17 @@ GlobalVariable::print(unknown::XMLPrinter &Printer) const
 
     // addr
     {
-        Printer.PushAttribute(getPropertyAddr().data(), std::format("0x{:X}", getGlobalVariableAddress()).c_str());
+        pushHexAttribute(Printer, getPropertyAddr().data(), getGlobalVariableAddress());
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     Printer.CloseElement();
@@ -193,6 +181,7 @@ GlobalVariable::generateOrderedGlobalVarName(Context &C)
 GlobalVariable *
 GlobalVariable::get(Type *Ty, const unknown::StringRef &GlobalVariableName, uint64_t GlobalVariableAddress)
 {
+    // The globals belong to the module, so they never live in the arena of a function
     return new GlobalVariable(Ty, GlobalVariableName, GlobalVariableAddress);
 }
 
@@ -16,13 +16,9 @@ IRBuilderDefaultInserter::InsertHelper(
         I->setInstructionAddress(InstAddress);
     }
 
-    if (BB)
+    if (BB && I)
     {
-        BB->getInstList().insert(InsertPt, I);
-        if (I)
-        {
-            I->setParent(BB);
-        }
+        BB->insert(InsertPt, I);
     }
 }
 
@@ -82,15 +78,7 @@ IRBuilderBase::setInsertPoint(Instruction *I)
     assert(BB != nullptr && "BB != nullptr");
 
     mBB = BB;
-
-    for (auto It = BB->begin(); It != BB->end(); ++It)
-    {
-        if ((*It) == I)
-        {
-            mInsertPt = It;
-            return;
-        }
-    }
+    mInsertPt = BasicBlock::getInstIterator(I);
 }
 
 void
@@ -157,6 +145,19 @@ IRBuilder::createJmpBB(BasicBlock *DestBB, uint64_t InstAddress)
     return insert(JmpBBInstruction::get(getContext(), DestBB), InstAddress);
 }
 
+// Jcc
+JccAddrInstruction *
+IRBuilder::createJccAddr(ConstantInt *JccDest, ConstantInt *JccNormal, FlagsVariable *FlagsVar, uint64_t InstAddress)
+{
+    return insert(JccAddrInstruction::get(getContext(), JccDest, JccNormal, FlagsVar), InstAddress);
+}
+
+JccBBInstruction *
+IRBuilder::createJccBB(BasicBlock *JccDestBB, BasicBlock *JccNormalBB, FlagsVariable *FlagsVar, uint64_t InstAddress)
+{
+    return insert(JccBBInstruction::get(getContext(), JccDestBB, JccNormalBB, FlagsVar), InstAddress);
+}
+
 // Load
 LoadInstruction *
 IRBuilder::createLoad(Value *Ptr, uint64_t InstAddress)
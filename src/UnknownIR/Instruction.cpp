@@ -5,10 +5,13 @@
 #include <Function.h>
 #include <Argument.h>
 #include <FunctionContext.h>
+#include <XMLStreamPrinter.h>
 
 #include <Internal/InternalErrors/InternalErrors.h>
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
 
+#include <unknown/ADT/SmallPtrSet.h>
 #include <unknown/ADT/StringExtras.h>
 
 namespace uir {
@@ -30,64 +33,23 @@ Instruction::Instruction(OpCodeID OpCodeId, Type *Ty) :
     mOpCodeID(OpCodeId),
     mInstructionAddress(0),
     mParent(nullptr),
-    mFlagsVariable(nullptr),
-    mStackVariable(nullptr),
-    mEnablePrintOp(false)
+    mEnablePrintOp(false),
+    mFlagsVariableUse(this),
+    mStackVariableUse(this),
+    mOrder(0)
 {
-    if (mFlagsVariable)
-    {
-        mFlagsVariable->user_insert(this);
-    }
-
-    if (mStackVariable)
-    {
-        mStackVariable->user_insert(this);
-    }
+    mValueID = InstructionVal;
 }
 
 Instruction::~Instruction()
 {
-    if (mFlagsVariable)
-    {
-        mFlagsVariable->user_erase(this);
-    }
-
-    if (mStackVariable)
-    {
-        mStackVariable->user_erase(this);
-    }
+    // Free the flags/stack variables
+    setFlagsVariable(nullptr);
+    setStackVariable(nullptr);
 }
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-Instruction::getOpcodeName() const
-{
-    return UnknownComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-Instruction::getDefaultNumberOfOperands() const
-{
-    return UnknownComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-Instruction::hasResult() const
-{
-    return UnknownComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-Instruction::hasFlags() const
-{
-    return UnknownComponent.mHasFlags;
-}
-
 // Get the property 'inst' of the value
 unknown::StringRef
 Instruction::getPropertyInst() const
@@ -120,9 +82,8 @@ Instruction::getPropertyOpCode() const
 void
 Instruction::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the full instruction
@@ -133,37 +94,22 @@ Instruction::print(unknown::XMLPrinter &Printer) const
 
     // addr
     {
-        Printer.PushAttribute(getPropertyAddr().data(), std::format("0x{:X}", getInstructionAddress()).c_str());
+        pushHexAttribute(Printer, getPropertyAddr().data(), getInstructionAddress());
     }
 
     // name
     {
-        std::string Name("");
-        unknown::raw_string_ostream OSName(Name);
-        printInst(OSName);
-        Printer.PushAttribute(getPropertyName().data(), OSName.str().c_str());
+        pushPrintedAttribute(Printer, getPropertyName().data(), [this](unknown::raw_ostream &OS) { printInst(OS); });
     }
 
     // extra
     {
-        std::string Extra("");
-        unknown::raw_string_ostream OSExtra(Extra);
-        printExtraInfo(OSExtra);
-        if (!OSExtra.str().empty())
-        {
-            Printer.PushAttribute(getPropertyExtra().data(), OSExtra.str().c_str());
-        }
+        pushExtraAttribute(Printer);
     }
 
     // comment
     {
-        std::string Comment("");
-        unknown::raw_string_ostream OSComment(Comment);
-        printCommentInfo(OSComment);
-        if (!OSComment.str().empty())
-        {
-            Printer.PushAttribute(getPropertyComment().data(), OSComment.str().c_str());
-        }
+        pushCommentAttribute(Printer);
     }
 
     // op
@@ -242,13 +188,6 @@ Instruction::setParent(BasicBlock *BB)
     mParent = BB;
 }
 
-// Get the opcode of this instruction
-const OpCodeID
-Instruction::getOpCodeID() const
-{
-    return mOpCodeID;
-}
-
 // Set the opcode of this instruction
 void
 Instruction::setOpCodeID(OpCodeID OpCodeId)
@@ -260,108 +199,86 @@ Instruction::setOpCodeID(OpCodeID OpCodeId)
 const FlagsVariable *
 Instruction::getFlagsVariable() const
 {
-    return mFlagsVariable.get();
+    return static_cast<const FlagsVariable *>(mFlagsVariableUse.get());
 }
 
 // Get the flags variable of this instruction
 FlagsVariable *
 Instruction::getFlagsVariable()
 {
-    return mFlagsVariable.get();
+    return static_cast<FlagsVariable *>(mFlagsVariableUse.get());
 }
 
 // Set the flags variable of this instruction
 void
 Instruction::setFlagsVariable(std::unique_ptr<FlagsVariable> &&FV)
 {
-    mFlagsVariable = std::move(FV);
+    setFlagsVariable(FV.release());
 }
 
-// Set the flags variable of this instruction
+// Set the flags variable of this instruction, the previous one is freed
 void
 Instruction::setFlagsVariable(FlagsVariable *FV)
 {
-    setFlagsVariable(std::unique_ptr<FlagsVariable>(FV));
+    auto OldFV = getFlagsVariable();
+    if (OldFV == FV)
+    {
+        return;
+    }
+
+    mFlagsVariableUse.set(FV);
+    delete OldFV;
 }
 
 // Set the flags variable of this instruction and update its users
 void
 Instruction::setFlagsVariableAndUpdateUsers(FlagsVariable *FV)
 {
-    if (mFlagsVariable.get() == FV)
-    {
-        return;
-    }
-
-    auto OldFlagsVariable = mFlagsVariable.get();
-
-    // Set the new flags variable
+    // The use of the flags variable is updated with it
     setFlagsVariable(FV);
-
-    // Update its users
-    if (OldFlagsVariable)
-    {
-        OldFlagsVariable->user_erase(this);
-    }
-
-    if (FV)
-    {
-        FV->user_insert(this);
-    }
 }
 
 // Get the stack variable of this instruction
 const LocalVariable *
 Instruction::getStackVariable() const
 {
-    return mStackVariable.get();
+    return static_cast<const LocalVariable *>(mStackVariableUse.get());
 }
 
 // Get the stack variable of this instruction
 LocalVariable *
 Instruction::getStackVariable()
 {
-    return mStackVariable.get();
+    return static_cast<LocalVariable *>(mStackVariableUse.get());
 }
 
 // Set the stack variable of this instruction
 void
 Instruction::setStackVariable(std::unique_ptr<LocalVariable> &&SV)
 {
-    mStackVariable = std::move(SV);
+    setStackVariable(SV.release());
 }
 
-// Set the stack variable of this instruction
+// Set the stack variable of this instruction, the previous one is freed
 void
 Instruction::setStackVariable(LocalVariable *SV)
 {
-    setStackVariable(std::unique_ptr<LocalVariable>(SV));
+    auto OldSV = getStackVariable();
+    if (OldSV == SV)
+    {
+        return;
+    }
+
+    mStackVariableUse.set(SV);
+    delete OldSV;
 }
 
 // Set the stack variable of this instruction and update its users
 void
 Instruction::setStackVariableAndUpdateUsers(LocalVariable *SV)
 {
-    if (mStackVariable.get() == SV)
-    {
-        return;
-    }
-
-    auto OldStackVariable = mStackVariable.get();
-
-    // Set the new variable
+    // The use of the stack variable is updated with it
     setStackVariable(SV);
-
-    // Update its users
-    if (OldStackVariable)
-    {
-        OldStackVariable->user_erase(this);
-    }
-
-    if (SV)
-    {
-        SV->user_insert(this);
-    }
 }
 
 ////////////////////////////////////////////////////////////
@@ -375,12 +292,7 @@ Instruction::removeFromParent()
         return;
     }
 
-    if (mParent->getInstList().empty())
-    {
-        return;
-    }
-
-    mParent->getInstList().remove(this);
+    mParent->remove(this);
 }
 
 // Remove this instruction from its parent and delete it.
@@ -392,20 +304,7 @@ Instruction::eraseFromParent()
         return;
     }
 
-    if (mParent->getInstList().empty())
-    {
-        return;
-    }
-
-    for (auto It = mParent->getInstList().begin(); It != mParent->getInstList().end(); ++It)
-    {
-        if (*It == this)
-        {
-            mParent->getInstList().erase(It);
-            this->setParent(nullptr);
-            --It;
-        }
-    }
+    mParent->remove(this);
 }
 
 // Insert an unlinked instructions into a basic block immediately before/after the specified instruction.
@@ -417,22 +316,13 @@ Instruction::insertBeforeOrAfter(Instruction *InsertPos, bool Before)
         return;
     }
 
-    auto InsertPosIt = InsertPos->getParent()->getInstList().begin();
-    for (; InsertPosIt != InsertPos->getParent()->getInstList().end(); ++InsertPosIt)
+    auto InsertPosIt = BasicBlock::getInstIterator(InsertPos);
+    if (!Before)
     {
-        if (*InsertPosIt == InsertPos)
-        {
-            if (!Before)
-            {
-                ++InsertPosIt;
-            }
-
-            break;
-        }
+        ++InsertPosIt;
     }
 
-    InsertPos->getParent()->getInstList().insert(InsertPosIt, this);
-    this->setParent(InsertPos->getParent());
+    InsertPos->getParent()->insert(InsertPosIt, this);
 }
 
 // Insert an unlinked instructions into a basic block immediately before the specified instruction.
@@ -455,34 +345,31 @@ Instruction::dropAllReferences()
 {
     User::dropAllReferences();
 
-    // Unlink flags variable from its user list
-    if (mFlagsVariable)
-    {
-        mFlagsVariable->user_erase(this);
-        mFlagsVariable = nullptr;
-    }
-
-    // Unlink stack variable from its user list
-    if (mStackVariable)
-    {
-        mStackVariable->user_erase(this);
-        mStackVariable = nullptr;
-    }
+    // Free the flags/stack variables
+    setFlagsVariable(nullptr);
+    setStackVariable(nullptr);
 }
 
 // Clear all operands in this instruction.
 void
 Instruction::clearAllOperands()
+{
+    unknown::SmallPtrSet<Value *, 16> FreedOperands;
+    clearAllOperands(FreedOperands);
+}
+
+// Clear all operands in this instruction, the operands in FreedOperands were already freed by another instruction
+void
+Instruction::clearAllOperands(unknown::SmallPtrSetImpl<Value *> &FreedOperands)
 {
     // Drop all references to operands
     dropAllReferences();
 
-    // Free all operands
-    std::vector<Value *> FreeOperandsList;
+    // Free all operands, the ones another instruction freed are not touched
     for (auto OPIt = op_begin(); OPIt != op_end(); ++OPIt)
     {
         auto OP = *OPIt;
-        if (OP == nullptr)
+        if (OP == nullptr || FreedOperands.count(OP))
         {
             continue;
         }
@@ -492,47 +379,50 @@ Instruction::clearAllOperands()
             continue;
         }
 
-        if (auto CI = dynamic_cast<ConstantInt *>(OP))
+        if (!isOwnedOperand(OP))
         {
-            // We do not free constant integer
             continue;
         }
 
-        if (auto GV = dynamic_cast<GlobalVariable *>(OP))
+        if (FreedOperands.insert(OP).second)
         {
-            // We do not free global variable
-            continue;
+            delete OP;
         }
+    }
 
-        if (auto BB = dynamic_cast<BasicBlock *>(OP))
-        {
-            // We do not free block
-            continue;
-        }
+    // Clear operand list
+    op_clear();
+}
 
-        if (auto Arg = dynamic_cast<Argument *>(OP))
-        {
-            // We do not free argument
-            continue;
-        }
+////////////////////////////////////////////////////////////
+// Static
+// Is the operand freed with its last user?
+bool
+Instruction::isOwnedOperand(const Value *OP)
+{
+    // We do not free constant integer, global variable, block, argument and function context
+    return !unknown::isa<ConstantInt>(OP) && !unknown::isa<GlobalVariable>(OP) && !unknown::isa<BasicBlock>(OP) &&
+           !unknown::isa<Argument>(OP) && !unknown::isa<FunctionContext>(OP);
+}
 
-        if (auto FC = dynamic_cast<FunctionContext *>(OP))
-        {
-            // We do not free function context
-            continue;
-        }
+////////////////////////////////////////////////////////////
+// Order
+// Is this instruction before the other instruction of the same block?
+bool
+Instruction::comesBefore(const Instruction *Other) const
+{
+    assert(mParent && "Instruction has no parent!");
+    assert(Other->mParent == mParent && "Cross-BB instruction order comparison!");
 
-        if (std::find(FreeOperandsList.begin(), FreeOperandsList.end(), OP) == FreeOperandsList.end())
-        {
-            FreeOperandsList.push_back(OP);
-            delete OP;
-        }
+    if (!mParent->isInstrOrderValid())
+    {
+        mParent->renumberInstructions();
     }
 
-    // Clear operand list
-    op_clear();
+    return mOrder < Other->mOrder;
 }
 
+////////////////////////////////////////////////////////////
 // Enabled
 // Enable 'print detailed op'
 void
@@ -24,34 +24,6 @@ GetBitPtrInstruction::~GetBitPtrInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-GetBitPtrInstruction::getOpcodeName() const
-{
-    return GBPComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-GetBitPtrInstruction::getDefaultNumberOfOperands() const
-{
-    return GBPComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-GetBitPtrInstruction::hasResult() const
-{
-    return GBPComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-GetBitPtrInstruction::hasFlags() const
-{
-    return GBPComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 GetBitPtrInstruction::printInst(unknown::raw_ostream &OS) const
@@ -114,7 +86,7 @@ GetBitPtrInstruction::setBitIndexOperand(Value *BitIndex)
 GetBitPtrInstruction *
 GetBitPtrInstruction::get(PointerType *ResType, Value *Ptr, Value *BitIndex)
 {
-    return new GetBitPtrInstruction(ResType, Ptr, BitIndex);
+    return construct<GetBitPtrInstruction>(ResType->getContext(), ResType, Ptr, BitIndex);
 }
 
 } // namespace uir
@@ -34,34 +34,6 @@ JccAddrInstruction::~JccAddrInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-JccAddrInstruction::getOpcodeName() const
-{
-    return JccAddrComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-JccAddrInstruction::getDefaultNumberOfOperands() const
-{
-    return JccAddrComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-JccAddrInstruction::hasResult() const
-{
-    return JccAddrComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-JccAddrInstruction::hasFlags() const
-{
-    return JccAddrComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 JccAddrInstruction::printInst(unknown::raw_ostream &OS) const
@@ -79,14 +51,14 @@ JccAddrInstruction::printInst(unknown::raw_ostream &OS) const
 const ConstantInt *
 JccAddrInstruction::getJccDestConstantInt() const
 {
-    return dynamic_cast<const ConstantInt *>(getOperand(0));
+    return unknown::dyn_cast_or_null<ConstantInt>(getOperand(0));
 }
 
 // Get the JccNormal constant int
 const ConstantInt *
 JccAddrInstruction::getJccNormalConstantInt() const
 {
-    return dynamic_cast<const ConstantInt *>(getOperand(1));
+    return unknown::dyn_cast_or_null<ConstantInt>(getOperand(1));
 }
 
 // Set the JccDest constant int
@@ -108,7 +80,7 @@ JccAddrInstruction::setJccNormalConstantInt(ConstantInt *JccNormalConstantInt)
 JccAddrInstruction *
 JccAddrInstruction::get(Context &C, ConstantInt *JccDest, ConstantInt *JccNormal, FlagsVariable *FlagsVar)
 {
-    return new JccAddrInstruction(C, JccDest, JccNormal, FlagsVar);
+    return construct<JccAddrInstruction>(C, C, JccDest, JccNormal, FlagsVar);
 }
 
 ////////////////////////////////////////////////////////////
@@ -138,34 +110,6 @@ JccBBInstruction::~JccBBInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-JccBBInstruction::getOpcodeName() const
-{
-    return JccBBComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-JccBBInstruction::getDefaultNumberOfOperands() const
-{
-    return JccBBComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-JccBBInstruction::hasResult() const
-{
-    return JccBBComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-JccBBInstruction::hasFlags() const
-{
-    return JccBBComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 JccBBInstruction::printInst(unknown::raw_ostream &OS) const
@@ -245,7 +189,7 @@ JccBBInstruction::setNormalBlockAndUpdatePredecessor(BasicBlock *NormalBB)
 JccBBInstruction *
 JccBBInstruction::get(Context &C, BasicBlock *JccDestBB, BasicBlock *JccNormalBB, FlagsVariable *FlagsVar)
 {
-    return new JccBBInstruction(C, JccDestBB, JccNormalBB, FlagsVar);
+    return construct<JccBBInstruction>(C, C, JccDestBB, JccNormalBB, FlagsVar);
 }
 
 } // namespace uir
@@ -22,34 +22,6 @@ JmpAddrInstruction::~JmpAddrInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-JmpAddrInstruction::getOpcodeName() const
-{
-    return JmpAddrComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-JmpAddrInstruction::getDefaultNumberOfOperands() const
-{
-    return JmpAddrComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-JmpAddrInstruction::hasResult() const
-{
-    return JmpAddrComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-JmpAddrInstruction::hasFlags() const
-{
-    return JmpAddrComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 JmpAddrInstruction::printInst(unknown::raw_ostream &OS) const
@@ -65,7 +37,7 @@ JmpAddrInstruction::printInst(unknown::raw_ostream &OS) const
 const ConstantInt *
 JmpAddrInstruction::getJmpDestConstantInt() const
 {
-    return dynamic_cast<const ConstantInt *>(getOperand(0));
+    return unknown::dyn_cast_or_null<ConstantInt>(getOperand(0));
 }
 
 // Set the JmpDest constant int
@@ -80,7 +52,7 @@ JmpAddrInstruction::setJmpDestConstantInt(ConstantInt *JmpDestConstantInt)
 JmpAddrInstruction *
 JmpAddrInstruction::get(Context &C, ConstantInt *JmpDest)
 {
-    return new JmpAddrInstruction(C, JmpDest);
+    return construct<JmpAddrInstruction>(C, C, JmpDest);
 }
 
 ////////////////////////////////////////////////////////////
@@ -99,34 +71,6 @@ JmpBBInstruction::~JmpBBInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-JmpBBInstruction::getOpcodeName() const
-{
-    return JmpBBComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-JmpBBInstruction::getDefaultNumberOfOperands() const
-{
-    return JmpBBComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-JmpBBInstruction::hasResult() const
-{
-    return JmpBBComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-JmpBBInstruction::hasFlags() const
-{
-    return JmpBBComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 JmpBBInstruction::printInst(unknown::raw_ostream &OS) const
@@ -177,7 +121,7 @@ JmpBBInstruction::setDestinationBlockAndUpdatePredecessor(BasicBlock *DestBB)
 JmpBBInstruction *
 JmpBBInstruction::get(Context &C, BasicBlock *DestBB)
 {
-    return new JmpBBInstruction(C, DestBB);
+    return construct<JmpBBInstruction>(C, C, DestBB);
 }
 
 } // namespace uir
\ No newline at end of file
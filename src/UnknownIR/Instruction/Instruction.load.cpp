@@ -7,7 +7,7 @@ namespace uir {
 LoadInstruction::LoadInstruction(Value *Ptr) :
     Instruction(
         OpCodeID::Load,
-        Ptr->getType()->isPointerTy() ? dynamic_cast<PointerType *>(Ptr->getType())->getElementType()
+        Ptr->getType()->isPointerTy() ? unknown::cast<PointerType>(Ptr->getType())->getElementType()
                                       : Type::getVoidTy(getContext()))
 {
     assert(Ptr->getType()->isPointerTy() && "Ptr must be a pointer type!");
@@ -23,34 +23,6 @@ LoadInstruction::~LoadInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-LoadInstruction::getOpcodeName() const
-{
-    return LoadComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-LoadInstruction::getDefaultNumberOfOperands() const
-{
-    return LoadComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-LoadInstruction::hasResult() const
-{
-    return LoadComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-LoadInstruction::hasFlags() const
-{
-    return LoadComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 LoadInstruction::printInst(unknown::raw_ostream &OS) const
@@ -90,7 +62,7 @@ LoadInstruction::setPointerOperand(Value *Ptr)
 LoadInstruction *
 LoadInstruction::get(Value *Ptr)
 {
-    return new LoadInstruction(Ptr);
+    return construct<LoadInstruction>(Ptr->getContext(), Ptr);
 }
 
 } // namespace uir
\ No newline at end of file
@@ -20,34 +20,6 @@ ReturnInstruction::~ReturnInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-ReturnInstruction::getOpcodeName() const
-{
-    return RetComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-ReturnInstruction::getDefaultNumberOfOperands() const
-{
-    return RetComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-ReturnInstruction::hasResult() const
-{
-    return RetComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-ReturnInstruction::hasFlags() const
-{
-    return RetComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 ReturnInstruction::printInst(unknown::raw_ostream &OS) const
@@ -60,7 +32,7 @@ ReturnInstruction::printInst(unknown::raw_ostream &OS) const
 ReturnInstruction *
 ReturnInstruction::get(Context &C)
 {
-    return new ReturnInstruction(C);
+    return construct<ReturnInstruction>(C, C);
 }
 
 ////////////////////////////////////////////////////////////
@@ -80,34 +52,6 @@ ReturnImmInstruction::~ReturnImmInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-ReturnImmInstruction::getOpcodeName() const
-{
-    return RetIMMComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-ReturnImmInstruction::getDefaultNumberOfOperands() const
-{
-    return RetIMMComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-ReturnImmInstruction::hasResult() const
-{
-    return RetIMMComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-ReturnImmInstruction::hasFlags() const
-{
-    return RetIMMComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 ReturnImmInstruction::printInst(unknown::raw_ostream &OS) const
@@ -123,7 +67,7 @@ ReturnImmInstruction::printInst(unknown::raw_ostream &OS) const
 const ConstantInt *
 ReturnImmInstruction::getImmConstantInt() const
 {
-    return dynamic_cast<const ConstantInt *>(getOperand(0));
+    return unknown::dyn_cast_or_null<ConstantInt>(getOperand(0));
 }
 
 // Set the immediate constant int
@@ -138,7 +82,7 @@ ReturnImmInstruction::setImmConstantInt(ConstantInt *ImmConstantInt)
 ReturnImmInstruction *
 ReturnImmInstruction::get(Context &C, ConstantInt *ImmConstantInt)
 {
-    return new ReturnImmInstruction(C, ImmConstantInt);
+    return construct<ReturnImmInstruction>(C, C, ImmConstantInt);
 }
 
 } // namespace uir
@@ -26,34 +26,6 @@ StoreInstruction::~StoreInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-StoreInstruction::getOpcodeName() const
-{
-    return StoreComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-StoreInstruction::getDefaultNumberOfOperands() const
-{
-    return StoreComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-StoreInstruction::hasResult() const
-{
-    return StoreComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-StoreInstruction::hasFlags() const
-{
-    return StoreComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 StoreInstruction::printInst(unknown::raw_ostream &OS) const
@@ -128,7 +100,7 @@ StoreInstruction::setVolatile(bool IsVolatile)
 StoreInstruction *
 StoreInstruction::get(Context &C, Value *Val, Value *Ptr, bool IsVolatile)
 {
-    return new StoreInstruction(C, Val, Ptr, IsVolatile);
+    return construct<StoreInstruction>(C, C, Val, Ptr, IsVolatile);
 }
 
 } // namespace uir
@@ -1,11 +1,14 @@
 #include <Instruction.h>
 
+#include <Context.h>
+#include <ContextImpl/ContextImpl.h>
+
 #include <Internal/InternalConfig/InternalConfig.h>
 
 namespace uir {
 
 UnknownInstruction::UnknownInstruction(Context &C, unknown::StringRef UnknownStr) :
-    Instruction(C, OpCodeID::Unknown), mUnknownStr(UnknownStr)
+    Instruction(C, OpCodeID::Unknown), mUnknownStr(C.mImpl->internValueName(UnknownStr))
 {
     //
 }
@@ -17,34 +20,6 @@ UnknownInstruction ::~UnknownInstruction()
 
 ////////////////////////////////////////////////////////////
 // Virtual
-// Get the opcode name of this instruction
-unknown::StringRef
-UnknownInstruction::getOpcodeName() const
-{
-    return UnknownComponent.mOpCodeName;
-}
-
-// Get the default number of operands
-uint32_t
-UnknownInstruction::getDefaultNumberOfOperands() const
-{
-    return UnknownComponent.mNumberOfOperands;
-}
-
-// Is this instruction with result?
-bool
-UnknownInstruction::hasResult() const
-{
-    return UnknownComponent.mHasResult;
-}
-
-// Is this instruction with flags?
-bool
-UnknownInstruction::hasFlags() const
-{
-    return UnknownComponent.mHasFlags;
-}
-
 // Print the instruction
 void
 UnknownInstruction::printInst(unknown::raw_ostream &OS) const
@@ -68,7 +43,7 @@ UnknownInstruction::getUnknownStr() const
 UnknownInstruction *
 UnknownInstruction::get(Context &C, unknown::StringRef UnknownStr)
 {
-    return new UnknownInstruction(C, UnknownStr);
+    return construct<UnknownInstruction>(C, C, UnknownStr);
 }
 
 } // namespace uir
@@ -0,0 +1,1304 @@
+#include <Internal/InternalBinary/InternalBinary.h>
+
+#include <Argument.h>
+#include <BasicBlock.h>
+#include <FlagsVariable.h>
+#include <FunctionContext.h>
+#include <Instruction.h>
+#include <LocalVariable.h>
+
+#include <unknown/Support/Endian.h>
+#include <unknown/Support/LEB128.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace uir {
+
+namespace {
+
+// Get the index of the value in a list of the function
+template <typename ListType>
+std::optional<uint64_t>
+getListIndex(const ListType &List, const Value *V)
+{
+    uint64_t Index = 0;
+    for (auto Item : List)
+    {
+        if (Item == V)
+        {
+            return Index;
+        }
+        ++Index;
+    }
+    return {};
+}
+
+// Get the item at the index of a list of the function
+template <typename ListType>
+Value *
+getListItem(const ListType &List, uint64_t Index)
+{
+    if (Index >= List.size())
+    {
+        return nullptr;
+    }
+    return *std::next(List.begin(), Index);
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////
+// Write
+// Write an unsigned LEB128
+void
+writeBinaryULEB(unknown::raw_ostream &OS, uint64_t Value)
+{
+    unknown::encodeULEB128(Value, OS);
+}
+
+// Write a signed LEB128, the addresses are written as the delta to a nearby address
+void
+writeBinarySLEB(unknown::raw_ostream &OS, int64_t Value)
+{
+    unknown::encodeSLEB128(Value, OS);
+}
+
+// Write a 64-bit little-endian integer
+void
+writeBinaryU64(unknown::raw_ostream &OS, uint64_t Value)
+{
+    char Buffer[sizeof(uint64_t)];
+    unknown::support::endian::write64le(Buffer, Value);
+    OS.write(Buffer, sizeof(Buffer));
+}
+
+////////////////////////////////////////////////////////////
+//     BinaryTables
+//
+
+BinaryTables::BinaryTables()
+{
+    // The empty string is always 0
+    getStringID("");
+}
+
+// Get the index of a string, it is added to the table on first use
+uint64_t
+BinaryTables::getStringID(unknown::StringRef Str)
+{
+    auto Result = mStringIDs.try_emplace(Str, mStrings.size());
+    if (Result.second)
+    {
+        mStrings.push_back(Result.first->getKey());
+    }
+    return Result.first->second;
+}
+
+// Get the index of a type, it is added to the table after the types it refers to
+std::optional<uint64_t>
+BinaryTables::getTypeID(const Type *Ty)
+{
+    if (Ty == nullptr)
+    {
+        return {};
+    }
+
+    auto It = mTypeIDs.find(Ty);
+    if (It != mTypeIDs.end())
+    {
+        return It->second;
+    }
+
+    switch (Ty->getTypeID())
+    {
+    case Type::ArrayTyID:
+        return {};
+    case Type::PointerTyID:
+        if (!getTypeID(static_cast<const PointerType *>(Ty)->getElementType()))
+        {
+            return {};
+        }
+        break;
+    default:
+        break;
+    }
+
+    uint64_t TypeID = mTypes.size();
+    mTypeIDs[Ty] = TypeID;
+    mTypes.push_back(Ty);
+    return TypeID;
+}
+
+// Write the string table, each string is followed by a NUL so the reader can use it in place
+void
+BinaryTables::writeStringTable(unknown::raw_ostream &OS) const
+{
+    writeBinaryULEB(OS, mStrings.size());
+    for (auto Str : mStrings)
+    {
+        writeBinaryULEB(OS, Str.size());
+        OS << Str << '\0';
+    }
+}
+
+// Write the type table
+void
+BinaryTables::writeTypeTable(unknown::raw_ostream &OS) const
+{
+    writeBinaryULEB(OS, mTypes.size());
+    for (auto Ty : mTypes)
+    {
+        writeBinaryULEB(OS, Ty->getTypeID());
+        switch (Ty->getTypeID())
+        {
+        case Type::IntegerTyID:
+            writeBinaryULEB(OS, Ty->getTypeBits());
+            break;
+        case Type::PointerTyID:
+            writeBinaryULEB(OS, mTypeIDs.lookup(static_cast<const PointerType *>(Ty)->getElementType()));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////
+//     BinaryCursor
+//
+
+BinaryCursor::BinaryCursor(
+    unknown::StringRef Buffer,
+    const std::vector<unknown::StringRef> &Strings,
+    const std::vector<Type *> &Types) :
+    mPtr(Buffer.bytes_begin()), mEnd(Buffer.bytes_end()), mStrings(Strings), mTypes(Types), mError(false)
+{
+}
+
+// Mark the range as invalid
+bool
+BinaryCursor::fail()
+{
+    mError = true;
+    return false;
+}
+
+// Read a byte
+uint8_t
+BinaryCursor::readByte()
+{
+    if (mError || mPtr >= mEnd)
+    {
+        mError = true;
+        return 0;
+    }
+    return *mPtr++;
+}
+
+// Read an unsigned LEB128
+uint64_t
+BinaryCursor::readULEB()
+{
+    if (mError)
+    {
+        return 0;
+    }
+
+    unsigned Size = 0;
+    const char *Error = nullptr;
+    auto Value = unknown::decodeULEB128(mPtr, &Size, mEnd, &Error);
+    if (Error)
+    {
+        mError = true;
+        return 0;
+    }
+    mPtr += Size;
+    return Value;
+}
+
+// Read a signed LEB128
+int64_t
+BinaryCursor::readSLEB()
+{
+    if (mError)
+    {
+        return 0;
+    }
+
+    unsigned Size = 0;
+    const char *Error = nullptr;
+    auto Value = unknown::decodeSLEB128(mPtr, &Size, mEnd, &Error);
+    if (Error)
+    {
+        mError = true;
+        return 0;
+    }
+    mPtr += Size;
+    return Value;
+}
+
+// Read the number of entries, each entry takes at least one byte
+uint64_t
+BinaryCursor::readCount()
+{
+    auto Count = readULEB();
+    if (Count > static_cast<uint64_t>(mEnd - mPtr))
+    {
+        mError = true;
+        return 0;
+    }
+    return Count;
+}
+
+// Read the bytes of a string of the string table, the string is followed by a NUL
+unknown::StringRef
+BinaryCursor::readStringData()
+{
+    auto Size = readULEB();
+    if (mError || Size >= static_cast<uint64_t>(mEnd - mPtr) || mPtr[Size] != '\0')
+    {
+        mError = true;
+        return {};
+    }
+
+    unknown::StringRef Str(reinterpret_cast<const char *>(mPtr), Size);
+    mPtr += Size + 1;
+    return Str;
+}
+
+// Read the index of a string, the string points into the file
+unknown::StringRef
+BinaryCursor::readString()
+{
+    auto StringID = readULEB();
+    if (mError || StringID >= mStrings.size())
+    {
+        mError = true;
+        return {};
+    }
+    return mStrings[StringID];
+}
+
+// Read the index of a type
+Type *
+BinaryCursor::readType()
+{
+    auto TypeID = readULEB();
+    if (mError || TypeID >= mTypes.size())
+    {
+        mError = true;
+        return nullptr;
+    }
+    return mTypes[TypeID];
+}
+
+// Read the comment and the extra info of a value
+void
+BinaryCursor::readAnnotation(Value *V)
+{
+    auto Comment = readString();
+    auto NumExtraInfo = readCount();
+    Value::ExtraInfoListType ExtraInfoList;
+    for (uint64_t Index = 0; Index < NumExtraInfo && !mError; ++Index)
+    {
+        ExtraInfoList.push_back(readString().str());
+    }
+    if (mError)
+    {
+        return;
+    }
+
+    if (!Comment.empty())
+    {
+        V->setComment(Comment);
+    }
+    if (!ExtraInfoList.empty())
+    {
+        V->setExtraInfoList(ExtraInfoList);
+    }
+}
+
+// Read an APInt
+std::optional<unknown::APInt>
+BinaryCursor::readAPInt()
+{
+    auto BitWidth = readULEB();
+    if (mError || BitWidth == 0 || BitWidth > UIRBinaryMaxIntegerBits)
+    {
+        mError = true;
+        return {};
+    }
+
+    // The common widths fit in one word
+    if (BitWidth <= 64)
+    {
+        auto Word = readULEB();
+        if (mError)
+        {
+            return {};
+        }
+        return unknown::APInt(static_cast<unsigned>(BitWidth), Word);
+    }
+
+    std::vector<uint64_t> Words((BitWidth + 63) / 64);
+    for (auto &Word : Words)
+    {
+        Word = readULEB();
+    }
+    if (mError)
+    {
+        return {};
+    }
+
+    return unknown::APInt(static_cast<unsigned>(BitWidth), Words);
+}
+
+////////////////////////////////////////////////////////////
+// Tables
+// Read the string table, the strings point into the buffer
+bool
+readBinaryStringTable(unknown::StringRef Buffer, std::vector<unknown::StringRef> &Strings)
+{
+    std::vector<Type *> Types;
+    BinaryCursor Cursor(Buffer, Strings, Types);
+    auto NumStrings = Cursor.readCount();
+    Strings.reserve(NumStrings);
+    for (uint64_t Index = 0; Index < NumStrings && !Cursor.hasError(); ++Index)
+    {
+        Strings.push_back(Cursor.readStringData());
+    }
+
+    return !Cursor.hasError() && Cursor.atEnd() && !Strings.empty() && Strings[0].empty();
+}
+
+// Read the type table, a pointer type refers to a type before it
+bool
+readBinaryTypeTable(
+    Context &C,
+    unknown::StringRef Buffer,
+    const std::vector<unknown::StringRef> &Strings,
+    std::vector<Type *> &Types)
+{
+    BinaryCursor Cursor(Buffer, Strings, Types);
+    auto NumTypes = Cursor.readCount();
+    Types.reserve(NumTypes);
+    for (uint64_t Index = 0; Index < NumTypes && !Cursor.hasError(); ++Index)
+    {
+        Type *Ty = nullptr;
+        switch (Cursor.readULEB())
+        {
+        case Type::VoidTyID:
+            Ty = Type::getVoidTy(C);
+            break;
+        case Type::FloatTyID:
+            Ty = Type::getFloatTy(C);
+            break;
+        case Type::DoubleTyID:
+            Ty = Type::getDoubleTy(C);
+            break;
+        case Type::LabelTyID:
+            Ty = Type::getLabelTy(C);
+            break;
+        case Type::FunctionTyID:
+            Ty = Type::getFunctionTy(C);
+            break;
+        case Type::IntegerTyID: {
+            auto Bits = Cursor.readULEB();
+            if (!Cursor.hasError() && Bits != 0 && Bits <= UIRBinaryMaxIntegerBits)
+            {
+                Ty = IntegerType::get(C, static_cast<uint32_t>(Bits));
+            }
+            break;
+        }
+        case Type::PointerTyID: {
+            if (auto ElementTy = Cursor.readType())
+            {
+                Ty = PointerType::get(C, ElementTy);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (Ty == nullptr)
+        {
+            return false;
+        }
+        Types.push_back(Ty);
+    }
+
+    return !Cursor.hasError() && Cursor.atEnd();
+}
+
+////////////////////////////////////////////////////////////
+//     FunctionBodyWriter
+//
+
+FunctionBodyWriter::FunctionBodyWriter(
+    BinaryTables &Tables,
+    const unknown::DenseMap<const GlobalVariable *, uint64_t> &GlobalVariableIDs,
+    const Function &F,
+    unknown::raw_ostream &OS,
+    const BinaryBodyOptions &Options) :
+    mTables(Tables),
+    mGlobalVariableIDs(GlobalVariableIDs),
+    mFunction(F),
+    mOS(OS),
+    mOptions(Options),
+    mLastAddress(F.getFunctionBeginAddress())
+{
+}
+
+// Write the body of the function, returns false if it has something that can not be written
+bool
+FunctionBodyWriter::write()
+{
+    // Number the basic blocks
+    for (auto BB : mFunction)
+    {
+        uint64_t BlockID = mBlockIDs.size();
+        mBlockIDs[BB] = BlockID;
+    }
+
+    // Collect the values
+    for (auto BB : mFunction)
+    {
+        for (auto I : *BB)
+        {
+            if (I->getParent() != BB || !collectValue(I))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Basic blocks, the begin is near the function and the end is near the begin
+    writeBinaryULEB(mOS, mBlockIDs.size());
+    for (auto BB : mFunction)
+    {
+        writeString(BB->getBasicBlockName());
+        writeAddress(BB->getBasicBlockAddressBegin(), mFunction.getFunctionBeginAddress());
+        writeAddress(BB->getBasicBlockAddressEnd(), BB->getBasicBlockAddressBegin());
+        if (mOptions.mBlockAnnotations)
+        {
+            writeAnnotation(BB);
+        }
+    }
+
+    // Values
+    writeBinaryULEB(mOS, mValues.size());
+    for (auto V : mValues)
+    {
+        if (!writeValue(V))
+        {
+            return false;
+        }
+    }
+
+    // Instructions and predecessors of the basic blocks
+    for (auto BB : mFunction)
+    {
+        writeBinaryULEB(mOS, BB->size());
+        for (auto I : *BB)
+        {
+            writeBinaryULEB(mOS, mValueIDs[I]);
+        }
+
+        const auto &Predecessors = BB->getPredecessorsList();
+        writeBinaryULEB(mOS, Predecessors.size());
+        for (auto Pred : Predecessors)
+        {
+            auto It = mBlockIDs.find(Pred);
+            if (It == mBlockIDs.end())
+            {
+                return false;
+            }
+            writeBinaryULEB(mOS, It->second);
+        }
+    }
+
+    return true;
+}
+
+// Get the kind of a value
+std::optional<BinaryValueKind>
+FunctionBodyWriter::getValueKind(const Value *V) const
+{
+    switch (V->getValueID())
+    {
+    case Value::InstructionVal:
+        return BinaryValueKind::Instruction;
+    case Value::FlagsVariableVal:
+        return BinaryValueKind::FlagsVariable;
+    case Value::LocalVariableVal:
+        return BinaryValueKind::LocalVariable;
+    case Value::GlobalVariableVal:
+    case Value::GlobalArrayVal:
+        // The global variables of the module are referenced by their index in the module record
+        if (mGlobalVariableIDs.count(static_cast<const GlobalVariable *>(V)))
+        {
+            return BinaryValueKind::ModuleGlobalVariable;
+        }
+        // GlobalArray keeps its elements, so only plain global variables are written in the body
+        if (V->getValueID() == Value::GlobalVariableVal)
+        {
+            return BinaryValueKind::GlobalVariable;
+        }
+        return {};
+    case Value::ConstantIntVal:
+        return BinaryValueKind::ConstantInt;
+    case Value::ArgumentVal:
+        return BinaryValueKind::Argument;
+    case Value::FunctionContextVal:
+        return BinaryValueKind::FunctionContext;
+    case Value::ConstantVal:
+        return BinaryValueKind::Constant;
+    default:
+        return {};
+    }
+}
+
+// Collect the value after its operands
+bool
+FunctionBodyWriter::collectValue(const Value *V)
+{
+    if (V == nullptr)
+    {
+        return false;
+    }
+
+    if (mValueIDs.count(V))
+    {
+        return true;
+    }
+
+    auto Kind = getValueKind(V);
+    if (!Kind)
+    {
+        return false;
+    }
+
+    if (*Kind == BinaryValueKind::Instruction)
+    {
+        // Operands that refer back to the instruction can not be rebuilt
+        if (!mVisiting.insert(V).second)
+        {
+            return false;
+        }
+
+        auto I = static_cast<const Instruction *>(V);
+        if (!isBinarySupportedOpCode(I->getOpCodeID()) || I->getStackVariable())
+        {
+            return false;
+        }
+
+        for (auto Op : I->operand_values())
+        {
+            if (auto BB = unknown::dyn_cast_or_null<BasicBlock>(Op))
+            {
+                if (!mBlockIDs.count(BB))
+                {
+                    return false;
+                }
+            }
+            else if (!collectValue(Op))
+            {
+                return false;
+            }
+        }
+
+        if (auto TI = unknown::dyn_cast<TerminatorInstruction>(I))
+        {
+            for (auto Succ : TI->getSuccessorsList())
+            {
+                if (!mBlockIDs.count(Succ))
+                {
+                    return false;
+                }
+            }
+        }
+
+        mVisiting.erase(V);
+    }
+
+    uint64_t ValueID = mValues.size();
+    mValueIDs[V] = ValueID;
+    mValues.push_back(V);
+    return true;
+}
+
+// Write one entry of the value table
+bool
+FunctionBodyWriter::writeValue(const Value *V)
+{
+    auto Kind = *getValueKind(V);
+    mOS << static_cast<uint8_t>(Kind);
+
+    switch (Kind)
+    {
+    case BinaryValueKind::ConstantInt: {
+        auto CI = static_cast<const ConstantInt *>(V);
+        if (!writeType(CI->getType()))
+        {
+            return false;
+        }
+        writeAPInt(CI->getValue());
+        // ConstantInt is shared by the context, so its comment does not belong to this function
+        return true;
+    }
+    case BinaryValueKind::LocalVariable: {
+        auto LV = static_cast<const LocalVariable *>(V);
+        if (!writeType(LV->getType()))
+        {
+            return false;
+        }
+        writeString(LV->getName());
+        writeBinaryULEB(mOS, LV->getLocalVariableAddress());
+        break;
+    }
+    case BinaryValueKind::GlobalVariable: {
+        auto GV = static_cast<const GlobalVariable *>(V);
+        if (!writeType(GV->getType()))
+        {
+            return false;
+        }
+        writeString(GV->getName());
+        writeBinaryULEB(mOS, GV->getGlobalVariableAddress());
+        break;
+    }
+    case BinaryValueKind::ModuleGlobalVariable: {
+        // The module record has the rest of the global variable
+        writeBinaryULEB(mOS, mGlobalVariableIDs.lookup(static_cast<const GlobalVariable *>(V)));
+        return true;
+    }
+    case BinaryValueKind::FlagsVariable: {
+        if (!writeFlagsVariable(static_cast<const FlagsVariable *>(V)))
+        {
+            return false;
+        }
+        break;
+    }
+    case BinaryValueKind::Argument: {
+        auto Index = getListIndex(mFunction.getArgumentList(), V);
+        if (!Index)
+        {
+            return false;
+        }
+        writeBinaryULEB(mOS, *Index);
+        return true;
+    }
+    case BinaryValueKind::FunctionContext: {
+        auto Index = getListIndex(mFunction.getFunctionContextList(), V);
+        if (!Index)
+        {
+            return false;
+        }
+        writeBinaryULEB(mOS, *Index);
+        return true;
+    }
+    case BinaryValueKind::Constant: {
+        if (!writeType(V->getType()))
+        {
+            return false;
+        }
+        writeString(V->getName());
+        break;
+    }
+    case BinaryValueKind::Instruction: {
+        if (!writeInstruction(static_cast<const Instruction *>(V)))
+        {
+            return false;
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+
+    writeAnnotation(V);
+    return true;
+}
+
+// Write an instruction
+bool
+FunctionBodyWriter::writeInstruction(const Instruction *I)
+{
+    writeBinaryULEB(mOS, static_cast<uint64_t>(I->getOpCodeID()));
+    if (!writeType(I->getType()))
+    {
+        return false;
+    }
+    writeString(I->getName());
+
+    // The instructions are mostly written in address order, so the delta is short
+    writeAddress(I->getInstructionAddress(), mLastAddress);
+    mLastAddress = I->getInstructionAddress();
+    mOS << static_cast<uint8_t>(I->hasPrintOp());
+
+    // Operands, the low bit tells the basic blocks apart
+    writeBinaryULEB(mOS, I->op_count());
+    for (auto Op : I->operand_values())
+    {
+        if (auto BB = unknown::dyn_cast_or_null<BasicBlock>(Op))
+        {
+            writeBinaryULEB(mOS, (mBlockIDs.lookup(BB) << 1) | 1);
+        }
+        else
+        {
+            writeBinaryULEB(mOS, mValueIDs.lookup(Op) << 1);
+        }
+    }
+
+    // Successors
+    if (auto TI = unknown::dyn_cast<TerminatorInstruction>(I))
+    {
+        writeBinaryULEB(mOS, TI->getSuccessorsList().size());
+        for (auto Succ : TI->getSuccessorsList())
+        {
+            writeBinaryULEB(mOS, mBlockIDs.lookup(Succ));
+        }
+    }
+    else
+    {
+        writeBinaryULEB(mOS, 0);
+    }
+
+    // Flags
+    auto FlagsVar = I->getFlagsVariable();
+    mOS << static_cast<uint8_t>(FlagsVar != nullptr);
+    if (FlagsVar && !writeFlagsVariable(FlagsVar))
+    {
+        return false;
+    }
+
+    // Extra operands of the opcodes
+    if (auto UI = unknown::dyn_cast<UnknownInstruction>(I))
+    {
+        writeString(UI->getUnknownStr());
+    }
+    else if (auto SI = unknown::dyn_cast<StoreInstruction>(I))
+    {
+        mOS << static_cast<uint8_t>(SI->isVolatile());
+    }
+
+    return true;
+}
+
+// Write a flags variable
+bool
+FunctionBodyWriter::writeFlagsVariable(const FlagsVariable *FlagsVar)
+{
+    if (!writeType(FlagsVar->getType()))
+    {
+        return false;
+    }
+    writeString(FlagsVar->getName());
+    writeBinaryULEB(mOS, FlagsVar->getFlagsValue());
+    return true;
+}
+
+// Write an address, as the delta to a nearby address if the options ask for it
+void
+FunctionBodyWriter::writeAddress(uint64_t Address, uint64_t Base)
+{
+    if (mOptions.mDeltaAddresses)
+    {
+        writeBinarySLEB(mOS, Address - Base);
+    }
+    else
+    {
+        writeBinaryULEB(mOS, Address);
+    }
+}
+
+// Write the comment and the extra info of a value
+void
+FunctionBodyWriter::writeAnnotation(const Value *V)
+{
+    writeString(V->getComment());
+    const auto &ExtraInfoList = V->getExtraInfoList();
+    writeBinaryULEB(mOS, ExtraInfoList.size());
+    for (const auto &ExtraInfo : ExtraInfoList)
+    {
+        writeString(ExtraInfo);
+    }
+}
+
+// Write the index of a type
+bool
+FunctionBodyWriter::writeType(const Type *Ty)
+{
+    auto TypeID = mTables.getTypeID(Ty);
+    if (!TypeID)
+    {
+        return false;
+    }
+    writeBinaryULEB(mOS, *TypeID);
+    return true;
+}
+
+// Write an APInt
+void
+FunctionBodyWriter::writeAPInt(const unknown::APInt &Val)
+{
+    writeBinaryULEB(mOS, Val.getBitWidth());
+    for (unsigned Index = 0; Index < Val.getNumWords(); ++Index)
+    {
+        writeBinaryULEB(mOS, Val.getRawData()[Index]);
+    }
+}
+
+// Write the index of a string
+void
+FunctionBodyWriter::writeString(unknown::StringRef Str)
+{
+    writeBinaryULEB(mOS, mTables.getStringID(Str));
+}
+
+////////////////////////////////////////////////////////////
+//     FunctionBodyReader
+//
+
+FunctionBodyReader::FunctionBodyReader(
+    Function &F,
+    unknown::StringRef Body,
+    const std::vector<unknown::StringRef> &Strings,
+    const std::vector<Type *> &Types,
+    const std::vector<GlobalVariable *> &GlobalVariables,
+    const BinaryBodyOptions &Options) :
+    mContext(F.getContext()),
+    mFunction(F),
+    mCursor(Body, Strings, Types),
+    mGlobalVariables(GlobalVariables),
+    mOptions(Options),
+    mLastAddress(F.getFunctionBeginAddress())
+{
+}
+
+FunctionBodyReader::~FunctionBodyReader()
+{
+    if (mCursor.hasError())
+    {
+        // Users go before their operands
+        for (auto It = mOwnedValues.rbegin(); It != mOwnedValues.rend(); ++It)
+        {
+            delete *It;
+        }
+        for (auto BB : mBlocks)
+        {
+            delete BB;
+        }
+    }
+}
+
+// Read the body, returns false if it is corrupted
+bool
+FunctionBodyReader::read()
+{
+    // Basic blocks
+    auto NumBlocks = mCursor.readCount();
+    for (uint64_t Index = 0; Index < NumBlocks && !mCursor.hasError(); ++Index)
+    {
+        auto Name = mCursor.readString();
+        auto Begin = readAddress(mFunction.getFunctionBeginAddress());
+        auto End = readAddress(Begin);
+        if (mCursor.hasError() || Name.empty())
+        {
+            return mCursor.fail();
+        }
+        mBlocks.push_back(BasicBlock::get(mContext, Name, Begin, End));
+        if (mOptions.mBlockAnnotations)
+        {
+            mCursor.readAnnotation(mBlocks.back());
+        }
+    }
+
+    // Values
+    mValues.reserve(mCursor.readCount());
+    for (size_t Index = 0; Index < mValues.capacity() && !mCursor.hasError(); ++Index)
+    {
+        if (!readValue())
+        {
+            return mCursor.fail();
+        }
+    }
+
+    // Instructions and predecessors of the basic blocks
+    unknown::SmallPtrSet<Instruction *, 32> Placed;
+    for (size_t Index = 0; Index < mBlocks.size() && !mCursor.hasError(); ++Index)
+    {
+        auto &Instructions = mBlockInstructions.emplace_back();
+        auto NumInstructions = mCursor.readCount();
+        for (uint64_t InstIndex = 0; InstIndex < NumInstructions && !mCursor.hasError(); ++InstIndex)
+        {
+            auto I = unknown::dyn_cast_or_null<Instruction>(getValue(mCursor.readULEB()));
+            if (I == nullptr || !Placed.insert(I).second)
+            {
+                return mCursor.fail();
+            }
+            Instructions.push_back(I);
+        }
+
+        auto &Predecessors = mBlockPredecessors.emplace_back();
+        auto NumPredecessors = mCursor.readCount();
+        for (uint64_t PredIndex = 0; PredIndex < NumPredecessors && !mCursor.hasError(); ++PredIndex)
+        {
+            auto Pred = getBlock(mCursor.readULEB());
+            if (Pred == nullptr)
+            {
+                return mCursor.fail();
+            }
+            Predecessors.push_back(Pred);
+        }
+    }
+
+    if (mCursor.hasError() || !mCursor.atEnd())
+    {
+        return mCursor.fail();
+    }
+
+    // Attach everything to the function
+    for (size_t Index = 0; Index < mBlocks.size(); ++Index)
+    {
+        auto BB = mBlocks[Index];
+        for (auto I : mBlockInstructions[Index])
+        {
+            BB->push_back(I);
+            I->setParent(BB);
+        }
+        for (auto Pred : mBlockPredecessors[Index])
+        {
+            BB->predecessor_push(Pred);
+        }
+        mFunction.insertBasicBlock(BB);
+    }
+
+    // The global variables that are not in the module record belong to the function
+    for (auto GV : mGlobalVariablesToOwn)
+    {
+        mFunction.insertOwnedGlobalVariable(GV);
+    }
+
+    return true;
+}
+
+// Read one entry of the value table
+bool
+FunctionBodyReader::readValue()
+{
+    auto Kind = static_cast<BinaryValueKind>(mCursor.readByte());
+    Value *V = nullptr;
+
+    switch (Kind)
+    {
+    case BinaryValueKind::ConstantInt: {
+        auto IntTy = unknown::dyn_cast_or_null<IntegerType>(mCursor.readType());
+        auto Val = mCursor.readAPInt();
+        if (IntTy == nullptr || !Val || IntTy->getTypeBits() != Val->getBitWidth())
+        {
+            return false;
+        }
+        V = ConstantInt::get(IntTy, *Val);
+        mValues.push_back(V);
+        return V != nullptr;
+    }
+    case BinaryValueKind::LocalVariable: {
+        auto Ty = mCursor.readType();
+        auto Name = mCursor.readString();
+        auto Address = mCursor.readULEB();
+        if (mCursor.hasError())
+        {
+            return false;
+        }
+        V = own(LocalVariable::get(Ty, Name, Address));
+        break;
+    }
+    case BinaryValueKind::GlobalVariable: {
+        auto Ty = mCursor.readType();
+        auto Name = mCursor.readString();
+        auto Address = mCursor.readULEB();
+        if (mCursor.hasError())
+        {
+            return false;
+        }
+        auto GV = GlobalVariable::get(Ty, Name, Address);
+        mGlobalVariablesToOwn.push_back(GV);
+        V = own(GV);
+        break;
+    }
+    case BinaryValueKind::ModuleGlobalVariable: {
+        auto Index = mCursor.readULEB();
+        V = Index < mGlobalVariables.size() ? mGlobalVariables[Index] : nullptr;
+        mValues.push_back(V);
+        return V != nullptr && !mCursor.hasError();
+    }
+    case BinaryValueKind::FlagsVariable: {
+        auto FlagsVar = readFlagsVariable();
+        if (FlagsVar == nullptr)
+        {
+            return false;
+        }
+        V = own(FlagsVar);
+        break;
+    }
+    case BinaryValueKind::Argument: {
+        V = getListItem(mFunction.getArgumentList(), mCursor.readULEB());
+        mValues.push_back(V);
+        return V != nullptr && !mCursor.hasError();
+    }
+    case BinaryValueKind::FunctionContext: {
+        V = getListItem(mFunction.getFunctionContextList(), mCursor.readULEB());
+        mValues.push_back(V);
+        return V != nullptr && !mCursor.hasError();
+    }
+    case BinaryValueKind::Constant: {
+        auto Ty = mCursor.readType();
+        auto Name = mCursor.readString();
+        if (mCursor.hasError())
+        {
+            return false;
+        }
+        V = own(Constant::get(Ty, Name));
+        break;
+    }
+    case BinaryValueKind::Instruction: {
+        V = readInstruction();
+        if (V == nullptr)
+        {
+            return false;
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+
+    mCursor.readAnnotation(V);
+    return !mCursor.hasError();
+}
+
+// Read an instruction
+Instruction *
+FunctionBodyReader::readInstruction()
+{
+    auto OpCodeId = static_cast<OpCodeID>(mCursor.readULEB());
+    auto Ty = mCursor.readType();
+    auto Name = mCursor.readString();
+    mLastAddress = readAddress(mLastAddress);
+    auto Address = mLastAddress;
+    auto PrintOp = mCursor.readByte() != 0;
+    if (mCursor.hasError() || !isBinarySupportedOpCode(OpCodeId))
+    {
+        return nullptr;
+    }
+
+    // Operands
+    std::vector<Value *> Operands;
+    auto NumOperands = mCursor.readCount();
+    for (uint64_t Index = 0; Index < NumOperands && !mCursor.hasError(); ++Index)
+    {
+        auto OpID = mCursor.readULEB();
+        auto Op = (OpID & 1) ? static_cast<Value *>(getBlock(OpID >> 1)) : getValue(OpID >> 1);
+        if (Op == nullptr)
+        {
+            return nullptr;
+        }
+        Operands.push_back(Op);
+    }
+
+    // Successors
+    std::vector<BasicBlock *> Successors;
+    auto NumSuccessors = mCursor.readCount();
+    for (uint64_t Index = 0; Index < NumSuccessors && !mCursor.hasError(); ++Index)
+    {
+        auto Succ = getBlock(mCursor.readULEB());
+        if (Succ == nullptr)
+        {
+            return nullptr;
+        }
+        Successors.push_back(Succ);
+    }
+
+    // Flags
+    std::unique_ptr<FlagsVariable> FlagsVar;
+    if (mCursor.readByte() != 0)
+    {
+        FlagsVar.reset(readFlagsVariable());
+        if (FlagsVar == nullptr)
+        {
+            return nullptr;
+        }
+    }
+    if (mCursor.hasError())
+    {
+        return nullptr;
+    }
+
+    // Rebuild the instruction
+    auto getConstantInt = [&Operands](size_t Index) -> ConstantInt * {
+        return Index < Operands.size() ? unknown::dyn_cast_or_null<ConstantInt>(Operands[Index]) : nullptr;
+    };
+    auto getSuccessor = [&Successors](size_t Index) -> BasicBlock * {
+        // A conditional branch to the same block keeps a single successor
+        return Successors.empty() ? nullptr : Successors[std::min(Index, Successors.size() - 1)];
+    };
+
+    Instruction *I = nullptr;
+    switch (OpCodeId)
+    {
+    case OpCodeID::Unknown: {
+        auto UnknownStr = mCursor.readString();
+        if (!mCursor.hasError())
+        {
+            I = UnknownInstruction::get(mContext, UnknownStr);
+        }
+        break;
+    }
+    case OpCodeID::Load: {
+        if (Operands.size() == 1)
+        {
+            I = LoadInstruction::get(Operands[0]);
+        }
+        break;
+    }
+    case OpCodeID::Store: {
+        auto IsVolatile = mCursor.readByte() != 0;
+        if (Operands.size() == 2 && !mCursor.hasError())
+        {
+            I = StoreInstruction::get(mContext, Operands[0], Operands[1], IsVolatile);
+        }
+        break;
+    }
+    case OpCodeID::GetBitPtr: {
+        auto PtrTy = unknown::dyn_cast<PointerType>(Ty);
+        if (PtrTy && Operands.size() == 2)
+        {
+            I = GetBitPtrInstruction::get(PtrTy, Operands[0], Operands[1]);
+        }
+        break;
+    }
+    case OpCodeID::Ret: {
+        I = ReturnInstruction::get(mContext);
+        break;
+    }
+    case OpCodeID::RetIMM: {
+        if (auto CI = getConstantInt(0))
+        {
+            I = ReturnImmInstruction::get(mContext, CI);
+        }
+        break;
+    }
+    case OpCodeID::JmpAddr: {
+        if (auto CI = getConstantInt(0))
+        {
+            I = JmpAddrInstruction::get(mContext, CI);
+        }
+        break;
+    }
+    case OpCodeID::JmpBB: {
+        if (auto DestBB = getSuccessor(0))
+        {
+            I = JmpBBInstruction::get(mContext, DestBB);
+        }
+        break;
+    }
+    case OpCodeID::JccAddr: {
+        auto DestCI = getConstantInt(0);
+        auto NormalCI = getConstantInt(1);
+        if (DestCI && NormalCI)
+        {
+            I = JccAddrInstruction::get(mContext, DestCI, NormalCI, FlagsVar.release());
+        }
+        break;
+    }
+    case OpCodeID::JccBB: {
+        auto DestBB = getSuccessor(0);
+        auto NormalBB = getSuccessor(1);
+        if (DestBB && NormalBB)
+        {
+            I = JccBBInstruction::get(mContext, DestBB, NormalBB, FlagsVar.release());
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (I == nullptr)
+    {
+        return nullptr;
+    }
+    own(I);
+
+    if (FlagsVar)
+    {
+        I->setFlagsVariableAndUpdateUsers(FlagsVar.release());
+    }
+
+    // The rebuilt instruction must match what was written
+    if (!std::equal(I->op_begin(), I->op_end(), Operands.begin(), Operands.end()))
+    {
+        return nullptr;
+    }
+    if (auto TI = unknown::dyn_cast<TerminatorInstruction>(I))
+    {
+        if (TI->getSuccessorsList() != Successors)
+        {
+            return nullptr;
+        }
+    }
+    else if (!Successors.empty())
+    {
+        return nullptr;
+    }
+
+    // The strings of the string table are followed by a NUL
+    I->setType(Ty);
+    I->setName(Name.data());
+    I->setInstructionAddress(Address);
+    I->enablePrintOp(PrintOp);
+
+    return I;
+}
+
+// Read a flags variable
+FlagsVariable *
+FunctionBodyReader::readFlagsVariable()
+{
+    auto Ty = mCursor.readType();
+    auto Name = mCursor.readString();
+    auto FlagsValue = mCursor.readULEB();
+    if (mCursor.hasError())
+    {
+        return nullptr;
+    }
+
+    auto FlagsVar = FlagsVariable::get(Ty);
+    FlagsVar->setName(Name.data());
+    FlagsVar->setFlagsValue(FlagsValue);
+    return FlagsVar;
+}
+
+// Read an address, as the delta to a nearby address if the options ask for it
+uint64_t
+FunctionBodyReader::readAddress(uint64_t Base)
+{
+    if (mOptions.mDeltaAddresses)
+    {
+        return Base + mCursor.readSLEB();
+    }
+    return mCursor.readULEB();
+}
+
+// Take the ownership of a value until the function is complete
+Value *
+FunctionBodyReader::own(Value *V)
+{
+    mOwnedValues.push_back(V);
+    mValues.push_back(V);
+    return V;
+}
+
+} // namespace uir
@@ -0,0 +1,333 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <UnknownIR/Function.h>
+#include <UnknownIR/GlobalVariable.h>
+#include <UnknownIR/OpCode.h>
+
+#include <unknown/ADT/APInt.h>
+#include <unknown/ADT/DenseMap.h>
+#include <unknown/ADT/SmallPtrSet.h>
+#include <unknown/ADT/StringMap.h>
+#include <unknown/ADT/StringRef.h>
+#include <unknown/Support/raw_ostream.h>
+
+namespace uir {
+
+class FlagsVariable;
+
+// The layout of a binary module file:
+//   magic, version
+//   the bodies of the functions
+//   the string table
+//   the type table
+//   the module record: name, arch, mode, global variables and the index of the functions
+//   the footer: the offsets of the string table, the type table and the module record
+// The strings and the types are referenced by their index in the tables, the index of the functions gives the offset
+// and the size of each body, so a reader can load the bodies one by one.
+
+// The magic of the binary module files
+constexpr char UIRBinaryMagic[4] = {'U', 'I', 'R', 'B'};
+
+// Bump it whenever the layout of the binary module files changes
+constexpr uint32_t UIRBinaryVersion = 1;
+
+// The size of the magic and the version
+constexpr size_t UIRBinaryHeaderSize = sizeof(UIRBinaryMagic) + sizeof(uint32_t);
+
+// The size of the footer, three 64-bit offsets
+constexpr size_t UIRBinaryFooterSize = 3 * sizeof(uint64_t);
+
+// The size of the footer of a function body written by Function::writeBinaryBody, the offsets of its two tables
+constexpr size_t UIRBinaryBodyFooterSize = 2 * sizeof(uint64_t);
+
+// The widest integer a binary module may describe
+constexpr uint64_t UIRBinaryMaxIntegerBits = 1 << 16;
+
+// The kinds of the global variables of the module record
+enum class BinaryGlobalKind : uint8_t
+{
+    GlobalVariable,
+    GlobalArray
+};
+
+// The kinds of the entries in the value table of a function body
+enum class BinaryValueKind : uint8_t
+{
+    ConstantInt,
+    LocalVariable,
+    GlobalVariable,
+    ModuleGlobalVariable,
+    FlagsVariable,
+    Argument,
+    FunctionContext,
+    Constant,
+    Instruction
+};
+
+// The bits of the flags of a function
+enum BinaryFunctionFlags : uint8_t
+{
+    BinaryFunctionSEH = 1 << 0,
+    BinaryFunctionAsyncEH = 1 << 1,
+    BinaryFunctionNaked = 1 << 2
+};
+
+// Only the instructions that can be rebuilt from their operands are written
+inline bool
+isBinarySupportedOpCode(OpCodeID OpCodeId)
+{
+    switch (OpCodeId)
+    {
+    case OpCodeID::Unknown:
+    case OpCodeID::Load:
+    case OpCodeID::Store:
+    case OpCodeID::GetBitPtr:
+    case OpCodeID::Ret:
+    case OpCodeID::RetIMM:
+    case OpCodeID::JmpAddr:
+    case OpCodeID::JmpBB:
+    case OpCodeID::JccAddr:
+    case OpCodeID::JccBB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+////////////////////////////////////////////////////////////
+// Write
+// Write an unsigned LEB128
+void
+writeBinaryULEB(unknown::raw_ostream &OS, uint64_t Value);
+
+// Write a signed LEB128, the addresses are written as the delta to a nearby address
+void
+writeBinarySLEB(unknown::raw_ostream &OS, int64_t Value);
+
+// Write a 64-bit little-endian integer
+void
+writeBinaryU64(unknown::raw_ostream &OS, uint64_t Value);
+
+////////////////////////////////////////////////////////////
+// BinaryTables
+// The strings and the types of the bodies, numbered in the order they are first used
+class BinaryTables
+{
+private:
+    unknown::StringMap<uint64_t> mStringIDs;
+    std::vector<unknown::StringRef> mStrings;
+    unknown::DenseMap<const Type *, uint64_t> mTypeIDs;
+    std::vector<const Type *> mTypes;
+
+public:
+    BinaryTables();
+
+public:
+    // Get the index of a string, it is added to the table on first use
+    uint64_t getStringID(unknown::StringRef Str);
+
+    // Get the index of a type, it is added to the table after the types it refers to
+    std::optional<uint64_t> getTypeID(const Type *Ty);
+
+public:
+    // Write the string table, each string is followed by a NUL so the reader can use it in place
+    void writeStringTable(unknown::raw_ostream &OS) const;
+
+    // Write the type table
+    void writeTypeTable(unknown::raw_ostream &OS) const;
+};
+
+////////////////////////////////////////////////////////////
+// BinaryCursor
+// Read the integers and the table indices of a range of the file, every read is checked against the end of the range.
+// A failed read sets the error and returns 0, so the callers only check the error once per record.
+class BinaryCursor
+{
+private:
+    const uint8_t *mPtr;
+    const uint8_t *mEnd;
+    const std::vector<unknown::StringRef> &mStrings;
+    const std::vector<Type *> &mTypes;
+    bool mError;
+
+public:
+    BinaryCursor(
+        unknown::StringRef Buffer,
+        const std::vector<unknown::StringRef> &Strings,
+        const std::vector<Type *> &Types);
+
+public:
+    // Has a read failed?
+    bool hasError() const { return mError; }
+
+    // Is the whole range read?
+    bool atEnd() const { return mPtr == mEnd; }
+
+    // Mark the range as invalid
+    bool fail();
+
+    // Read a byte
+    uint8_t readByte();
+
+    // Read an unsigned LEB128
+    uint64_t readULEB();
+
+    // Read a signed LEB128
+    int64_t readSLEB();
+
+    // Read the number of entries, each entry takes at least one byte
+    uint64_t readCount();
+
+    // Read the bytes of a string of the string table, the string is followed by a NUL
+    unknown::StringRef readStringData();
+
+    // Read the index of a string, the string points into the file
+    unknown::StringRef readString();
+
+    // Read the index of a type
+    Type *readType();
+
+    // Read the comment and the extra info of a value
+    void readAnnotation(Value *V);
+
+    // Read an APInt
+    std::optional<unknown::APInt> readAPInt();
+};
+
+// Read the string table, the strings point into the buffer
+bool
+readBinaryStringTable(unknown::StringRef Buffer, std::vector<unknown::StringRef> &Strings);
+
+// Read the type table, a pointer type refers to a type before it
+bool
+readBinaryTypeTable(
+    Context &C,
+    unknown::StringRef Buffer,
+    const std::vector<unknown::StringRef> &Strings,
+    std::vector<Type *> &Types);
+
+////////////////////////////////////////////////////////////
+// FunctionBodyWriter
+// Serialize the basic blocks of a function, for the binary modules and for Function::writeBinaryBody.
+// The values are written in dependency order, so that the reader can rebuild every value from values it already has.
+class FunctionBodyWriter
+{
+private:
+    BinaryTables &mTables;
+    const unknown::DenseMap<const GlobalVariable *, uint64_t> &mGlobalVariableIDs;
+    const Function &mFunction;
+    unknown::raw_ostream &mOS;
+    BinaryBodyOptions mOptions;
+    unknown::DenseMap<const BasicBlock *, uint64_t> mBlockIDs;
+    unknown::DenseMap<const Value *, uint64_t> mValueIDs;
+    unknown::SmallPtrSet<const Value *, 16> mVisiting;
+    std::vector<const Value *> mValues;
+    uint64_t mLastAddress;
+
+public:
+    // GlobalVariableIDs are the global variables of the module record, the others are written in the body
+    FunctionBodyWriter(
+        BinaryTables &Tables,
+        const unknown::DenseMap<const GlobalVariable *, uint64_t> &GlobalVariableIDs,
+        const Function &F,
+        unknown::raw_ostream &OS,
+        const BinaryBodyOptions &Options);
+
+public:
+    // Write the body of the function, returns false if it has something that can not be written
+    bool write();
+
+private:
+    // Get the kind of a value
+    std::optional<BinaryValueKind> getValueKind(const Value *V) const;
+
+    // Collect the value after its operands
+    bool collectValue(const Value *V);
+
+    // Write one entry of the value table
+    bool writeValue(const Value *V);
+
+    // Write an instruction
+    bool writeInstruction(const Instruction *I);
+
+    // Write a flags variable
+    bool writeFlagsVariable(const FlagsVariable *FlagsVar);
+
+    // Write an address, as the delta to a nearby address if the options ask for it
+    void writeAddress(uint64_t Address, uint64_t Base);
+
+    // Write the comment and the extra info of a value
+    void writeAnnotation(const Value *V);
+
+    // Write the index of a type
+    bool writeType(const Type *Ty);
+
+    // Write an APInt
+    void writeAPInt(const unknown::APInt &Val);
+
+    // Write the index of a string
+    void writeString(unknown::StringRef Str);
+};
+
+////////////////////////////////////////////////////////////
+// FunctionBodyReader
+// Rebuild the basic blocks of a function written by FunctionBodyWriter.
+// Nothing is attached to the function until the whole body has been read.
+class FunctionBodyReader
+{
+private:
+    Context &mContext;
+    Function &mFunction;
+    BinaryCursor mCursor;
+    const std::vector<GlobalVariable *> &mGlobalVariables;
+    BinaryBodyOptions mOptions;
+    uint64_t mLastAddress;
+    std::vector<BasicBlock *> mBlocks;
+    std::vector<Value *> mValues;
+    std::vector<Value *> mOwnedValues;
+    std::vector<GlobalVariable *> mGlobalVariablesToOwn;
+    std::vector<std::vector<Instruction *>> mBlockInstructions;
+    std::vector<std::vector<BasicBlock *>> mBlockPredecessors;
+
+public:
+    FunctionBodyReader(
+        Function &F,
+        unknown::StringRef Body,
+        const std::vector<unknown::StringRef> &Strings,
+        const std::vector<Type *> &Types,
+        const std::vector<GlobalVariable *> &GlobalVariables,
+        const BinaryBodyOptions &Options);
+    ~FunctionBodyReader();
+
+public:
+    // Read the body, returns false if it is corrupted
+    bool read();
+
+private:
+    // Read one entry of the value table
+    bool readValue();
+
+    // Read an instruction
+    Instruction *readInstruction();
+
+    // Read a flags variable
+    FlagsVariable *readFlagsVariable();
+
+    // Read an address, as the delta to a nearby address if the options ask for it
+    uint64_t readAddress(uint64_t Base);
+
+    // Get a value that was already read
+    Value *getValue(uint64_t ValueID) { return ValueID < mValues.size() ? mValues[ValueID] : nullptr; }
+
+    // Get a basic block
+    BasicBlock *getBlock(uint64_t BlockID) { return BlockID < mBlocks.size() ? mBlocks[BlockID] : nullptr; }
+
+    // Take the ownership of a value until the function is complete
+    Value *own(Value *V);
+};
+
+} // namespace uir
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+#include <UnknownUtils/unknown/ADT/SmallString.h>
+#include <UnknownUtils/unknown/Support/NativeFormatting.h>
+#include <UnknownUtils/unknown/Support/raw_ostream.h>
+#include <unknown/tinyxml2/tinyxml2.h>
+
+namespace uir {
+
+// Push an attribute formatted as 0x{:X}
+inline void
+pushHexAttribute(unknown::XMLPrinter &Printer, const char *Name, uint64_t Value)
+{
+    unknown::SmallString<32> Buffer;
+    unknown::raw_svector_ostream OS(Buffer);
+    unknown::write_hex(OS, Value, unknown::HexPrintStyle::PrefixUpper);
+    Printer.PushAttribute(Name, Buffer.c_str());
+}
+
+// Push an attribute formatted as 0x{:X}-0x{:X}
+inline void
+pushRangeAttribute(unknown::XMLPrinter &Printer, const char *Name, uint64_t Begin, uint64_t End)
+{
+    unknown::SmallString<64> Buffer;
+    unknown::raw_svector_ostream OS(Buffer);
+    unknown::write_hex(OS, Begin, unknown::HexPrintStyle::PrefixUpper);
+    OS << '-';
+    unknown::write_hex(OS, End, unknown::HexPrintStyle::PrefixUpper);
+    Printer.PushAttribute(Name, Buffer.c_str());
+}
+
+// Push an attribute printed by a callback, the short values are printed on the stack
+template <typename PrintFnT>
+inline void
+pushPrintedAttribute(unknown::XMLPrinter &Printer, const char *Name, PrintFnT PrintFn, bool SkipEmpty = false)
+{
+    unknown::SmallString<128> Buffer;
+    unknown::raw_svector_ostream OS(Buffer);
+    PrintFn(OS);
+    if (SkipEmpty && Buffer.empty())
+    {
+        return;
+    }
+
+    Printer.PushAttribute(Name, Buffer.c_str());
+}
+
+} // namespace uir
@@ -11,18 +11,18 @@ namespace uir {
 //     LocalVariable
 //
 LocalVariable::LocalVariable(Type *Ty) :
-    LocalVariable(
-        Ty,
-        Ty == Type::getVoidTy(Ty->getContext()) ? "LocalVoid" : generateOrderedLocalVarName(Ty->getContext()),
-        0)
+    LocalVariable(Ty, Ty == Type::getVoidTy(Ty->getContext()) ? "LocalVoid" : "", 0)
 {
-    //
+    if (Ty != Type::getVoidTy(Ty->getContext()))
+    {
+        setName("", generateOrderedLocalVarIndex(Ty->getContext()));
+    }
 }
 
 LocalVariable::LocalVariable(Type *Ty, const unknown::StringRef &LocalVariableName, uint64_t LocalVariableAddress) :
     Constant(Ty, LocalVariableName), mLocalVariableAddress(LocalVariableAddress)
 {
-    //
+    mValueID = LocalVariableVal;
 }
 
 LocalVariable::~LocalVariable()
@@ -52,21 +52,27 @@ LocalVariable::setLocalVariableAddress(uint64_t LocalVariableAddress)
 std::string
 LocalVariable::generateOrderedLocalVarName(Context &C)
 {
-    auto CurIdx = C.mImpl->mOrderedLocalVarNameIndex++;
-    return std::to_string(CurIdx);
+    return std::to_string(generateOrderedLocalVarIndex(C));
+}
+
+// Generate a new value index by order, the value is named after it
+uint32_t
+LocalVariable::generateOrderedLocalVarIndex(Context &C)
+{
+    return static_cast<uint32_t>(C.mImpl->getFunctionNameIndex().mOrderedLocalVarNameIndex++);
 }
 
 // Allocate a LocalVariable
 LocalVariable *
 LocalVariable::get(Type *Ty, const unknown::StringRef &LocalVariableName, uint64_t LocalVariableAddress)
 {
-    return new LocalVariable(Ty, LocalVariableName, LocalVariableAddress);
+    return construct<LocalVariable>(Ty->getContext(), Ty, LocalVariableName, LocalVariableAddress);
 }
 
 LocalVariable *
 LocalVariable::get(Type *Ty)
 {
-    return new LocalVariable(Ty);
+    return construct<LocalVariable>(Ty->getContext(), Ty);
 }
 
 } // namespace uir
@@ -1,10 +1,21 @@
 #include <Module.h>
+#include <XMLStreamPrinter.h>
 
 #include <Context.h>
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
 
+#include <unknown/ADT/SmallPtrSet.h>
+#include <unknown/Support/FileSystem.h>
+#include <unknown/Support/ThreadPool.h>
+#include <unknown/Support/Threading.h>
+#include <unknown/Support/ToolOutputFile.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace uir {
 
 ////////////////////////////////////////////////////////////
@@ -21,6 +32,7 @@ Module::Module(Context &C, const unknown::StringRef &ModuleName) : mContext(C),
 
 Module::~Module()
 {
+    // The functions built in an arena release their values in one step
     clearAllFunctions();
     clearAllGlobalVariables();
 }
@@ -62,6 +74,24 @@ Module::getContext() const
     return mContext;
 }
 
+////////////////////////////////////////////////////////////
+// Arena
+// Get the number of bytes allocated from the arenas of the functions
+size_t
+Module::getArenaBytesAllocated() const
+{
+    size_t BytesAllocated = 0;
+    for (auto F : *this)
+    {
+        if (F)
+        {
+            BytesAllocated += F->getArenaBytesAllocated();
+        }
+    }
+
+    return BytesAllocated;
+}
+
 ////////////////////////////////////////////////////////////
 // Get/Set
 // Get/Set the name of module
@@ -192,6 +222,16 @@ Module::dropAllReferences()
 void
 Module::clearAllFunctions()
 {
+    // The blocks of the arenas are dropped before any function is freed, so the uses of the values of another function
+    // are unlinked while those values are alive
+    for (auto F : *this)
+    {
+        if (F)
+        {
+            F->dropArenaValues();
+        }
+    }
+
     for (auto F : *this)
     {
         if (F)
@@ -210,14 +250,13 @@ Module::clearAllFunctions()
     }
 
     // Free all functions
-    std::vector<Function *> FreeFunctionList;
+    unknown::SmallPtrSet<Function *, 16> FreeFunctionList;
     for (auto F : *this)
     {
         if (F)
         {
-            if (std::find(FreeFunctionList.begin(), FreeFunctionList.end(), F) == FreeFunctionList.end())
+            if (FreeFunctionList.insert(F).second)
             {
-                FreeFunctionList.push_back(F);
                 delete F;
             }
         }
@@ -241,15 +280,14 @@ Module::clearAllGlobalVariables()
     }
 
     // Free all global variables
-    std::vector<GlobalVariable *> FreeGVList;
+    unknown::SmallPtrSet<GlobalVariable *, 16> FreeGVList;
     for (auto It = global_begin(); It != global_end(); ++It)
     {
         auto GV = *It;
         if (GV)
         {
-            if (std::find(FreeGVList.begin(), FreeGVList.end(), GV) == FreeGVList.end())
+            if (FreeGVList.insert(GV).second)
             {
-                FreeGVList.push_back(GV);
                 delete GV;
             }
         }
@@ -295,14 +333,118 @@ Module::getPropertyMode() const
 void
 Module::print(unknown::raw_ostream &OS, bool NewLine) const
 {
-    unknown::XMLPrinter Printer;
+    XMLStreamPrinter Printer(OS);
     print(Printer);
-    OS << Printer.CStr();
 }
 
 // Print the module
 void
 Module::print(unknown::XMLPrinter &Printer) const
+{
+    printHeader(Printer);
+
+    // function
+    for (auto F : *this)
+    {
+        if (F == nullptr)
+        {
+            continue;
+        }
+
+        F->print(Printer);
+    }
+
+    Printer.CloseElement();
+}
+
+// Print the module, the functions are printed on NumThreads threads, 0 means all hardware threads.
+void
+Module::printParallel(unknown::raw_ostream &OS, uint32_t NumThreads) const
+{
+    if (NumThreads == 0)
+    {
+        NumThreads = unknown::hardware_concurrency();
+    }
+
+    std::vector<const Function *> Functions;
+    for (auto F : *this)
+    {
+        if (F)
+        {
+            Functions.push_back(F);
+        }
+    }
+
+    if (NumThreads <= 1 || Functions.size() <= 1)
+    {
+        print(OS);
+        return;
+    }
+
+    XMLStreamPrinter Printer(OS);
+    printHeader(Printer);
+
+    // One slot per function, so the functions are written in module order.
+    // The workers stay within a window of the next function to write, which bounds the text held in memory.
+    const size_t Window = NumThreads * 4;
+    std::vector<std::string> Texts(Functions.size());
+    std::vector<bool> Printed(Functions.size(), false);
+    std::atomic<size_t> NextIndex = 0;
+    size_t NextWriteIndex = 0;
+    std::mutex Mutex;
+    std::condition_variable CV;
+
+    unknown::ThreadPool Pool(NumThreads);
+    for (uint32_t i = 0; i < NumThreads; ++i)
+    {
+        Pool.async([&]() {
+            for (size_t Index = NextIndex++; Index < Functions.size(); Index = NextIndex++)
+            {
+                {
+                    std::unique_lock<std::mutex> Lock(Mutex);
+                    CV.wait(Lock, [&]() { return Index < NextWriteIndex + Window; });
+                }
+
+                // The functions are children of the module
+                std::string Text;
+                {
+                    unknown::raw_string_ostream FunctionOS(Text);
+                    XMLStreamPrinter FunctionPrinter(FunctionOS, 1);
+                    Functions[Index]->print(FunctionPrinter);
+                }
+
+                {
+                    std::lock_guard<std::mutex> Lock(Mutex);
+                    Texts[Index] = std::move(Text);
+                    Printed[Index] = true;
+                }
+                CV.notify_all();
+            }
+        });
+    }
+
+    // Write the functions on this thread, so the output stream does not need to be thread-safe
+    while (NextWriteIndex < Functions.size())
+    {
+        std::string Text;
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            CV.wait(Lock, [&]() { return Printed[NextWriteIndex]; });
+            Text = std::move(Texts[NextWriteIndex]);
+            ++NextWriteIndex;
+        }
+        CV.notify_all();
+
+        Printer.pushPrintedElement(Text);
+    }
+    Pool.wait();
+
+    Printer.CloseElement();
+}
+
+// Print the start tag, the attributes and the global variables of the module
+void
+Module::printHeader(unknown::XMLPrinter &Printer) const
 {
     Printer.OpenElement(getPropertyModule().data());
 
@@ -332,19 +474,29 @@ Module::print(unknown::XMLPrinter &Printer) const
 
         GV->print(Printer);
     }
+}
 
-    // function
-    for (auto F : *this)
+// Print the module to a file on NumThreads threads, the file is only kept if the whole module is written
+bool
+Module::printToFile(const unknown::StringRef &FilePath, uint32_t NumThreads) const
+{
+    std::error_code EC;
+    unknown::ToolOutputFile Out(FilePath, EC, unknown::sys::fs::OF_Text);
+    if (EC)
     {
-        if (F == nullptr)
-        {
-            continue;
-        }
+        return false;
+    }
 
-        F->print(Printer);
+    printParallel(Out.os(), NumThreads);
+    Out.os().close();
+    if (Out.os().has_error())
+    {
+        Out.os().clear_error();
+        return false;
     }
 
-    Printer.CloseElement();
+    Out.keep();
+    return true;
 }
 
 ////////////////////////////////////////////////////////////
@@ -0,0 +1,394 @@
+#include <ModuleReader.h>
+#include <Argument.h>
+#include <FunctionContext.h>
+
+#include <Internal/InternalBinary/InternalBinary.h>
+
+#include <unknown/Support/Endian.h>
+
+#include <cstring>
+
+namespace uir {
+
+namespace {
+
+// Read the elements of a global array and create it
+template <typename T>
+GlobalVariable *
+readGlobalArray(BinaryCursor &Cursor, Context &C, Type *ElementTy, unknown::StringRef Name, uint64_t Address)
+{
+    typename GlobalArray<T>::GlobalArrayType Elements(Cursor.readCount());
+    for (auto &Element : Elements)
+    {
+        Element = static_cast<T>(Cursor.readULEB());
+    }
+    if (Cursor.hasError())
+    {
+        return nullptr;
+    }
+
+    return GlobalArray<T>::get(C, ElementTy, Elements, Name, Address);
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////
+//     ModuleReader
+//
+
+////////////////////////////////////////////////////////////
+// Ctor/Dtor
+ModuleReader::ModuleReader(Context &C, std::unique_ptr<unknown::MemoryBuffer> Buffer) :
+    mContext(C), mBuffer(std::move(Buffer))
+{
+    assert(mBuffer);
+}
+
+ModuleReader::~ModuleReader()
+{
+    //
+}
+
+////////////////////////////////////////////////////////////
+// Get/Set
+// Get the module, nullptr once it is taken
+Module *
+ModuleReader::getModule() const
+{
+    return mModule.get();
+}
+
+// Take the module, all functions are materialized first. Returns nullptr if one of them can not be read.
+std::unique_ptr<Module>
+ModuleReader::takeModule()
+{
+    if (!materializeAll())
+    {
+        return nullptr;
+    }
+
+    mFunctionEntries.clear();
+    mFunctionIndices.clear();
+    mGlobalVariables.clear();
+    return std::move(mModule);
+}
+
+////////////////////////////////////////////////////////////
+// Materialize
+// Are the basic blocks of the function read?
+bool
+ModuleReader::isMaterialized(const Function *F) const
+{
+    auto It = mFunctionIndices.find(F);
+    return It == mFunctionIndices.end() || mFunctionEntries[It->second].mMaterialized;
+}
+
+// Read the basic blocks of a function of the module, returns false if its body is corrupted
+bool
+ModuleReader::materialize(Function *F)
+{
+    auto It = mFunctionIndices.find(F);
+    if (It == mFunctionIndices.end())
+    {
+        return false;
+    }
+
+    auto &Entry = mFunctionEntries[It->second];
+    if (Entry.mMaterialized)
+    {
+        return true;
+    }
+
+    // The values of the body live in the arena of the function
+    Function::ArenaScope Scope(*F);
+    auto Body = mBuffer->getBuffer().substr(Entry.mBodyOffset, Entry.mBodySize);
+    FunctionBodyReader Reader(*F, Body, mStrings, mTypes, mGlobalVariables, {});
+    if (!Reader.read())
+    {
+        return false;
+    }
+
+    Entry.mMaterialized = true;
+    return true;
+}
+
+// Read the basic blocks of all functions of the module
+bool
+ModuleReader::materializeAll()
+{
+    for (auto &Entry : mFunctionEntries)
+    {
+        if (!materialize(Entry.mFunction))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////
+// Read
+// Read the string table, the type table and the module record
+bool
+ModuleReader::readModule()
+{
+    auto Buffer = mBuffer->getBuffer();
+    if (Buffer.size() < UIRBinaryHeaderSize + UIRBinaryFooterSize ||
+        std::memcmp(Buffer.data(), UIRBinaryMagic, sizeof(UIRBinaryMagic)) != 0 ||
+        unknown::support::endian::read32le(Buffer.data() + sizeof(UIRBinaryMagic)) != UIRBinaryVersion)
+    {
+        return false;
+    }
+
+    // Footer
+    auto Footer = Buffer.data() + Buffer.size() - UIRBinaryFooterSize;
+    uint64_t StringTableOffset = unknown::support::endian::read64le(Footer);
+    uint64_t TypeTableOffset = unknown::support::endian::read64le(Footer + sizeof(uint64_t));
+    uint64_t ModuleRecordOffset = unknown::support::endian::read64le(Footer + 2 * sizeof(uint64_t));
+    uint64_t FooterOffset = Buffer.size() - UIRBinaryFooterSize;
+    if (StringTableOffset < UIRBinaryHeaderSize || StringTableOffset > TypeTableOffset ||
+        TypeTableOffset > ModuleRecordOffset || ModuleRecordOffset > FooterOffset)
+    {
+        return false;
+    }
+
+    // String table and type table
+    if (!readBinaryStringTable(Buffer.slice(StringTableOffset, TypeTableOffset), mStrings) ||
+        !readBinaryTypeTable(mContext, Buffer.slice(TypeTableOffset, ModuleRecordOffset), mStrings, mTypes))
+    {
+        return false;
+    }
+
+    // Module record
+    BinaryCursor Cursor(Buffer.slice(ModuleRecordOffset, FooterOffset), mStrings, mTypes);
+    auto ModuleName = Cursor.readString();
+    auto Arch = Cursor.readULEB();
+    auto Mode = Cursor.readULEB();
+    if (Cursor.hasError() || Arch != static_cast<uint32_t>(mContext.getArch()) ||
+        Mode != static_cast<uint32_t>(mContext.getMode()))
+    {
+        return false;
+    }
+    mModule = Module::get(mContext, ModuleName);
+
+    // Global variables
+    auto NumGlobalVariables = Cursor.readCount();
+    mGlobalVariables.reserve(NumGlobalVariables);
+    for (uint64_t Index = 0; Index < NumGlobalVariables && !Cursor.hasError(); ++Index)
+    {
+        auto Kind = static_cast<BinaryGlobalKind>(Cursor.readByte());
+        auto Ty = Cursor.readType();
+        auto Name = Cursor.readString();
+        auto Address = Cursor.readULEB();
+        if (Cursor.hasError())
+        {
+            return false;
+        }
+
+        GlobalVariable *GV = nullptr;
+        if (Kind == BinaryGlobalKind::GlobalVariable)
+        {
+            GV = GlobalVariable::get(Ty, Name, Address);
+        }
+        else if (auto PtrTy = unknown::dyn_cast<PointerType>(Ty); PtrTy && Kind == BinaryGlobalKind::GlobalArray)
+        {
+            // The element size tells the arrays apart
+            auto ElementTy = PtrTy->getElementType();
+            switch (ElementTy->getTypeSize())
+            {
+            case sizeof(uint8_t):
+                GV = readGlobalArray<uint8_t>(Cursor, mContext, ElementTy, Name, Address);
+                break;
+            case sizeof(uint16_t):
+                GV = readGlobalArray<uint16_t>(Cursor, mContext, ElementTy, Name, Address);
+                break;
+            case sizeof(uint32_t):
+                GV = readGlobalArray<uint32_t>(Cursor, mContext, ElementTy, Name, Address);
+                break;
+            case sizeof(uint64_t):
+                GV = readGlobalArray<uint64_t>(Cursor, mContext, ElementTy, Name, Address);
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (GV == nullptr)
+        {
+            return false;
+        }
+        mModule->insertGlobalVariable(GV);
+        mGlobalVariables.push_back(GV);
+        Cursor.readAnnotation(GV);
+    }
+
+    // The index of the functions, the bodies lie between the header and the string table
+    auto NumFunctions = Cursor.readCount();
+    mFunctionEntries.reserve(NumFunctions);
+    for (uint64_t Index = 0; Index < NumFunctions && !Cursor.hasError(); ++Index)
+    {
+        auto FunctionName = Cursor.readString();
+        auto Name = Cursor.readString();
+        uint64_t Begin = Cursor.readULEB();
+        uint64_t End = Begin + Cursor.readSLEB();
+        auto Flags = Cursor.readByte();
+        if (Cursor.hasError())
+        {
+            return false;
+        }
+
+        auto F = Function::get(mContext, FunctionName, mModule.get(), Begin, End);
+        mModule->insertFunction(F);
+        if (Name != FunctionName)
+        {
+            F->setName(Name.data());
+        }
+        F->setSEH(Flags & BinaryFunctionSEH);
+        F->setAsyncEH(Flags & BinaryFunctionAsyncEH);
+        F->setNaked(Flags & BinaryFunctionNaked);
+
+        auto NumAttributes = Cursor.readCount();
+        for (uint64_t AttrIndex = 0; AttrIndex < NumAttributes && !Cursor.hasError(); ++AttrIndex)
+        {
+            F->attr_push_back(Cursor.readString().str());
+        }
+        Cursor.readAnnotation(F);
+
+        // The arguments and the function contexts live in the arena of the function, like its body
+        Function::ArenaScope Scope(*F);
+
+        // Arguments
+        auto NumArguments = Cursor.readCount();
+        for (uint64_t ArgIndex = 0; ArgIndex < NumArguments && !Cursor.hasError(); ++ArgIndex)
+        {
+            auto ArgTy = Cursor.readType();
+            auto ArgName = Cursor.readString();
+            auto ArgNo = Cursor.readULEB();
+            if (Cursor.hasError())
+            {
+                return false;
+            }
+
+            auto Arg = Argument::get(ArgTy, ArgName, F, static_cast<uint32_t>(ArgNo));
+            F->insertArgument(Arg);
+            Cursor.readAnnotation(Arg);
+        }
+
+        // Function contexts
+        auto NumFunctionContexts = Cursor.readCount();
+        for (uint64_t FCIndex = 0; FCIndex < NumFunctionContexts && !Cursor.hasError(); ++FCIndex)
+        {
+            auto FCTy = Cursor.readType();
+            auto FCName = Cursor.readString();
+            auto CtxNo = Cursor.readULEB();
+            if (Cursor.hasError())
+            {
+                return false;
+            }
+
+            auto FC = FunctionContext::get(FCTy, FCName, F, static_cast<uint32_t>(CtxNo));
+            F->insertFunctionContext(FC);
+            Cursor.readAnnotation(FC);
+        }
+
+        // Body
+        auto BodyOffset = Cursor.readULEB();
+        auto BodySize = Cursor.readULEB();
+        if (Cursor.hasError() || BodyOffset < UIRBinaryHeaderSize || BodyOffset > StringTableOffset ||
+            BodySize > StringTableOffset - BodyOffset)
+        {
+            return false;
+        }
+
+        mFunctionIndices[F] = mFunctionEntries.size();
+        mFunctionEntries.push_back({F, BodyOffset, BodySize, false});
+    }
+
+    return !Cursor.hasError() && Cursor.atEnd();
+}
+
+////////////////////////////////////////////////////////////
+// Static
+// Open a module in the binary format, returns nullptr if the header or the tables are corrupted
+std::unique_ptr<ModuleReader>
+ModuleReader::get(Context &C, std::unique_ptr<unknown::MemoryBuffer> Buffer)
+{
+    if (Buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto Reader = std::make_unique<ModuleReader>(C, std::move(Buffer));
+    if (!Reader->readModule())
+    {
+        return nullptr;
+    }
+
+    return Reader;
+}
+
+// Open a module file in the binary format, the file is mapped into memory
+std::unique_ptr<ModuleReader>
+ModuleReader::get(Context &C, const unknown::StringRef &FilePath)
+{
+    auto BufferOrErr = unknown::MemoryBuffer::getFile(FilePath, -1, false);
+    if (!BufferOrErr)
+    {
+        return nullptr;
+    }
+
+    return get(C, std::move(*BufferOrErr));
+}
+
+// Read a whole module file in the binary format
+std::unique_ptr<Module>
+ModuleReader::readModuleFile(Context &C, const unknown::StringRef &FilePath)
+{
+    auto Reader = get(C, FilePath);
+    if (Reader == nullptr)
+    {
+        return nullptr;
+    }
+
+    return Reader->takeModule();
+}
+
+////////////////////////////////////////////////////////////
+// Binary
+// Read the basic blocks written by writeBinaryBody with the same options into the empty function.
+// Returns false if the buffer is corrupted, the function is left untouched then.
+bool
+Function::readBinaryBody(unknown::StringRef Buffer, const BinaryBodyOptions &Options)
+{
+    if (!empty() || Buffer.size() < UIRBinaryBodyFooterSize)
+    {
+        return false;
+    }
+
+    // Footer
+    auto Footer = Buffer.data() + Buffer.size() - UIRBinaryBodyFooterSize;
+    uint64_t StringTableOffset = unknown::support::endian::read64le(Footer);
+    uint64_t TypeTableOffset = unknown::support::endian::read64le(Footer + sizeof(uint64_t));
+    uint64_t FooterOffset = Buffer.size() - UIRBinaryBodyFooterSize;
+    if (StringTableOffset > TypeTableOffset || TypeTableOffset > FooterOffset)
+    {
+        return false;
+    }
+
+    // The tables only live as long as the buffer, the values copy the strings they keep
+    std::vector<unknown::StringRef> Strings;
+    std::vector<Type *> Types;
+    if (!readBinaryStringTable(Buffer.slice(StringTableOffset, TypeTableOffset), Strings) ||
+        !readBinaryTypeTable(getContext(), Buffer.slice(TypeTableOffset, FooterOffset), Strings, Types))
+    {
+        return false;
+    }
+
+    // There is no module record, so every global variable is read from the body
+    std::vector<GlobalVariable *> GlobalVariables;
+    FunctionBodyReader Reader(*this, Buffer.take_front(StringTableOffset), Strings, Types, GlobalVariables, Options);
+    return Reader.read();
+}
+
+} // namespace uir
@@ -0,0 +1,340 @@
+#include <Module.h>
+#include <Argument.h>
+#include <FunctionContext.h>
+
+#include <Internal/InternalBinary/InternalBinary.h>
+
+#include <unknown/ADT/SmallString.h>
+#include <unknown/Support/Endian.h>
+#include <unknown/Support/FileSystem.h>
+#include <unknown/Support/ToolOutputFile.h>
+
+#include <vector>
+
+namespace uir {
+
+namespace {
+
+////////////////////////////////////////////////////////////
+// ModuleWriter
+// Serialize a module, the bodies of the functions go first and the tables they use follow them
+class ModuleWriter
+{
+private:
+    // The offset and the size of the body of a function
+    struct FunctionBody
+    {
+        uint64_t mOffset;
+        uint64_t mSize;
+    };
+
+private:
+    const Module &mModule;
+    unknown::raw_ostream &mOS;
+    uint64_t mStartOffset;
+    BinaryTables mTables;
+    unknown::DenseMap<const GlobalVariable *, uint64_t> mGlobalVariableIDs;
+    std::vector<const GlobalVariable *> mGlobalVariables;
+    std::vector<const Function *> mFunctions;
+    std::vector<FunctionBody> mFunctionBodies;
+
+public:
+    ModuleWriter(const Module &M, unknown::raw_ostream &OS) : mModule(M), mOS(OS), mStartOffset(OS.tell()) {}
+
+public:
+    // Write the module, returns false if it has something that can not be written
+    bool write()
+    {
+        // Number the global variables
+        for (auto GV : mModule.getGlobalVariableList())
+        {
+            if (GV && !mGlobalVariableIDs.count(GV))
+            {
+                uint64_t GlobalVariableID = mGlobalVariables.size();
+                mGlobalVariableIDs[GV] = GlobalVariableID;
+                mGlobalVariables.push_back(GV);
+            }
+        }
+
+        // Header
+        mOS.write(UIRBinaryMagic, sizeof(UIRBinaryMagic));
+        char Version[sizeof(uint32_t)];
+        unknown::support::endian::write32le(Version, UIRBinaryVersion);
+        mOS.write(Version, sizeof(Version));
+
+        // Function bodies
+        for (auto F : mModule)
+        {
+            if (F == nullptr)
+            {
+                continue;
+            }
+
+            uint64_t Offset = getOffset();
+            FunctionBodyWriter Writer(mTables, mGlobalVariableIDs, *F, mOS, {});
+            if (!Writer.write())
+            {
+                return false;
+            }
+
+            mFunctions.push_back(F);
+            mFunctionBodies.push_back({Offset, getOffset() - Offset});
+        }
+
+        // The module record adds its strings and types to the tables, so it is written before them
+        unknown::SmallString<0> ModuleRecord;
+        unknown::raw_svector_ostream ModuleRecordOS(ModuleRecord);
+        if (!writeModuleRecord(ModuleRecordOS))
+        {
+            return false;
+        }
+
+        // String table
+        uint64_t StringTableOffset = getOffset();
+        mTables.writeStringTable(mOS);
+
+        // Type table
+        uint64_t TypeTableOffset = getOffset();
+        mTables.writeTypeTable(mOS);
+
+        // Module record
+        uint64_t ModuleRecordOffset = getOffset();
+        mOS << ModuleRecord;
+
+        // Footer
+        writeBinaryU64(mOS, StringTableOffset);
+        writeBinaryU64(mOS, TypeTableOffset);
+        writeBinaryU64(mOS, ModuleRecordOffset);
+        return true;
+    }
+
+private:
+    // Write the module record
+    bool writeModuleRecord(unknown::raw_ostream &OS)
+    {
+        auto &C = mModule.getContext();
+        writeBinaryULEB(OS, mTables.getStringID(mModule.getModuleName()));
+        writeBinaryULEB(OS, static_cast<uint32_t>(C.getArch()));
+        writeBinaryULEB(OS, static_cast<uint32_t>(C.getMode()));
+
+        // Global variables
+        writeBinaryULEB(OS, mGlobalVariables.size());
+        for (auto GV : mGlobalVariables)
+        {
+            if (!writeGlobalVariable(OS, GV))
+            {
+                return false;
+            }
+        }
+
+        // The index of the functions
+        writeBinaryULEB(OS, mFunctions.size());
+        for (size_t Index = 0; Index < mFunctions.size(); ++Index)
+        {
+            if (!writeFunction(OS, mFunctions[Index]))
+            {
+                return false;
+            }
+            writeBinaryULEB(OS, mFunctionBodies[Index].mOffset);
+            writeBinaryULEB(OS, mFunctionBodies[Index].mSize);
+        }
+
+        return true;
+    }
+
+    // Write a global variable of the module
+    bool writeGlobalVariable(unknown::raw_ostream &OS, const GlobalVariable *GV)
+    {
+        auto IsArray = GV->getValueID() == Value::GlobalArrayVal;
+        OS << static_cast<uint8_t>(IsArray ? BinaryGlobalKind::GlobalArray : BinaryGlobalKind::GlobalVariable);
+
+        auto TypeID = mTables.getTypeID(GV->getType());
+        if (!TypeID)
+        {
+            return false;
+        }
+        writeBinaryULEB(OS, *TypeID);
+        writeBinaryULEB(OS, mTables.getStringID(GV->getName()));
+        writeBinaryULEB(OS, GV->getGlobalVariableAddress());
+
+        if (IsArray)
+        {
+            // The element size tells the arrays apart, the pointer arrays are written as integers of the same size
+            switch (unknown::cast<PointerType>(GV->getType())->getElementType()->getTypeSize())
+            {
+            case sizeof(uint8_t):
+                writeElements(OS, unknown::cast<GlobalArray<uint8_t>>(GV)->getGlobalArray());
+                break;
+            case sizeof(uint16_t):
+                writeElements(OS, unknown::cast<GlobalArray<uint16_t>>(GV)->getGlobalArray());
+                break;
+            case sizeof(uint32_t):
+                writeElements(OS, unknown::cast<GlobalArray<uint32_t>>(GV)->getGlobalArray());
+                break;
+            case sizeof(uint64_t):
+                writeElements(OS, unknown::cast<GlobalArray<uint64_t>>(GV)->getGlobalArray());
+                break;
+            default:
+                return false;
+            }
+        }
+
+        writeAnnotation(OS, GV);
+        return true;
+    }
+
+    // Write the elements of a global array
+    template <typename ElementListType>
+    void writeElements(unknown::raw_ostream &OS, const ElementListType &Elements)
+    {
+        writeBinaryULEB(OS, Elements.size());
+        for (auto Element : Elements)
+        {
+            writeBinaryULEB(OS, Element);
+        }
+    }
+
+    // Write the index entry of a function, everything but its basic blocks
+    bool writeFunction(unknown::raw_ostream &OS, const Function *F)
+    {
+        writeBinaryULEB(OS, mTables.getStringID(F->getFunctionName()));
+        writeBinaryULEB(OS, mTables.getStringID(F->getName()));
+        writeBinaryULEB(OS, F->getFunctionBeginAddress());
+        writeBinarySLEB(OS, F->getFunctionEndAddress() - F->getFunctionBeginAddress());
+
+        uint8_t Flags = 0;
+        Flags |= F->hasSEH() ? BinaryFunctionSEH : 0;
+        Flags |= F->hasAsyncEH() ? BinaryFunctionAsyncEH : 0;
+        Flags |= F->hasNaked() ? BinaryFunctionNaked : 0;
+        OS << Flags;
+
+        writeBinaryULEB(OS, F->attr_size());
+        for (auto It = F->attr_begin(); It != F->attr_end(); ++It)
+        {
+            writeBinaryULEB(OS, mTables.getStringID(*It));
+        }
+        writeAnnotation(OS, F);
+
+        // Arguments
+        writeBinaryULEB(OS, F->arg_size());
+        for (auto It = F->arg_begin(); It != F->arg_end(); ++It)
+        {
+            auto Arg = *It;
+            if (Arg == nullptr || !writeFunctionSlot(OS, Arg, Arg->getArgNo()))
+            {
+                return false;
+            }
+        }
+
+        // Function contexts
+        writeBinaryULEB(OS, F->fc_size());
+        for (auto It = F->fc_begin(); It != F->fc_end(); ++It)
+        {
+            auto FC = *It;
+            if (FC == nullptr || !writeFunctionSlot(OS, FC, FC->getCtxNo()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Write an argument or a function context
+    bool writeFunctionSlot(unknown::raw_ostream &OS, const Value *V, uint32_t SlotNo)
+    {
+        auto TypeID = mTables.getTypeID(V->getType());
+        if (!TypeID)
+        {
+            return false;
+        }
+        writeBinaryULEB(OS, *TypeID);
+        writeBinaryULEB(OS, mTables.getStringID(V->getName()));
+        writeBinaryULEB(OS, SlotNo);
+        writeAnnotation(OS, V);
+        return true;
+    }
+
+    // Write the comment and the extra info of a value
+    void writeAnnotation(unknown::raw_ostream &OS, const Value *V)
+    {
+        writeBinaryULEB(OS, mTables.getStringID(V->getComment()));
+        const auto &ExtraInfoList = V->getExtraInfoList();
+        writeBinaryULEB(OS, ExtraInfoList.size());
+        for (const auto &ExtraInfo : ExtraInfoList)
+        {
+            writeBinaryULEB(OS, mTables.getStringID(ExtraInfo));
+        }
+    }
+
+    // Get the offset in the file
+    uint64_t getOffset() const { return mOS.tell() - mStartOffset; }
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////
+// Binary
+// Write the module in the binary format, returns false if the module has something the format can not describe
+bool
+Module::writeBinary(unknown::raw_ostream &OS) const
+{
+    ModuleWriter Writer(*this, OS);
+    return Writer.write();
+}
+
+// Write the module to a file in the binary format, the file is only kept if the whole module is written
+bool
+Module::writeBinaryToFile(const unknown::StringRef &FilePath) const
+{
+    std::error_code EC;
+    unknown::ToolOutputFile Out(FilePath, EC, unknown::sys::fs::OF_None);
+    if (EC)
+    {
+        return false;
+    }
+
+    if (!writeBinary(Out.os()))
+    {
+        return false;
+    }
+
+    Out.os().close();
+    if (Out.os().has_error())
+    {
+        Out.os().clear_error();
+        return false;
+    }
+
+    Out.keep();
+    return true;
+}
+
+// Write the basic blocks of the function in the binary format, followed by the strings and the types they use.
+// Returns false if the function has something the format can not describe.
+bool
+Function::writeBinaryBody(unknown::raw_ostream &OS, const BinaryBodyOptions &Options) const
+{
+    // There is no module record, so every global variable is written in the body
+    uint64_t StartOffset = OS.tell();
+    BinaryTables Tables;
+    unknown::DenseMap<const GlobalVariable *, uint64_t> GlobalVariableIDs;
+    FunctionBodyWriter Writer(Tables, GlobalVariableIDs, *this, OS, Options);
+    if (!Writer.write())
+    {
+        return false;
+    }
+
+    uint64_t StringTableOffset = OS.tell() - StartOffset;
+    Tables.writeStringTable(OS);
+
+    uint64_t TypeTableOffset = OS.tell() - StartOffset;
+    Tables.writeTypeTable(OS);
+
+    // Footer
+    writeBinaryU64(OS, StringTableOffset);
+    writeBinaryU64(OS, TypeTableOffset);
+    return true;
+}
+
+} // namespace uir
@@ -262,50 +262,26 @@ IntegerType *
 IntegerType::get(Context &C, uint32_t NumBits)
 {
     // Check for the built-in integer types
-    if (NumBits == 1)
+    switch (NumBits)
     {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt1Ty(C)))
-        {
-            return IntTy;
-        }
-    }
-    else if (NumBits == 1)
-    {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt8Ty(C)))
-        {
-            return IntTy;
-        }
-    }
-    else if (NumBits == 16)
-    {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt16Ty(C)))
-        {
-            return IntTy;
-        }
-    }
-    else if (NumBits == 32)
-    {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt32Ty(C)))
-        {
-            return IntTy;
-        }
-    }
-    else if (NumBits == 64)
-    {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt64Ty(C)))
-        {
-            return IntTy;
-        }
-    }
-    else if (NumBits == 128)
-    {
-        if (auto IntTy = dynamic_cast<IntegerType *>(Type::getInt128Ty(C)))
-        {
-            return IntTy;
-        }
+    case 1:
+        return &C.mImpl->mInt1Ty;
+    case 8:
+        return &C.mImpl->mInt8Ty;
+    case 16:
+        return &C.mImpl->mInt16Ty;
+    case 32:
+        return &C.mImpl->mInt32Ty;
+    case 64:
+        return &C.mImpl->mInt64Ty;
+    case 128:
+        return &C.mImpl->mInt128Ty;
+    default:
+        break;
     }
 
-    IntegerType *Entry = C.mImpl->mIntegerTypes[NumBits];
+    std::lock_guard<std::mutex> Lock(C.mImpl->mTypesMutex);
+    IntegerType *&Entry = C.mImpl->mIntegerTypes[NumBits];
     if (!Entry)
     {
         // i256/i512
@@ -352,6 +328,7 @@ PointerType::getElementTypeBits() const
 PointerType *
 PointerType::get(Context &C, Type *ElementType)
 {
+    std::lock_guard<std::mutex> Lock(C.mImpl->mTypesMutex);
     auto It = C.mImpl->mPointerTypes.find(ElementType);
     if (It != C.mImpl->mPointerTypes.end())
     {
@@ -0,0 +1,113 @@
+#include <Use.h>
+#include <Value.h>
+
+namespace uir {
+
+////////////////////////////////////////////////////////////
+// Ctor/Dtor
+Use::Use(User *Parent) : Use(Parent, nullptr) {}
+
+Use::Use(User *Parent, Value *Val) : mVal(nullptr), mNext(nullptr), mPrev(nullptr), mParent(Parent)
+{
+    set(Val);
+}
+
+Use::Use(Use &&Other) : mVal(nullptr), mNext(nullptr), mPrev(nullptr), mParent(Other.mParent)
+{
+    takeOver(Other);
+}
+
+Use &
+Use::operator=(Use &&Other)
+{
+    if (this != &Other)
+    {
+        unlink();
+        mParent = Other.mParent;
+        takeOver(Other);
+    }
+
+    return *this;
+}
+
+Use::~Use()
+{
+    unlink();
+}
+
+////////////////////////////////////////////////////////////
+// Get/Set
+// Set the value of this use and move it to the use list of the new value
+void
+Use::set(Value *Val)
+{
+    unlink();
+    mVal = Val;
+    if (Val)
+    {
+        Val->addUse(*this);
+    }
+}
+
+////////////////////////////////////////////////////////////
+// Link/Unlink
+// Unlink this use from the use list of its value, the value stays readable
+void
+Use::unlink()
+{
+    if (mPrev == nullptr)
+    {
+        return;
+    }
+
+    *mPrev = mNext;
+    if (mNext)
+    {
+        mNext->mPrev = mPrev;
+    }
+
+    mNext = nullptr;
+    mPrev = nullptr;
+}
+
+// Link this use at the head of the list
+void
+Use::addToList(Use **List)
+{
+    assert(mPrev == nullptr && "Use is already linked!");
+
+    mNext = *List;
+    if (mNext)
+    {
+        mNext->mPrev = &mNext;
+    }
+
+    mPrev = List;
+    *List = this;
+}
+
+// Take over the value and the list position of another use
+void
+Use::takeOver(Use &Other)
+{
+    assert(mPrev == nullptr && "Use is already linked!");
+
+    mVal = Other.mVal;
+    if (Other.mPrev)
+    {
+        // Replace the other use in place, so the order of the use list is kept
+        mNext = Other.mNext;
+        mPrev = Other.mPrev;
+        *mPrev = this;
+        if (mNext)
+        {
+            mNext->mPrev = &mNext;
+        }
+    }
+
+    Other.mVal = nullptr;
+    Other.mNext = nullptr;
+    Other.mPrev = nullptr;
+}
+
+} // namespace uir
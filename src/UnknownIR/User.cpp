@@ -36,43 +36,55 @@ User::getOperandList() const
 User::op_iterator
 User::op_begin()
 {
-    return mOperandList.begin();
+    return op_iterator(mOperandList.begin());
 }
 
 User::const_op_iterator
 User::op_begin() const
 {
-    return mOperandList.cbegin();
+    return const_op_iterator(mOperandList.begin());
 }
 
 User::op_iterator
 User::op_end()
 {
-    return mOperandList.end();
+    return op_iterator(mOperandList.end());
 }
 
 User::const_op_iterator
 User::op_end() const
 {
-    return mOperandList.cend();
+    return const_op_iterator(mOperandList.end());
+}
+
+unknown::iterator_range<User::op_iterator>
+User::operand_values()
+{
+    return {op_begin(), op_end()};
+}
+
+unknown::iterator_range<User::const_op_iterator>
+User::operand_values() const
+{
+    return {op_begin(), op_end()};
 }
 
 Value *
 User::op_back()
 {
-    return mOperandList.back();
+    return mOperandList.back().get();
 }
 
 Value *
 User::op_front()
 {
-    return mOperandList.front();
+    return mOperandList.front().get();
 }
 
 void
 User::op_push(Value *V)
 {
-    mOperandList.push_back(V);
+    mOperandList.emplace_back(this, V);
 }
 
 void
@@ -90,14 +102,8 @@ User::op_count() const
 void
 User::op_erase(Value *V)
 {
-    for (auto It = mOperandList.begin(); It != mOperandList.end(); ++It)
-    {
-        if (*It == V)
-        {
-            mOperandList.erase(It);
-            --It;
-        }
-    }
+    auto It = std::remove_if(mOperandList.begin(), mOperandList.end(), [V](const Use &U) { return U.get() == V; });
+    mOperandList.erase(It, mOperandList.end());
 }
 
 bool
@@ -118,7 +124,18 @@ User::op_clear()
 void
 User::replaceUsesOfWith(Value *From, Value *To)
 {
-    // nothing
+    if (From == To)
+    {
+        return;
+    }
+
+    for (auto &Op : mOperandList)
+    {
+        if (Op.get() == From)
+        {
+            Op.set(To);
+        }
+    }
 }
 
 // Change all uses of this to point to a new Value.
@@ -131,10 +148,10 @@ User::replaceAllUsesWith(Value *V)
         return;
     }
 
-    // Replace all uses of this value with the new value.
-    for (auto &User : mUsers)
+    // Each use moves to the use list of the new value
+    while (mUseList)
     {
-        User->replaceUsesOfWith(this, V);
+        mUseList->set(V);
     }
 }
 
@@ -147,7 +164,7 @@ User::getOperand(size_t Index) const
     assert(Index < mOperandList.size() && "getOperand() out of range!");
     if (!op_empty())
     {
-        return mOperandList[Index];
+        return mOperandList[Index].get();
     }
 
     return nullptr;
@@ -159,12 +176,27 @@ User::getOperand(size_t Index)
     assert(Index < mOperandList.size() && "getOperand() out of range!");
     if (!op_empty())
     {
-        return mOperandList[Index];
+        return mOperandList[Index].get();
     }
 
     return nullptr;
 }
 
+// Get the use of the operand at the specified index.
+const Use &
+User::getOperandUse(size_t Index) const
+{
+    assert(Index < mOperandList.size() && "getOperandUse() out of range!");
+    return mOperandList[Index];
+}
+
+Use &
+User::getOperandUse(size_t Index)
+{
+    assert(Index < mOperandList.size() && "getOperandUse() out of range!");
+    return mOperandList[Index];
+}
+
 // Set the operand at the specified index.
 void
 User::setOperand(size_t Index, Value *Val)
@@ -175,10 +207,10 @@ User::setOperand(size_t Index, Value *Val)
     }
 
     assert(Index < mOperandList.size() && "setOperand() out of range!");
-    mOperandList[Index] = Val;
+    mOperandList[Index].set(Val);
 }
 
-// Set the operand at the specified index and update the user list.
+// Set the operand at the specified index, the operand must not be null.
 void
 User::setOperandAndUpdateUsers(size_t Index, Value *Val)
 {
@@ -188,33 +220,24 @@ User::setOperandAndUpdateUsers(size_t Index, Value *Val)
     }
 
     assert(Index < mOperandList.size() && "setOperandAndUpdateUsers() out of range!");
-    auto OldVal = mOperandList[Index];
+    auto OldVal = mOperandList[Index].get();
     if (OldVal == Val)
     {
         return;
     }
 
-    // Set operand
-    setOperand(Index, Val);
-
-    // Update user
-    if (OldVal)
-    {
-        OldVal->user_erase(this);
-    }
-    else
+    if (OldVal == nullptr)
     {
         uir_unreachable("OldVal == nullptr in User::setOperandAndUpdateUsers");
     }
 
-    if (Val)
-    {
-        Val->user_insert(this);
-    }
-    else
+    if (Val == nullptr)
     {
         uir_unreachable("Val == nullptr in User::setOperandAndUpdateUsers");
     }
+
+    // Set operand, the use moves to the use list of the new value
+    setOperand(Index, Val);
 }
 
 ////////////////////////////////////////////////////////////
@@ -226,21 +249,17 @@ User::insertOperand(Value *Val)
     op_push(Val);
 }
 
-// Insert the specified value and update the user list.
+// Insert the specified value, the value must not be null.
 void
 User::insertOperandAndUpdateUsers(Value *Val)
 {
-    // Insert the specified value.
-    insertOperand(Val);
-    if (Val)
-    {
-        // Insert user
-        Val->user_insert(this);
-    }
-    else
+    if (Val == nullptr)
     {
         uir_unreachable("Val == nullptr in User::insertOperandAndUpdateUsers");
     }
+
+    // Insert the specified value, the use is linked into its use list.
+    insertOperand(Val);
 }
 
 // Erase the specified value.
@@ -255,7 +274,7 @@ User::eraseOperand(Value *Val)
     op_erase(Val);
 }
 
-// Erase the specified value and update the user list.
+// Erase the specified value, the value must not be null.
 void
 User::eraseOperandAndUpdateUsers(Value *Val)
 {
@@ -264,37 +283,22 @@ User::eraseOperandAndUpdateUsers(Value *Val)
         return;
     }
 
-    // Erase the specified value.
-    eraseOperand(Val);
-    if (Val)
-    {
-        // Erase user
-        if (std::find(op_begin(), op_end(), Val) == op_end())
-        {
-            Val->user_erase(this);
-        }
-    }
-    else
+    if (Val == nullptr)
     {
         uir_unreachable("Val == nullptr in User::eraseOperandAndUpdateUsers");
     }
+
+    // Erase the specified value, the uses are unlinked from its use list.
+    eraseOperand(Val);
 }
 
-// Drop all references to operands.
+// Drop all references to operands, the operands stay readable until they are cleared.
 void
 User::dropAllReferences()
 {
-    if (op_empty())
+    for (auto &Op : mOperandList)
     {
-        return;
-    }
-
-    for (Value *Op : mOperandList)
-    {
-        if (Op)
-        {
-            Op->user_erase(this);
-        }
+        Op.unlink();
     }
 }
 
@@ -3,36 +3,71 @@
 #include <ContextImpl/ContextImpl.h>
 
 #include <Internal/InternalConfig/InternalConfig.h>
+#include <Internal/InternalPrinter/InternalPrinter.h>
+
+#include <unknown/ADT/SmallString.h>
 
 namespace uir {
 ////////////////////////////////////////////////////////////
 // Ctor/Dtor
 Value::Value() : Value(nullptr, "") {}
 
-Value::Value(Type *Ty, const unknown::StringRef &ValueName) : mType(Ty), mValueName(ValueName), mComment("") {}
-
-Value::~Value() {}
+Value::Value(Type *Ty, const unknown::StringRef &ValueName) :
+    mType(Ty),
+    mValueName(nullptr),
+    mUseList(nullptr),
+    mValueID(UserVal),
+    mHasAnnotation(false),
+    mArenaID(0)
+{
+    if (!ValueName.empty())
+    {
+        mValueName = Ty->getContext().mImpl->internValueName(ValueName);
+    }
+}
 
-////////////////////////////////////////////////////////////
-// Context
-Context &
-Value::getContext() const
+Value::~Value()
 {
-    return mType->getContext();
+    // Release the side table entry
+    if (mHasAnnotation)
+    {
+        ContextImpl *Impl = getContext().mImpl;
+        std::lock_guard<std::mutex> Lock(Impl->mValueAnnotationsMutex);
+        auto It = Impl->mValueAnnotations.find(mArenaID);
+        if (It != Impl->mValueAnnotations.end())
+        {
+            It->second.erase(this);
+        }
+    }
+
+    // The uses that still refer to this value are left empty instead of dangling
+    while (mUseList)
+    {
+        auto U = mUseList;
+        U->unlink();
+        U->mVal = nullptr;
+    }
 }
 
-////////////////////////////////////////////////////////////
-// User
-const Value::UsersListType &
-Value::getUsers() const
+// Destroy the value, the memory of an arena value is released with the arena
+void
+Value::operator delete(Value *V, std::destroying_delete_t)
 {
-    return mUsers;
+    bool IsArenaAllocated = V->mArenaID != 0;
+    void *Mem = dynamic_cast<void *>(V);
+    V->~Value();
+    if (!IsArenaAllocated)
+    {
+        ::operator delete(Mem);
+    }
 }
 
-Value::UsersListType &
-Value::getUsers()
+////////////////////////////////////////////////////////////
+// Context
+Context &
+Value::getContext() const
 {
-    return mUsers;
+    return mType->getContext();
 }
 
 ////////////////////////////////////////////////////////////
@@ -41,13 +76,23 @@ Value::getUsers()
 bool
 Value::hasName() const
 {
-    return !mValueName.empty();
+    return mValueName != nullptr;
 }
 
 void
 Value::setName(const char *ValueName)
 {
-    mValueName = ValueName;
+    mValueName = *ValueName ? getContext().mImpl->internValueName(ValueName) : nullptr;
+}
+
+// Set the name of the value to the base name followed by the index
+void
+Value::setName(const unknown::StringRef &BaseName, uint32_t Index)
+{
+    // rax3
+    unknown::SmallString<32> Name(BaseName);
+    Name += std::to_string(Index);
+    mValueName = getContext().mImpl->internValueName(Name);
 }
 
 // Get/Set the type of the value
@@ -77,31 +122,56 @@ Value::getValueSize() const
 }
 
 // Get the extra info of this object
-const Value::ExtraInfoListType &
+const Value::ExtraInfoListType
 Value::getExtraInfoList() const
 {
-    return mExtraInfoList;
+    if (!mHasAnnotation)
+    {
+        return {};
+    }
+
+    // A copy, the side table may be changed by another thread once the lock is released
+    ContextImpl *Impl = getContext().mImpl;
+    std::lock_guard<std::mutex> Lock(Impl->mValueAnnotationsMutex);
+    return Impl->mValueAnnotations[mArenaID][this].ExtraInfoList;
 }
 
 // Set the extra info of this object
 void
 Value::setExtraInfoList(const Value::ExtraInfoListType &ExtraInfo)
 {
-    mExtraInfoList = ExtraInfo;
+    if (ExtraInfo.empty() && !mHasAnnotation)
+    {
+        return;
+    }
+
+    updateAnnotation([&ExtraInfo](auto &Annotation) { Annotation.ExtraInfoList = ExtraInfo; });
 }
 
 // Get the comment of this object
 const std::string
 Value::getComment() const
 {
-    return mComment;
+    if (!mHasAnnotation)
+    {
+        return "";
+    }
+
+    ContextImpl *Impl = getContext().mImpl;
+    std::lock_guard<std::mutex> Lock(Impl->mValueAnnotationsMutex);
+    return Impl->mValueAnnotations[mArenaID][this].Comment;
 }
 
 // Set the comment of this object
 void
 Value::setComment(const unknown::StringRef &Comment)
 {
-    mComment = Comment;
+    if (Comment.empty() && !mHasAnnotation)
+    {
+        return;
+    }
+
+    updateAnnotation([&Comment](auto &Annotation) { Annotation.Comment = Comment.str(); });
 }
 
 ////////////////////////////////////////////////////////////
@@ -110,114 +180,99 @@ Value::setComment(const unknown::StringRef &Comment)
 void
 Value::addExtraInfo(const unknown::StringRef &ExtraInfo)
 {
-    auto It = std::find(mExtraInfoList.begin(), mExtraInfoList.end(), ExtraInfo);
-    if (It == mExtraInfoList.end())
-    {
-        mExtraInfoList.push_back(ExtraInfo);
-    }
+    updateAnnotation([&ExtraInfo](auto &Annotation) {
+        auto &ExtraInfoList = Annotation.ExtraInfoList;
+        if (std::find(ExtraInfoList.begin(), ExtraInfoList.end(), ExtraInfo) == ExtraInfoList.end())
+        {
+            ExtraInfoList.push_back(ExtraInfo.str());
+        }
+    });
 }
 
 // Remove extra info from this object
 void
 Value::removeExtraInfo(const unknown::StringRef &ExtraInfo)
 {
-    auto It = std::find(mExtraInfoList.begin(), mExtraInfoList.end(), ExtraInfo);
-    if (It != mExtraInfoList.end())
+    if (!mHasAnnotation)
     {
-        mExtraInfoList.erase(It);
+        return;
     }
+
+    updateAnnotation([&ExtraInfo](auto &Annotation) {
+        auto &ExtraInfoList = Annotation.ExtraInfoList;
+        auto It = std::find(ExtraInfoList.begin(), ExtraInfoList.end(), ExtraInfo);
+        if (It != ExtraInfoList.end())
+        {
+            ExtraInfoList.erase(It);
+        }
+    });
 }
 
 // Add the comment of this object
 void
 Value::addComment(const unknown::StringRef &Comment)
 {
-    mComment += Comment;
-}
-
-////////////////////////////////////////////////////////////
-// Iterator
-Value::user_iterator
-Value::user_begin()
-{
-    return mUsers.begin();
-}
-
-Value::const_user_iterator
-Value::user_begin() const
-{
-    return mUsers.cbegin();
-}
-
-Value::user_iterator
-Value::user_end()
-{
-    return mUsers.end();
-}
+    if (Comment.empty())
+    {
+        return;
+    }
 
-Value::const_user_iterator
-Value::user_end() const
-{
-    return mUsers.cend();
+    updateAnnotation([&Comment](auto &Annotation) { Annotation.Comment += Comment.str(); });
 }
 
-bool
-Value::user_empty() const
+// Update the side table entry of this object, it is created on first use
+template <typename UpdateT>
+void
+Value::updateAnnotation(UpdateT Update)
 {
-    return mUsers.empty();
+    ContextImpl *Impl = getContext().mImpl;
+    std::lock_guard<std::mutex> Lock(Impl->mValueAnnotationsMutex);
+    Update(Impl->mValueAnnotations[mArenaID][this]);
+    mHasAnnotation = true;
 }
 
+////////////////////////////////////////////////////////////
+// Iterator
 bool
-Value::user_contains(User *U) const
+Value::user_contains(const User *U) const
 {
-    return mUsers.contains(U);
-}
+    for (auto &Use : uses())
+    {
+        if (Use.getUser() == U)
+        {
+            return true;
+        }
+    }
 
-size_t
-Value::user_size() const
-{
-    return mUsers.size();
+    return false;
 }
 
 size_t
-Value::user_count(User *U) const
+Value::getNumUses() const
 {
-    return mUsers.count(U);
+    return std::distance(use_begin(), use_end());
 }
 
+// Link a use into the use list of this value
 void
-Value::user_insert(User *U)
+Value::addUse(Use &U)
 {
-    auto It = mUsers.find(U);
-    if (It == mUsers.end())
+    // The uniqued constants are shared by all functions and threads, so their uses are not tracked
+    if (mValueID == ConstantIntVal)
     {
-        mUsers.insert(U);
+        return;
     }
-}
 
-void
-Value::user_erase(User *U)
-{
-    auto It = mUsers.find(U);
-    if (It != mUsers.end())
-    {
-        mUsers.erase(It);
-    }
-}
-
-void
-Value::user_clear()
-{
-    mUsers.clear();
+    U.addToList(&mUseList);
 }
 
 ////////////////////////////////////////////////////////////
 // Virtual functions
-// Get the name of the value
-std::string
+// Get the name of the value, it points into the string pool of the context
+unknown::StringRef
 Value::getName() const
 {
-    return mValueName;
+    return mValueName ? unknown::StringRef(mValueName) : unknown::StringRef();
 }
 
 // Get the readable name of the value
@@ -226,7 +281,7 @@ Value::getReadableName() const
 {
     // %var i32
     std::string ReadableName = UIR_LOCAL_VARIABLE_NAME_PREFIX;
-    ReadableName += mValueName;
+    ReadableName += getName();
     ReadableName += " ";
     ReadableName += mType->getTypeName();
 
@@ -283,15 +338,21 @@ Value::print(unknown::raw_ostream &OS, bool NewLine) const
 void
 Value::printExtraInfo(unknown::raw_ostream &OS) const
 {
-    if (!getExtraInfoList().empty())
+    if (!mHasAnnotation)
     {
-        OS << getExtraInfoList().front();
+        return;
+    }
+
+    const auto &ExtraInfoList = getExtraInfoList();
+    if (!ExtraInfoList.empty())
+    {
+        OS << ExtraInfoList.front();
 
-        if (getExtraInfoList().size() > 1)
+        if (ExtraInfoList.size() > 1)
         {
-            auto It = getExtraInfoList().begin();
+            auto It = ExtraInfoList.begin();
             ++It;
-            for (; It != getExtraInfoList().end(); ++It)
+            for (; It != ExtraInfoList.end(); ++It)
             {
                 OS << UIR_SEPARATOR;
                 OS << *It;
@@ -304,7 +365,37 @@ Value::printExtraInfo(unknown::raw_ostream &OS) const
 void
 Value::printCommentInfo(unknown::raw_ostream &OS) const
 {
-    OS << mComment;
+    if (mHasAnnotation)
+    {
+        OS << getComment();
+    }
+}
+
+// Push the extra info of this object as the attribute 'extra', if it has any
+void
+Value::pushExtraAttribute(unknown::XMLPrinter &Printer) const
+{
+    // Most values have no extra info, so the buffer is only made for the ones that do
+    if (!mHasAnnotation)
+    {
+        return;
+    }
+
+    pushPrintedAttribute(
+        Printer, getPropertyExtra().data(), [this](unknown::raw_ostream &OS) { printExtraInfo(OS); }, true);
+}
+
+// Push the comment info of this object as the attribute 'comment', if it has any
+void
+Value::pushCommentAttribute(unknown::XMLPrinter &Printer) const
+{
+    if (!mHasAnnotation)
+    {
+        return;
+    }
+
+    pushPrintedAttribute(
+        Printer, getPropertyComment().data(), [this](unknown::raw_ostream &OS) { printCommentInfo(OS); }, true);
 }
 
 } // namespace uir
@@ -0,0 +1,813 @@
+#include <XMLModuleReader.h>
+#include <XMLStreamReader.h>
+#include <Argument.h>
+#include <BasicBlock.h>
+#include <FlagsVariable.h>
+#include <FunctionContext.h>
+#include <Instruction.h>
+#include <LocalVariable.h>
+
+#include <Internal/InternalConfig/InternalConfig.h>
+
+#include <unknown/ADT/APInt.h>
+#include <unknown/ADT/SmallPtrSet.h>
+#include <unknown/ADT/SmallString.h>
+#include <unknown/ADT/StringMap.h>
+#include <unknown/Support/MemoryBuffer.h>
+
+#include <algorithm>
+
+namespace uir {
+
+namespace {
+
+// The widest integer type of the printed modules
+constexpr uint32_t XMLMaxIntegerBits = 1 << 16;
+
+////////////////////////////////////////////////////////////
+// XMLModuleParser
+// Rebuild a module from the tags of the printed XML.
+// The values are looked up by their readable names, the basic blocks by their names, so a branch may come before the
+// block it jumps to.
+class XMLModuleParser
+{
+private:
+    Context &mContext;
+    const XMLModuleReader &mModuleReader;
+    XMLStreamReader mReader;
+    std::string &mError;
+    std::unique_ptr<Module> mModule;
+    unknown::StringMap<GlobalVariable *> mGlobalVariables;
+    unknown::SmallString<128> mStorage;
+
+    // The state of the function being read
+    Function *mFunction;
+    unknown::StringMap<Value *> mValues;
+    unknown::StringMap<BasicBlock *> mBlocks;
+    unknown::SmallPtrSet<BasicBlock *, 8> mUndefinedBlocks;
+
+public:
+    XMLModuleParser(Context &C, const XMLModuleReader &ModuleReader, unknown::StringRef Buffer, std::string &Error) :
+        mContext(C), mModuleReader(ModuleReader), mReader(Buffer), mError(Error), mFunction(nullptr)
+    {
+    }
+
+    ~XMLModuleParser()
+    {
+        // The blocks that were only used by the branches of the discarded module, they are freed while the arena of
+        // their function is alive
+        for (auto BB : mUndefinedBlocks)
+        {
+            delete BB;
+        }
+        mModule.reset();
+    }
+
+public:
+    // Read the module, returns nullptr if the XML is invalid
+    std::unique_ptr<Module> parse()
+    {
+        if (mReader.next() != XMLStreamReader::TokenKind::StartElement || mReader.getName() != "module")
+        {
+            return failModule("expected the element 'module'");
+        }
+
+        if (getAttribute("arch") != mContext.getArchString() || getAttribute("mode") != mContext.getModeString())
+        {
+            return failModule("the arch or the mode of the module does not match the context");
+        }
+        unknown::StringRef ModuleName = getAttribute("name");
+        if (!ModuleName.consume_front(UIR_MODULE_VARIABLE_NAME_PREFIX))
+        {
+            return failModule("invalid module name");
+        }
+        mModule = Module::get(mContext, ModuleName);
+
+        while (true)
+        {
+            auto Kind = mReader.next();
+            if (Kind == XMLStreamReader::TokenKind::EndElement)
+            {
+                break;
+            }
+            if (Kind != XMLStreamReader::TokenKind::StartElement)
+            {
+                return failModule(mReader.getError());
+            }
+
+            bool Parsed = true;
+            if (mReader.getName() == "gv")
+            {
+                Parsed = parseGlobalVariable();
+            }
+            else if (mReader.getName() == "f")
+            {
+                Parsed = parseFunction();
+            }
+            else
+            {
+                Parsed = skipElement();
+            }
+
+            if (!Parsed)
+            {
+                return failModule(mError);
+            }
+        }
+
+        if (mReader.next() != XMLStreamReader::TokenKind::EndOfDocument)
+        {
+            return failModule("unexpected element after the module");
+        }
+
+        return std::move(mModule);
+    }
+
+private:
+    // Read a global variable
+    bool parseGlobalVariable()
+    {
+        unknown::StringRef Name;
+        Type *Ty = nullptr;
+        uint64_t Address = 0;
+        if (!parseHex(getAttribute("addr"), Address) ||
+            !parseReadableName(getAttribute("name"), UIR_GLOBAL_VARIABLE_NAME_PREFIX, Name, Ty))
+        {
+            return fail("invalid global variable");
+        }
+
+        // The elements of the global arrays are not printed
+        auto GV = GlobalVariable::get(Ty, Name, Address);
+        mModule->insertGlobalVariable(GV);
+        mGlobalVariables[GV->getReadableName()] = GV;
+        parseAnnotation(GV);
+
+        return skipElement();
+    }
+
+    // Read a function, or skip it if it is filtered out
+    bool parseFunction()
+    {
+        uint64_t Begin = 0;
+        uint64_t End = 0;
+        if (!parseRange(getAttribute("range"), Begin, End))
+        {
+            return fail("invalid function");
+        }
+        unknown::StringRef FunctionName = getAttribute("name");
+        if (!FunctionName.consume_front(UIR_FUNCTION_VARIABLE_NAME_PREFIX))
+        {
+            return fail("invalid function");
+        }
+
+        if (!mModuleReader.isFunctionSelected(FunctionName, Begin, End))
+        {
+            return skipElement();
+        }
+
+        mFunction = Function::get(mContext, FunctionName, mModule.get(), Begin, End);
+        mModule->insertFunction(mFunction);
+        mValues.clear();
+
+        // The values of the function live in its arena
+        Function::ArenaScope Scope(*mFunction);
+        mBlocks.clear();
+
+        unknown::SmallVector<unknown::StringRef, 4> Attributes;
+        getAttribute("attributes").split(Attributes, UIR_SEPARATOR, -1, false);
+        for (auto Attr : Attributes)
+        {
+            mFunction->attr_push_back(Attr.str());
+        }
+        parseAnnotation(mFunction);
+
+        while (true)
+        {
+            auto Kind = mReader.next();
+            if (Kind == XMLStreamReader::TokenKind::EndElement)
+            {
+                break;
+            }
+            if (Kind != XMLStreamReader::TokenKind::StartElement)
+            {
+                return fail(mReader.getError());
+            }
+
+            bool Parsed = true;
+            if (mReader.getName() == "arg")
+            {
+                Parsed = parseArgument();
+            }
+            else if (mReader.getName() == "ctx")
+            {
+                Parsed = parseFunctionContext();
+            }
+            else if (mReader.getName() == "bb")
+            {
+                Parsed = parseBasicBlock();
+            }
+            else
+            {
+                Parsed = skipElement();
+            }
+
+            if (!Parsed)
+            {
+                return false;
+            }
+        }
+
+        if (!mUndefinedBlocks.empty())
+        {
+            return fail(
+                "undefined block '" + (*mUndefinedBlocks.begin())->getBasicBlockName() + "' in function '" +
+                mFunction->getFunctionName() + "'");
+        }
+
+        return true;
+    }
+
+    // Read an argument
+    bool parseArgument()
+    {
+        unknown::StringRef Name;
+        Type *Ty = nullptr;
+        uint32_t ArgNo = 0;
+        if (getAttribute("argno").getAsInteger(10, ArgNo) ||
+            !parseReadableName(getAttribute("name"), UIR_LOCAL_VARIABLE_NAME_PREFIX, Name, Ty))
+        {
+            return fail("invalid argument");
+        }
+
+        auto Arg = Argument::get(Ty, Name, mFunction, ArgNo);
+        mFunction->insertArgument(Arg);
+        mValues[Arg->getReadableName()] = Arg;
+        parseAnnotation(Arg);
+
+        return skipElement();
+    }
+
+    // Read a function context
+    bool parseFunctionContext()
+    {
+        unknown::StringRef Name;
+        Type *Ty = nullptr;
+        uint32_t CtxNo = 0;
+        if (getAttribute("ctxno").getAsInteger(10, CtxNo) ||
+            !parseReadableName(getAttribute("name"), UIR_LOCAL_VARIABLE_NAME_PREFIX, Name, Ty))
+        {
+            return fail("invalid function context");
+        }
+
+        auto FC = FunctionContext::get(Ty, Name, mFunction, CtxNo);
+        mFunction->insertFunctionContext(FC);
+        mValues[FC->getReadableName()] = FC;
+        parseAnnotation(FC);
+
+        return skipElement();
+    }
+
+    // Read a basic block and its instructions
+    bool parseBasicBlock()
+    {
+        uint64_t Begin = 0;
+        uint64_t End = 0;
+        if (!parseRange(getAttribute("range"), Begin, End))
+        {
+            return fail("invalid basic block");
+        }
+        unknown::StringRef Name = getAttribute("name");
+        if (!Name.consume_front(UIR_BLOCK_VARIABLE_NAME_PREFIX))
+        {
+            return fail("invalid basic block");
+        }
+
+        // The block may already be the destination of a branch
+        auto &Entry = mBlocks[Name];
+        if (Entry && !mUndefinedBlocks.erase(Entry))
+        {
+            return fail("basic block '" + Name.str() + "' is defined twice");
+        }
+        if (Entry == nullptr)
+        {
+            Entry = BasicBlock::get(mContext, Name, Begin, End);
+        }
+        auto BB = Entry;
+        BB->setBasicBlockAddressBegin(Begin);
+        BB->setBasicBlockAddressEnd(End);
+        mFunction->insertBasicBlock(BB);
+        parseAnnotation(BB);
+
+        while (true)
+        {
+            auto Kind = mReader.next();
+            if (Kind == XMLStreamReader::TokenKind::EndElement)
+            {
+                break;
+            }
+            if (Kind != XMLStreamReader::TokenKind::StartElement)
+            {
+                return fail(mReader.getError());
+            }
+
+            if (mReader.getName() == "i" ? !parseInstruction(BB) : !skipElement())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Read an instruction
+    bool parseInstruction(BasicBlock *BB)
+    {
+        uint64_t Address = 0;
+        if (!parseHex(getAttribute("addr"), Address))
+        {
+            return fail("invalid instruction address");
+        }
+
+        auto Text = getAttribute("name").str();
+        auto I = buildInstruction(Text);
+        if (I == nullptr)
+        {
+            return fail("can not rebuild the instruction '" + Text + "'");
+        }
+        I->setInstructionAddress(Address);
+        BB->push_back(I);
+        parseAnnotation(I);
+
+        // The branches are the only edges of the printed blocks
+        if (auto TI = unknown::dyn_cast<TerminatorInstruction>(I))
+        {
+            unknown::SmallPtrSet<BasicBlock *, 2> Successors;
+            for (auto Succ : TI->getSuccessorsList())
+            {
+                if (Successors.insert(Succ).second)
+                {
+                    Succ->predecessor_push(BB);
+                }
+            }
+        }
+
+        // The operands are only printed as children
+        bool PrintOp = false;
+        while (true)
+        {
+            auto Kind = mReader.next();
+            if (Kind == XMLStreamReader::TokenKind::EndElement)
+            {
+                break;
+            }
+            if (Kind != XMLStreamReader::TokenKind::StartElement || !skipElement())
+            {
+                return fail(mReader.getError());
+            }
+            PrintOp = true;
+        }
+        I->enablePrintOp(PrintOp);
+
+        return true;
+    }
+
+    // Rebuild an instruction from the text printed by printInst: [result=]opcode[ operand[,operand]]
+    Instruction *buildInstruction(unknown::StringRef Text)
+    {
+        unknown::StringRef Result;
+        if (Text.startswith(UIR_LOCAL_VARIABLE_NAME_PREFIX))
+        {
+            std::tie(Result, Text) = Text.split(UIR_OP_RESULT_SEPARATOR);
+        }
+
+        unknown::StringRef OpCodeName;
+        unknown::StringRef OperandsText;
+        std::tie(OpCodeName, OperandsText) = Text.split(UIR_OPCODE_SEPARATOR);
+        auto Component = std::find_if(
+            std::begin(OpCodeComponentTable), std::end(OpCodeComponentTable), [&OpCodeName](auto &Entry) {
+                return Entry.mOpCodeName == OpCodeName;
+            });
+        if (Component == std::end(OpCodeComponentTable) || Component->mHasResult != !Result.empty())
+        {
+            return nullptr;
+        }
+
+        // The text of an unknown instruction is not split
+        unknown::SmallVector<unknown::StringRef, 2> Operands;
+        if (Component->mOpCodeID != OpCodeID::Unknown && !OperandsText.empty())
+        {
+            OperandsText.split(Operands, UIR_OP_SEPARATOR);
+        }
+        if (Component->mOpCodeID != OpCodeID::Unknown && Operands.size() != Component->mNumberOfOperands)
+        {
+            return nullptr;
+        }
+
+        unknown::StringRef ResultName;
+        Type *ResultTy = nullptr;
+        if (!Result.empty() && !parseReadableName(Result, UIR_LOCAL_VARIABLE_NAME_PREFIX, ResultName, ResultTy))
+        {
+            return nullptr;
+        }
+
+        // The local variables first used by this instruction, they are freed if it can not be rebuilt
+        unknown::SmallVector<unknown::StringRef, 2> NewLocals;
+        auto getValue = [this, &NewLocals](unknown::StringRef ReadableName) {
+            return parseValue(ReadableName, NewLocals);
+        };
+        auto getAddress = [this](unknown::StringRef Address) {
+            // The addresses of the branches are printed without their type
+            return parseConstantInt(Address, IntegerType::get(mContext, mContext.getModeBits()));
+        };
+
+        Instruction *I = nullptr;
+        switch (Component->mOpCodeID)
+        {
+        case OpCodeID::Unknown: {
+            I = UnknownInstruction::get(mContext, OperandsText);
+            break;
+        }
+        case OpCodeID::Load: {
+            if (auto Ptr = getValue(Operands[0]))
+            {
+                I = LoadInstruction::get(Ptr);
+            }
+            break;
+        }
+        case OpCodeID::Store: {
+            auto Val = getValue(Operands[0]);
+            auto Ptr = getValue(Operands[1]);
+            if (Val && Ptr)
+            {
+                I = StoreInstruction::get(mContext, Val, Ptr);
+            }
+            break;
+        }
+        case OpCodeID::GetBitPtr: {
+            auto PtrTy = unknown::dyn_cast<PointerType>(ResultTy);
+            auto Ptr = getValue(Operands[0]);
+            auto BitIndex = getValue(Operands[1]);
+            if (PtrTy && Ptr && BitIndex)
+            {
+                I = GetBitPtrInstruction::get(PtrTy, Ptr, BitIndex);
+            }
+            break;
+        }
+        case OpCodeID::Ret: {
+            I = ReturnInstruction::get(mContext);
+            break;
+        }
+        case OpCodeID::RetIMM: {
+            if (auto CI = parseConstantInt(Operands[0]))
+            {
+                I = ReturnImmInstruction::get(mContext, CI);
+            }
+            break;
+        }
+        case OpCodeID::JmpAddr: {
+            if (auto DestCI = getAddress(Operands[0]))
+            {
+                I = JmpAddrInstruction::get(mContext, DestCI);
+            }
+            break;
+        }
+        case OpCodeID::JmpBB: {
+            if (auto DestBB = getBlock(Operands[0]))
+            {
+                I = JmpBBInstruction::get(mContext, DestBB);
+            }
+            break;
+        }
+        case OpCodeID::JccAddr: {
+            auto DestCI = getAddress(Operands[0]);
+            auto NormalCI = getAddress(Operands[1]);
+            if (DestCI && NormalCI)
+            {
+                I = JccAddrInstruction::get(mContext, DestCI, NormalCI, FlagsVariable::get(mContext));
+            }
+            break;
+        }
+        case OpCodeID::JccBB: {
+            auto DestBB = getBlock(Operands[0]);
+            auto NormalBB = getBlock(Operands[1]);
+            if (DestBB && NormalBB)
+            {
+                I = JccBBInstruction::get(mContext, DestBB, NormalBB, FlagsVariable::get(mContext));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (I == nullptr)
+        {
+            for (auto Name : NewLocals)
+            {
+                auto It = mValues.find(Name);
+                delete It->second;
+                mValues.erase(It);
+            }
+            return nullptr;
+        }
+
+        if (!Result.empty())
+        {
+            I->setType(ResultTy);
+            I->setName(ResultName.str().c_str());
+            mValues[Result] = I;
+        }
+
+        return I;
+    }
+
+    // Get the value of an operand: %local type, @global type or 0x7B type.
+    // The same readable name is the same value: a local variable is shared by the instructions of its function and
+    // freed with the last of them, a global variable that is not printed by the module is added to the module.
+    Value *parseValue(unknown::StringRef ReadableName, unknown::SmallVectorImpl<unknown::StringRef> &NewLocals)
+    {
+        if (ReadableName.startswith(UIR_LOCAL_VARIABLE_NAME_PREFIX))
+        {
+            // An argument, a function context or the result of an instruction
+            auto It = mValues.find(ReadableName);
+            if (It != mValues.end())
+            {
+                return It->second;
+            }
+
+            unknown::StringRef Name;
+            Type *Ty = nullptr;
+            if (!parseReadableName(ReadableName, UIR_LOCAL_VARIABLE_NAME_PREFIX, Name, Ty))
+            {
+                return nullptr;
+            }
+            auto LV = LocalVariable::get(Ty, Name, 0);
+            auto Inserted = mValues.try_emplace(ReadableName, LV).first;
+            NewLocals.push_back(Inserted->first());
+            return LV;
+        }
+
+        if (ReadableName.startswith(UIR_GLOBAL_VARIABLE_NAME_PREFIX))
+        {
+            auto It = mGlobalVariables.find(ReadableName);
+            if (It != mGlobalVariables.end())
+            {
+                return It->second;
+            }
+
+            unknown::StringRef Name;
+            Type *Ty = nullptr;
+            if (!parseReadableName(ReadableName, UIR_GLOBAL_VARIABLE_NAME_PREFIX, Name, Ty))
+            {
+                return nullptr;
+            }
+            auto GV = GlobalVariable::get(Ty, Name, 0);
+            mModule->insertGlobalVariable(GV);
+            mGlobalVariables[ReadableName] = GV;
+            return GV;
+        }
+
+        return parseConstantInt(ReadableName);
+    }
+
+    // Get a constant int printed as 0x7B type
+    ConstantInt *parseConstantInt(unknown::StringRef ReadableName)
+    {
+        unknown::StringRef Value;
+        unknown::StringRef TypeName;
+        std::tie(Value, TypeName) = ReadableName.rsplit(' ');
+        return parseConstantInt(Value, unknown::dyn_cast_or_null<IntegerType>(parseType(TypeName)));
+    }
+
+    // Get a constant int printed as 0x7B
+    ConstantInt *parseConstantInt(unknown::StringRef Value, IntegerType *IntTy)
+    {
+        unknown::APInt Val;
+        if (IntTy == nullptr || !(Value.consume_front("0x") || Value.consume_front("0X")) ||
+            Value.getAsInteger(16, Val) || Val.getActiveBits() > IntTy->getTypeBits())
+        {
+            return nullptr;
+        }
+
+        return ConstantInt::get(IntTy, Val.zextOrTrunc(IntTy->getTypeBits()));
+    }
+
+    // Get the basic block of an operand, it is created if the branch comes first
+    BasicBlock *getBlock(unknown::StringRef ReadableName)
+    {
+        if (!ReadableName.consume_front(UIR_BLOCK_VARIABLE_NAME_PREFIX))
+        {
+            return nullptr;
+        }
+
+        auto &Entry = mBlocks[ReadableName];
+        if (Entry == nullptr)
+        {
+            Entry = BasicBlock::get(mContext, ReadableName);
+            mUndefinedBlocks.insert(Entry);
+        }
+        return Entry;
+    }
+
+    // Split a readable name printed as <prefix>name type
+    bool parseReadableName(
+        unknown::StringRef ReadableName,
+        unknown::StringRef Prefix,
+        unknown::StringRef &Name,
+        Type *&Ty)
+    {
+        unknown::StringRef TypeName;
+        std::tie(Name, TypeName) = ReadableName.rsplit(' ');
+        Ty = parseType(TypeName);
+        return Ty != nullptr && Name.consume_front(Prefix);
+    }
+
+    // Get the type of a type name
+    Type *parseType(unknown::StringRef TypeName)
+    {
+        if (TypeName.consume_back(UIR_PTR_TYPE_NAME_SUFFIX))
+        {
+            auto ElementTy = parseType(TypeName);
+            return ElementTy ? PointerType::get(mContext, ElementTy) : nullptr;
+        }
+
+        uint32_t Bits = 0;
+        if (TypeName.consume_front("i"))
+        {
+            if (TypeName.getAsInteger(10, Bits) || Bits == 0 || Bits > XMLMaxIntegerBits)
+            {
+                return nullptr;
+            }
+            return IntegerType::get(mContext, Bits);
+        }
+
+        if (TypeName == "void")
+        {
+            return Type::getVoidTy(mContext);
+        }
+        if (TypeName == "float")
+        {
+            return Type::getFloatTy(mContext);
+        }
+        if (TypeName == "double")
+        {
+            return Type::getDoubleTy(mContext);
+        }
+        if (TypeName == "label")
+        {
+            return Type::getLabelTy(mContext);
+        }
+        if (TypeName == "function")
+        {
+            return Type::getFunctionTy(mContext);
+        }
+        return nullptr;
+    }
+
+    // Parse an address printed as 0x{:X}
+    bool parseHex(unknown::StringRef Text, uint64_t &Value)
+    {
+        return (Text.consume_front("0x") || Text.consume_front("0X")) && !Text.getAsInteger(16, Value);
+    }
+
+    // Parse a range printed as 0x{:X}-0x{:X}
+    bool parseRange(unknown::StringRef Text, uint64_t &Begin, uint64_t &End)
+    {
+        auto Range = Text.split('-');
+        return parseHex(Range.first, Begin) && parseHex(Range.second, End);
+    }
+
+    // Read the attributes 'extra' and 'comment' of a value
+    void parseAnnotation(Value *V)
+    {
+        unknown::SmallVector<unknown::StringRef, 4> ExtraInfo;
+        getAttribute("extra").split(ExtraInfo, UIR_SEPARATOR, -1, false);
+        if (!ExtraInfo.empty())
+        {
+            V->setExtraInfoList(Value::ExtraInfoListType(ExtraInfo.begin(), ExtraInfo.end()));
+        }
+
+        auto Comment = getAttribute("comment");
+        if (!Comment.empty())
+        {
+            V->setComment(Comment);
+        }
+    }
+
+    // Get an attribute of the current element, the value is valid until the next attribute is read
+    unknown::StringRef getAttribute(unknown::StringRef Name)
+    {
+        return mReader.getAttribute(Name, mStorage).value_or("");
+    }
+
+    // Skip the rest of the current element
+    bool skipElement() { return mReader.skipElement() || fail(mReader.getError()); }
+
+    // Set the error
+    bool fail(const std::string &Error)
+    {
+        mError = Error;
+        return false;
+    }
+
+    // Set the error and discard the module
+    std::unique_ptr<Module> failModule(const std::string &Error)
+    {
+        mError = Error.empty() ? "invalid module" : Error;
+        return nullptr;
+    }
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////
+//     XMLModuleReader
+//
+
+////////////////////////////////////////////////////////////
+// Ctor/Dtor
+XMLModuleReader::XMLModuleReader(Context &C) : mContext(C)
+{
+    //
+}
+
+XMLModuleReader::~XMLModuleReader()
+{
+    //
+}
+
+////////////////////////////////////////////////////////////
+// Filter
+// Load the function with this name, all functions are loaded if there is no filter
+void
+XMLModuleReader::addFunctionName(const unknown::StringRef &FunctionName)
+{
+    mFunctionNames.insert(FunctionName);
+}
+
+// Load the functions that overlap the range [Begin, End), all functions are loaded if there is no filter
+void
+XMLModuleReader::addFunctionRange(uint64_t Begin, uint64_t End)
+{
+    mFunctionRanges.emplace_back(Begin, End);
+}
+
+// Is there a filter?
+bool
+XMLModuleReader::hasFilter() const
+{
+    return !mFunctionNames.empty() || !mFunctionRanges.empty();
+}
+
+// Is the function loaded?
+bool
+XMLModuleReader::isFunctionSelected(const unknown::StringRef &FunctionName, uint64_t Begin, uint64_t End) const
+{
+    if (!hasFilter() || mFunctionNames.count(FunctionName))
+    {
+        return true;
+    }
+
+    // A function without a size still has its first address
+    End = std::max(End, Begin + 1);
+    return std::any_of(mFunctionRanges.begin(), mFunctionRanges.end(), [Begin, End](auto &Range) {
+        return Begin < Range.second && Range.first < End;
+    });
+}
+
+////////////////////////////////////////////////////////////
+// Read
+// Read a module printed by Module::print, returns nullptr if the XML is invalid
+std::unique_ptr<Module>
+XMLModuleReader::read(unknown::StringRef Buffer)
+{
+    mError.clear();
+    XMLModuleParser Parser(mContext, *this, Buffer, mError);
+    return Parser.parse();
+}
+
+// Read a module file printed by Module::printToFile, the file is mapped into memory
+std::unique_ptr<Module>
+XMLModuleReader::readFile(const unknown::StringRef &FilePath)
+{
+    auto BufferOrErr = unknown::MemoryBuffer::getFile(FilePath, -1, false);
+    if (!BufferOrErr)
+    {
+        mError = BufferOrErr.getError().message();
+        return nullptr;
+    }
+
+    return read((*BufferOrErr)->getBuffer());
+}
+
+////////////////////////////////////////////////////////////
+// Static
+// Read a whole module file printed by Module::printToFile
+std::unique_ptr<Module>
+XMLModuleReader::readModuleFile(Context &C, const unknown::StringRef &FilePath)
+{
+    XMLModuleReader Reader(C);
+    return Reader.readFile(FilePath);
+}
+
+} // namespace uir
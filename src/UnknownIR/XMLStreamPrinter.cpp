@@ -0,0 +1,82 @@
+#include <XMLStreamPrinter.h>
+
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+namespace uir {
+
+////////////////////////////////////////////////////////////
+// Ctor/Dtor
+XMLStreamPrinter::XMLStreamPrinter(unknown::raw_ostream &OS, int Depth) :
+    unknown::XMLPrinter(nullptr, false, Depth), mOS(OS)
+{
+    //
+}
+
+XMLStreamPrinter::~XMLStreamPrinter()
+{
+    //
+}
+
+////////////////////////////////////////////////////////////
+// Push
+// Write an element printed by another printer with the depth of the next child of the open element.
+void
+XMLStreamPrinter::pushPrintedElement(unknown::StringRef Element)
+{
+    assert(!_stack.Empty() && "No open element!");
+
+    // The other printer started at the depth of the child, so only the separator of a new node is missing
+    SealElementIfJustOpened();
+    Putc('\n');
+    Write(Element.data(), Element.size());
+}
+
+////////////////////////////////////////////////////////////
+// Virtual
+// Write the data to the output stream
+void
+XMLStreamPrinter::Write(const char *data, size_t size)
+{
+    mOS.write(data, size);
+}
+
+// Write a character to the output stream
+void
+XMLStreamPrinter::Putc(char ch)
+{
+    mOS << ch;
+}
+
+// Write the formatted string to the output stream
+void
+XMLStreamPrinter::Print(const char *format, ...)
+{
+    // Most of the formatted strings are numbers, so they fit in the stack buffer
+    char Buffer[128];
+
+    va_list Args;
+    va_start(Args, format);
+    int Length = std::vsnprintf(Buffer, sizeof(Buffer), format, Args);
+    va_end(Args);
+    if (Length < 0)
+    {
+        return;
+    }
+
+    if (static_cast<size_t>(Length) < sizeof(Buffer))
+    {
+        mOS.write(Buffer, Length);
+        return;
+    }
+
+    std::vector<char> LongBuffer(Length + 1);
+    va_start(Args, format);
+    std::vsnprintf(LongBuffer.data(), LongBuffer.size(), format, Args);
+    va_end(Args);
+    mOS.write(LongBuffer.data(), Length);
+}
+
+} // namespace uir
@@ -0,0 +1,466 @@
+#include <XMLStreamReader.h>
+
+#include <UnknownUtils/unknown/ADT/SmallString.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace uir {
+
+namespace {
+
+// Is it a whitespace between the names and the attributes?
+inline bool
+isSpace(char C)
+{
+    return C == ' ' || C == '\t' || C == '\r' || C == '\n';
+}
+
+// Can it be part of the name of an element or an attribute?
+inline bool
+isNameChar(char C)
+{
+    return !isSpace(C) && C != '/' && C != '>' && C != '=' && C != '<';
+}
+
+// Append a code point as UTF-8
+void
+appendCodePoint(uint32_t CodePoint, unknown::SmallVectorImpl<char> &Decoded)
+{
+    if (CodePoint < 0x80)
+    {
+        Decoded.push_back(static_cast<char>(CodePoint));
+    }
+    else if (CodePoint < 0x800)
+    {
+        Decoded.push_back(static_cast<char>(0xC0 | (CodePoint >> 6)));
+        Decoded.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+    else if (CodePoint < 0x10000)
+    {
+        Decoded.push_back(static_cast<char>(0xE0 | (CodePoint >> 12)));
+        Decoded.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        Decoded.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+    else
+    {
+        Decoded.push_back(static_cast<char>(0xF0 | (CodePoint >> 18)));
+        Decoded.push_back(static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F)));
+        Decoded.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        Decoded.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////
+// Ctor/Dtor
+XMLStreamReader::XMLStreamReader(unknown::StringRef Buffer) :
+    mBegin(Buffer.begin()),
+    mPtr(Buffer.begin()),
+    mEnd(Buffer.end()),
+    mTokenKind(TokenKind::EndOfDocument),
+    mPendingEnd(false)
+{
+    //
+}
+
+XMLStreamReader::~XMLStreamReader()
+{
+    //
+}
+
+////////////////////////////////////////////////////////////
+// Read
+// Read the next tag, a self-closing element is read as a start and an end element
+XMLStreamReader::TokenKind
+XMLStreamReader::next()
+{
+    if (mTokenKind == TokenKind::Error)
+    {
+        return mTokenKind;
+    }
+
+    mAttributes.clear();
+    if (mPendingEnd)
+    {
+        mPendingEnd = false;
+        mName = mOpenElements.pop_back_val();
+        mTokenKind = TokenKind::EndElement;
+        return mTokenKind;
+    }
+
+    while (true)
+    {
+        auto Open = static_cast<const char *>(std::memchr(mPtr, '<', mEnd - mPtr));
+        if (Open == nullptr)
+        {
+            mPtr = mEnd;
+            if (!mOpenElements.empty())
+            {
+                return fail("unexpected end of the document");
+            }
+
+            mName = "";
+            mTokenKind = TokenKind::EndOfDocument;
+            return mTokenKind;
+        }
+
+        mPtr = Open + 1;
+        if (mPtr == mEnd)
+        {
+            return fail("unexpected end of the document");
+        }
+
+        if (*mPtr == '?' || *mPtr == '!')
+        {
+            if (!skipMarkup())
+            {
+                return mTokenKind;
+            }
+            continue;
+        }
+
+        if (*mPtr == '/')
+        {
+            ++mPtr;
+            return readEndTag();
+        }
+
+        return readStartTag();
+    }
+}
+
+// Skip the children of the element that was just started, its end element becomes the current tag
+bool
+XMLStreamReader::skipElement()
+{
+    assert(mTokenKind == TokenKind::StartElement && "No element was started!");
+
+    if (mPendingEnd)
+    {
+        return next() == TokenKind::EndElement;
+    }
+
+    // The skipped tags are only split at '<' and '>', their names and attributes are not read
+    mAttributes.clear();
+    size_t Depth = 1;
+    while (true)
+    {
+        auto Open = static_cast<const char *>(std::memchr(mPtr, '<', mEnd - mPtr));
+        if (Open == nullptr || Open + 1 == mEnd)
+        {
+            mPtr = mEnd;
+            fail("unexpected end of the document");
+            return false;
+        }
+
+        mPtr = Open + 1;
+        if (*mPtr == '?' || *mPtr == '!')
+        {
+            if (!skipMarkup())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // The values of the attributes may hold a '>'
+        char Quote = '\0';
+        auto Ptr = mPtr;
+        for (; Ptr < mEnd; ++Ptr)
+        {
+            if (Quote != '\0')
+            {
+                Quote = *Ptr == Quote ? '\0' : Quote;
+            }
+            else if (*Ptr == '"' || *Ptr == '\'')
+            {
+                Quote = *Ptr;
+            }
+            else if (*Ptr == '>')
+            {
+                break;
+            }
+        }
+        if (Ptr == mEnd)
+        {
+            mPtr = mEnd;
+            fail("unterminated tag");
+            return false;
+        }
+
+        bool IsEndTag = *mPtr == '/';
+        bool IsSelfClosing = !IsEndTag && Ptr[-1] == '/';
+        mPtr = Ptr + 1;
+        if (IsEndTag && --Depth == 0)
+        {
+            mName = mOpenElements.pop_back_val();
+            mTokenKind = TokenKind::EndElement;
+            return true;
+        }
+        if (!IsEndTag && !IsSelfClosing)
+        {
+            ++Depth;
+        }
+    }
+}
+
+// Read the attributes and the end of a start tag
+XMLStreamReader::TokenKind
+XMLStreamReader::readStartTag()
+{
+    auto NameBegin = mPtr;
+    while (mPtr < mEnd && isNameChar(*mPtr))
+    {
+        ++mPtr;
+    }
+    mName = unknown::StringRef(NameBegin, mPtr - NameBegin);
+    if (mName.empty())
+    {
+        return fail("expected the name of an element");
+    }
+
+    while (true)
+    {
+        while (mPtr < mEnd && isSpace(*mPtr))
+        {
+            ++mPtr;
+        }
+        if (mPtr == mEnd)
+        {
+            return fail("unterminated start tag");
+        }
+
+        // End of the tag
+        if (*mPtr == '>')
+        {
+            ++mPtr;
+            break;
+        }
+        if (*mPtr == '/')
+        {
+            if (mPtr + 1 == mEnd || mPtr[1] != '>')
+            {
+                return fail("expected '>' after '/'");
+            }
+            mPtr += 2;
+            mPendingEnd = true;
+            break;
+        }
+
+        // name="value"
+        auto AttrBegin = mPtr;
+        while (mPtr < mEnd && isNameChar(*mPtr))
+        {
+            ++mPtr;
+        }
+        unknown::StringRef AttrName(AttrBegin, mPtr - AttrBegin);
+        while (mPtr < mEnd && isSpace(*mPtr))
+        {
+            ++mPtr;
+        }
+        if (AttrName.empty() || mPtr == mEnd || *mPtr != '=')
+        {
+            return fail("expected an attribute");
+        }
+        ++mPtr;
+        while (mPtr < mEnd && isSpace(*mPtr))
+        {
+            ++mPtr;
+        }
+        if (mPtr == mEnd || (*mPtr != '"' && *mPtr != '\''))
+        {
+            return fail("expected the value of an attribute");
+        }
+
+        auto Quote = *mPtr++;
+        auto Close = static_cast<const char *>(std::memchr(mPtr, Quote, mEnd - mPtr));
+        if (Close == nullptr)
+        {
+            return fail("unterminated value of an attribute");
+        }
+        mAttributes.emplace_back(AttrName, unknown::StringRef(mPtr, Close - mPtr));
+        mPtr = Close + 1;
+    }
+
+    mOpenElements.push_back(mName);
+    mTokenKind = TokenKind::StartElement;
+    return mTokenKind;
+}
+
+// Read an end tag
+XMLStreamReader::TokenKind
+XMLStreamReader::readEndTag()
+{
+    auto NameBegin = mPtr;
+    while (mPtr < mEnd && isNameChar(*mPtr))
+    {
+        ++mPtr;
+    }
+    mName = unknown::StringRef(NameBegin, mPtr - NameBegin);
+    while (mPtr < mEnd && isSpace(*mPtr))
+    {
+        ++mPtr;
+    }
+    if (mPtr == mEnd || *mPtr != '>')
+    {
+        return fail("unterminated end tag");
+    }
+    ++mPtr;
+
+    if (mOpenElements.empty() || mOpenElements.back() != mName)
+    {
+        return fail("mismatched end tag");
+    }
+    mOpenElements.pop_back();
+
+    mTokenKind = TokenKind::EndElement;
+    return mTokenKind;
+}
+
+// Skip to the end of a comment, a declaration or a processing instruction
+bool
+XMLStreamReader::skipMarkup()
+{
+    unknown::StringRef Rest(mPtr, mEnd - mPtr);
+    unknown::StringRef Terminator = ">";
+    if (Rest.startswith("?"))
+    {
+        Terminator = "?>";
+    }
+    else if (Rest.startswith("!--"))
+    {
+        Terminator = "-->";
+    }
+    else if (Rest.startswith("![CDATA["))
+    {
+        Terminator = "]]>";
+    }
+
+    auto Pos = Rest.find(Terminator);
+    if (Pos == unknown::StringRef::npos)
+    {
+        mPtr = mEnd;
+        fail("unterminated markup");
+        return false;
+    }
+
+    mPtr += Pos + Terminator.size();
+    return true;
+}
+
+// Stop reading
+XMLStreamReader::TokenKind
+XMLStreamReader::fail(const unknown::StringRef &Error)
+{
+    mError = Error.str();
+    mError += " at offset ";
+    mError += std::to_string(getOffset());
+    mTokenKind = TokenKind::Error;
+    return mTokenKind;
+}
+
+////////////////////////////////////////////////////////////
+// Get/Set
+// Get the value of an attribute of the current start element.
+std::optional<unknown::StringRef>
+XMLStreamReader::getAttribute(unknown::StringRef Name, unknown::SmallVectorImpl<char> &Storage) const
+{
+    for (auto &Attr : mAttributes)
+    {
+        if (Attr.first != Name)
+        {
+            continue;
+        }
+
+        // Most of the values have no entities
+        if (Attr.second.find('&') == unknown::StringRef::npos)
+        {
+            return Attr.second;
+        }
+
+        Storage.clear();
+        if (!decodeEntities(Attr.second, Storage))
+        {
+            return {};
+        }
+        return unknown::StringRef(Storage.data(), Storage.size());
+    }
+
+    return {};
+}
+
+// Get the value of an attribute of the current start element, empty if it is missing
+std::string
+XMLStreamReader::getAttribute(unknown::StringRef Name) const
+{
+    unknown::SmallString<64> Storage;
+    auto Value = getAttribute(Name, Storage);
+    return Value ? Value->str() : "";
+}
+
+////////////////////////////////////////////////////////////
+// Static
+// Decode the entities of a value, returns false if one of them is invalid
+bool
+XMLStreamReader::decodeEntities(unknown::StringRef Value, unknown::SmallVectorImpl<char> &Decoded)
+{
+    while (!Value.empty())
+    {
+        auto Amp = Value.find('&');
+        Decoded.append(Value.begin(), Value.begin() + std::min(Amp, Value.size()));
+        if (Amp == unknown::StringRef::npos)
+        {
+            break;
+        }
+
+        auto Semi = Value.find(';', Amp);
+        if (Semi == unknown::StringRef::npos)
+        {
+            return false;
+        }
+
+        auto Entity = Value.slice(Amp + 1, Semi);
+        Value = Value.substr(Semi + 1);
+        if (Entity == "lt")
+        {
+            Decoded.push_back('<');
+        }
+        else if (Entity == "gt")
+        {
+            Decoded.push_back('>');
+        }
+        else if (Entity == "amp")
+        {
+            Decoded.push_back('&');
+        }
+        else if (Entity == "quot")
+        {
+            Decoded.push_back('"');
+        }
+        else if (Entity == "apos")
+        {
+            Decoded.push_back('\'');
+        }
+        else if (Entity.consume_front("#"))
+        {
+            uint32_t CodePoint = 0;
+            bool IsHex = Entity.consume_front("x") || Entity.consume_front("X");
+            if (Entity.getAsInteger(IsHex ? 16 : 10, CodePoint) || CodePoint > 0x10FFFF)
+            {
+                return false;
+            }
+            appendCodePoint(CodePoint, Decoded);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace uir
@@ -7,6 +7,7 @@
 #include "PDB_ErrorCodes.h"
 #include "PDB_DBITypes.h"
 #include "PDB_CoalescedMSFStream.h"
+#include "PDB_RecordMSFStream.h"
 #include "PDB_DirectMSFStream.h"
 #include "PDB_ImageSectionStream.h"
 #include "PDB_PublicSymbolStream.h"
@@ -33,7 +34,7 @@ public:
     PDB_NO_DISCARD ErrorCode HasValidGlobalSymbolStream(const RawFile &file) const PDB_NO_EXCEPT;
     PDB_NO_DISCARD ErrorCode HasValidSectionContributionStream(const RawFile &file) const PDB_NO_EXCEPT;
 
-    PDB_NO_DISCARD CoalescedMSFStream CreateSymbolRecordStream(const RawFile &file) const PDB_NO_EXCEPT;
+    PDB_NO_DISCARD RecordMSFStream CreateSymbolRecordStream(const RawFile &file) const PDB_NO_EXCEPT;
     PDB_NO_DISCARD ImageSectionStream CreateImageSectionStream(const RawFile &file) const PDB_NO_EXCEPT;
     PDB_NO_DISCARD PublicSymbolStream CreatePublicSymbolStream(const RawFile &file) const PDB_NO_EXCEPT;
     PDB_NO_DISCARD GlobalSymbolStream CreateGlobalSymbolStream(const RawFile &file) const PDB_NO_EXCEPT;
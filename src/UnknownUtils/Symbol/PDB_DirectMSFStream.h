@@ -44,6 +44,7 @@ public:
 
 private:
     friend class CoalescedMSFStream;
+    friend class RecordMSFStream;
 
     struct IndexAndOffset
     {
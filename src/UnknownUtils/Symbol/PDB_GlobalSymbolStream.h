@@ -6,6 +6,7 @@
 #include "Foundation/PDB_Macros.h"
 #include "Foundation/PDB_ArrayView.h"
 #include "PDB_CoalescedMSFStream.h"
+#include "PDB_RecordMSFStream.h"
 
 namespace PDB {
 class RawFile;
@@ -26,8 +27,12 @@ public:
     PDB_DEFAULT_MOVE(GlobalSymbolStream);
 
     // Turns a given hash record into a DBI record using the given symbol stream.
+    // The record is copied into the buffer if it straddles a block boundary of the symbol stream.
     PDB_NO_DISCARD const CodeView::DBI::Record *
-    GetRecord(const CoalescedMSFStream &symbolRecordStream, const HashRecord &hashRecord) const PDB_NO_EXCEPT;
+    GetRecord(
+        const RecordMSFStream &symbolRecordStream,
+        const HashRecord &hashRecord,
+        RecordMSFStream::RecordBuffer &recordBuffer) const PDB_NO_EXCEPT;
 
     // Returns a view of all the records in the stream.
     PDB_NO_DISCARD inline ArrayView<HashRecord> GetRecords(void) const PDB_NO_EXCEPT
@@ -7,7 +7,7 @@
 #include "Foundation/PDB_BitUtil.h"
 #include "PDB_DBITypes.h"
 #include "PDB_Util.h"
-#include "PDB_CoalescedMSFStream.h"
+#include "PDB_RecordMSFStream.h"
 
 namespace PDB {
 class RawFile;
@@ -21,26 +21,35 @@ public:
     PDB_DEFAULT_MOVE(ModuleSymbolStream);
 
     // Returns a record's parent record.
+    // The record is copied into the buffer if it straddles a block boundary.
     template <typename T>
-    PDB_NO_DISCARD inline const CodeView::DBI::Record *GetParentRecord(const T &record) const PDB_NO_EXCEPT
+    PDB_NO_DISCARD inline const CodeView::DBI::Record *
+    GetParentRecord(const T &record, RecordMSFStream::RecordBuffer &recordBuffer) const PDB_NO_EXCEPT
     {
-        return m_stream.GetDataAtOffset<const CodeView::DBI::Record>(record.parent);
+        return m_stream.GetRecordAtOffset(record.parent, recordBuffer);
     }
 
     // Returns a record's end record.
+    // The record is copied into the buffer if it straddles a block boundary.
     template <typename T>
-    PDB_NO_DISCARD inline const CodeView::DBI::Record *GetEndRecord(const T &record) const PDB_NO_EXCEPT
+    PDB_NO_DISCARD inline const CodeView::DBI::Record *
+    GetEndRecord(const T &record, RecordMSFStream::RecordBuffer &recordBuffer) const PDB_NO_EXCEPT
     {
-        return m_stream.GetDataAtOffset<const CodeView::DBI::Record>(record.end);
+        return m_stream.GetRecordAtOffset(record.end, recordBuffer);
     }
 
     // Finds a record of a certain kind.
-    PDB_NO_DISCARD const CodeView::DBI::Record *FindRecord(CodeView::DBI::SymbolRecordKind Kind) const PDB_NO_EXCEPT;
+    // The record is copied into the buffer if it straddles a block boundary.
+    PDB_NO_DISCARD const CodeView::DBI::Record *
+    FindRecord(CodeView::DBI::SymbolRecordKind Kind, RecordMSFStream::RecordBuffer &recordBuffer) const PDB_NO_EXCEPT;
 
     // Iterates all records in the stream.
+    // A record that straddles a block boundary is only valid until the functor returns.
     template <typename F>
     void ForEachSymbol(F &&functor) const PDB_NO_EXCEPT
     {
+        RecordMSFStream::RecordBuffer recordBuffer;
+
         // ignore the stream's 4-byte signature
         size_t offset = sizeof(uint32_t);
 
@@ -48,7 +57,7 @@ public:
         while (offset < m_stream.GetSize())
         {
             // https://llvm.org/docs/PDB/CodeViewTypes.html
-            const CodeView::DBI::Record *record = m_stream.GetDataAtOffset<const CodeView::DBI::Record>(offset);
+            const CodeView::DBI::Record *record = m_stream.GetRecordAtOffset(offset, recordBuffer);
             const uint32_t recordSize = GetCodeViewRecordSize(record);
 
             functor(record);
@@ -59,7 +68,7 @@ public:
     }
 
 private:
-    CoalescedMSFStream m_stream;
+    RecordMSFStream m_stream;
 
     PDB_DISABLE_COPY(ModuleSymbolStream);
 };
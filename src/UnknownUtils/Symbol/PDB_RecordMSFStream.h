@@ -0,0 +1,64 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "PDB_DirectMSFStream.h"
+#include "PDB_Types.h"
+
+// https://llvm.org/docs/PDB/index.html#the-msf-container
+// https://llvm.org/docs/PDB/MsfFile.html
+namespace PDB {
+namespace CodeView {
+namespace DBI {
+struct Record;
+}
+} // namespace CodeView
+
+// provides access to the CodeView records of an MSF stream without coalescing its blocks.
+// inherently thread-safe, the stream doesn't carry any internal offset or similar.
+// trivial to construct.
+// records that lie within a single block are returned in place, only records that straddle a block boundary are
+// copied into a buffer provided by the caller. useful for large streams that would otherwise need to be coalesced.
+class PDB_NO_DISCARD RecordMSFStream
+{
+public:
+    // holds the copy of a record that straddles a block boundary.
+    // a record copied into the buffer stays valid until the next record is read into the same buffer.
+    class PDB_NO_DISCARD RecordBuffer
+    {
+    public:
+        RecordBuffer(void) PDB_NO_EXCEPT;
+        ~RecordBuffer(void) PDB_NO_EXCEPT;
+
+        // Returns storage for at least the given number of bytes, growing the buffer if needed.
+        PDB_NO_DISCARD void *Reserve(size_t size) PDB_NO_EXCEPT;
+
+    private:
+        Byte *m_data;
+        size_t m_capacity;
+
+        PDB_DISABLE_COPY(RecordBuffer);
+    };
+
+    RecordMSFStream(void) PDB_NO_EXCEPT;
+    explicit RecordMSFStream(const void *data, uint32_t blockSize, const uint32_t *blockIndices, uint32_t streamSize)
+        PDB_NO_EXCEPT;
+
+    PDB_DEFAULT_MOVE(RecordMSFStream);
+
+    // Returns the record at the given offset.
+    // points into the memory-mapped data, unless the record straddles a block boundary and is copied into the buffer.
+    PDB_NO_DISCARD const CodeView::DBI::Record *
+    GetRecordAtOffset(size_t offset, RecordBuffer &buffer) const PDB_NO_EXCEPT;
+
+    // Returns the size of the stream.
+    PDB_NO_DISCARD inline uint32_t GetSize(void) const PDB_NO_EXCEPT { return m_stream.GetSize(); }
+
+private:
+    DirectMSFStream m_stream;
+
+    PDB_DISABLE_COPY(RecordMSFStream);
+};
+} // namespace PDB
@@ -208,11 +208,12 @@ PDB::DBIStream::HasValidSectionContributionStream(const RawFile & /* file */) co
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
-PDB_NO_DISCARD PDB::CoalescedMSFStream
+PDB_NO_DISCARD PDB::RecordMSFStream
 PDB::DBIStream::CreateSymbolRecordStream(const RawFile &file) const PDB_NO_EXCEPT
 {
-    // the symbol record stream holds the actual CodeView data of the symbols
-    return file.CreateMSFStream<CoalescedMSFStream>(m_header.symbolRecordStreamIndex);
+    // the symbol record stream holds the actual CodeView data of the symbols.
+    // it is one of the largest streams, so its records are read in place rather than coalescing the whole stream.
+    return file.CreateMSFStream<RecordMSFStream>(m_header.symbolRecordStreamIndex);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -23,15 +23,17 @@ PDB::PublicSymbolStream::PublicSymbolStream(const RawFile &file, uint16_t stream
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 PDB_NO_DISCARD const PDB::CodeView::DBI::Record *
-PDB::PublicSymbolStream::GetRecord(const CoalescedMSFStream &symbolRecordStream, const HashRecord &hashRecord) const
-    PDB_NO_EXCEPT
+PDB::PublicSymbolStream::GetRecord(
+    const RecordMSFStream &symbolRecordStream,
+    const HashRecord &hashRecord,
+    RecordMSFStream::RecordBuffer &recordBuffer) const PDB_NO_EXCEPT
 {
     // hash record offsets start at 1, not at 0
     const uint32_t headerOffset = hashRecord.offset - 1u;
 
     // the offset doesn't point to the public symbol directly, but to the CodeView record:
     // https://llvm.org/docs/PDB/CodeViewSymbols.html
-    const CodeView::DBI::Record *record = symbolRecordStream.GetDataAtOffset<const CodeView::DBI::Record>(headerOffset);
+    const CodeView::DBI::Record *record = symbolRecordStream.GetRecordAtOffset(headerOffset, recordBuffer);
 
     if (record->header.kind != CodeView::DBI::SymbolRecordKind::S_PUB32)
     {
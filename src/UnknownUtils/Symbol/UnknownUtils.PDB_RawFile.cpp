@@ -6,6 +6,7 @@
 #include "PDB_Types.h"
 #include "PDB_Util.h"
 #include "PDB_DirectMSFStream.h"
+#include "PDB_RecordMSFStream.h"
 #include "Foundation/PDB_PointerUtil.h"
 #include "Foundation/PDB_Memory.h"
 #include "Foundation/PDB_Assert.h"
@@ -139,8 +140,12 @@ template PDB::CoalescedMSFStream
 PDB::RawFile::CreateMSFStream<PDB::CoalescedMSFStream>(uint32_t streamIndex) const PDB_NO_EXCEPT;
 template PDB::DirectMSFStream
 PDB::RawFile::CreateMSFStream<PDB::DirectMSFStream>(uint32_t streamIndex) const PDB_NO_EXCEPT;
+template PDB::RecordMSFStream
+PDB::RawFile::CreateMSFStream<PDB::RecordMSFStream>(uint32_t streamIndex) const PDB_NO_EXCEPT;
 
 template PDB::CoalescedMSFStream
 PDB::RawFile::CreateMSFStream<PDB::CoalescedMSFStream>(uint32_t streamIndex, uint32_t streamSize) const PDB_NO_EXCEPT;
 template PDB::DirectMSFStream
 PDB::RawFile::CreateMSFStream<PDB::DirectMSFStream>(uint32_t streamIndex, uint32_t streamSize) const PDB_NO_EXCEPT;
+template PDB::RecordMSFStream
+PDB::RawFile::CreateMSFStream<PDB::RecordMSFStream>(uint32_t streamIndex, uint32_t streamSize) const PDB_NO_EXCEPT;
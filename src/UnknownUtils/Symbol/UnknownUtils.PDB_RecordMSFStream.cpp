@@ -0,0 +1,76 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_RecordMSFStream.h"
+#include "PDB_DBITypes.h"
+#include "Foundation/PDB_PointerUtil.h"
+#include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_Assert.h"
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RecordMSFStream::RecordBuffer::RecordBuffer(void) PDB_NO_EXCEPT : m_data(nullptr), m_capacity(0u) {}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RecordMSFStream::RecordBuffer::~RecordBuffer(void) PDB_NO_EXCEPT
+{
+    PDB_DELETE_ARRAY(m_data);
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD void *
+PDB::RecordMSFStream::RecordBuffer::Reserve(size_t size) PDB_NO_EXCEPT
+{
+    if (size > m_capacity)
+    {
+        // records are small, so the buffer quickly reaches the size of the largest straddling record
+        PDB_DELETE_ARRAY(m_data);
+        m_data = PDB_NEW_ARRAY(Byte, size);
+        m_capacity = size;
+    }
+
+    return m_data;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RecordMSFStream::RecordMSFStream(void) PDB_NO_EXCEPT : m_stream() {}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RecordMSFStream::RecordMSFStream(
+    const void *data,
+    uint32_t blockSize,
+    const uint32_t *blockIndices,
+    uint32_t streamSize) PDB_NO_EXCEPT : m_stream(data, blockSize, blockIndices, streamSize)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::CodeView::DBI::Record *
+PDB::RecordMSFStream::GetRecordAtOffset(size_t offset, RecordBuffer &buffer) const PDB_NO_EXCEPT
+{
+    // the size field of a record might already straddle a block boundary, so it is read rather than accessed in place.
+    // the stored size doesn't include the size of the 'size' field itself.
+    const size_t recordSize = sizeof(uint16_t) + m_stream.ReadAtOffset<uint16_t>(offset);
+    PDB_ASSERT(offset + recordSize <= m_stream.GetSize(), "Record exceeds the stream.");
+
+    const DirectMSFStream::IndexAndOffset indexAndOffset =
+        m_stream.GetBlockIndexForOffset(static_cast<uint32_t>(offset));
+    if (indexAndOffset.offsetWithinBlock + recordSize <= m_stream.GetBlockSize())
+    {
+        // fast path, the record lies within a single block and can be accessed in place
+        const size_t offsetWithinData = m_stream.GetDataOffsetForIndexAndOffset(indexAndOffset);
+        return Pointer::Offset<const CodeView::DBI::Record *>(m_stream.GetData(), offsetWithinData);
+    }
+
+    // slower path, the record is scattered across several blocks and has to be copied
+    void *record = buffer.Reserve(recordSize);
+    m_stream.ReadAtOffset(record, recordSize, offset);
+
+    return static_cast<const CodeView::DBI::Record *>(record);
+}
@@ -0,0 +1,253 @@
+#include <unknown/Symbol/SymbolCache.h>
+
+#include <unknown/ADT/StringExtras.h>
+#include <unknown/ADT/StringMap.h>
+#include <unknown/Support/Endian.h>
+#include <unknown/Support/FileSystem.h>
+#include <unknown/Support/MemoryBuffer.h>
+#include <unknown/Support/Path.h>
+#include <unknown/Support/ToolOutputFile.h>
+
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace unknown {
+
+namespace {
+// Bump the version whenever the records or the symbols produced by the parsers change
+constexpr char SymbolCacheMagic[8] = {'U', 'S', 'Y', 'M', 'C', 'A', 'C', 'H'};
+constexpr uint32_t SymbolCacheVersion = 1;
+constexpr size_t SymbolCacheMaxKeySize = 32;
+
+// magic, version, key size, key, image base, number of symbols, size of the names
+constexpr size_t SymbolCacheHeaderSize = sizeof(SymbolCacheMagic) + 4 + 4 + SymbolCacheMaxKeySize + 8 + 4 + 4;
+
+// name offset, name size, internal name offset, internal name size, rva, size, cbFrame, cbPad, offPad, cbSaveRegs,
+// offExHdlr, sectExHdlr, flags
+constexpr size_t SymbolCacheRecordSize = 11 * 4 + 2 + 2;
+
+// The flags of a function symbol, one bit each
+constexpr bool SymbolParser::FunctionSymbol::*SymbolCacheFlags[] = {
+    &SymbolParser::FunctionSymbol::hasAlloca,
+    &SymbolParser::FunctionSymbol::hasSetJmp,
+    &SymbolParser::FunctionSymbol::hasLongJmp,
+    &SymbolParser::FunctionSymbol::hasInlAsm,
+    &SymbolParser::FunctionSymbol::hasEH,
+    &SymbolParser::FunctionSymbol::hasSEH,
+    &SymbolParser::FunctionSymbol::hasNaked,
+    &SymbolParser::FunctionSymbol::hasSecurityChecks,
+    &SymbolParser::FunctionSymbol::hasAsyncEH,
+    &SymbolParser::FunctionSymbol::hasWasInlined,
+    &SymbolParser::FunctionSymbol::hasGSCheck,
+    &SymbolParser::FunctionSymbol::hasSafeBuffers,
+    &SymbolParser::FunctionSymbol::hasOptSpeed,
+    &SymbolParser::FunctionSymbol::hasGuardCF,
+};
+static_assert(std::size(SymbolCacheFlags) <= 16, "The flags do not fit in a record!");
+
+// Get a name of the blob, returns false if it is out of the blob
+bool
+ReadSymbolCacheName(StringRef Names, const uint8_t *Ptr, StringRef &Name)
+{
+    uint32_t Offset = support::endian::read32le(Ptr);
+    uint32_t Size = support::endian::read32le(Ptr + 4);
+    if (Offset > Names.size() || Size > Names.size() - Offset)
+    {
+        return false;
+    }
+
+    Name = Names.substr(Offset, Size);
+    return true;
+}
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////
+//// Function
+// Get the path of the cache file of the symbol file identified by Key
+std::string
+GetSymbolCachePath(StringRef CacheDirectory, StringRef Key)
+{
+    SmallString<256> Path(CacheDirectory);
+    sys::path::append(Path, toHex(Key, true) + ".symcache");
+    return Path.str().str();
+}
+
+// Read the function symbols of a cache file, returns false if it is missing, invalid or was written for another key.
+// The names point into the mapped cache file, which is handed out in Buffer.
+bool
+ReadSymbolCache(
+    StringRef CachePath,
+    StringRef Key,
+    uint64_t &ImageBase,
+    std::vector<SymbolParser::FunctionSymbol> &FunctionSymbols,
+    std::unique_ptr<MemoryBuffer> &Buffer)
+{
+    auto BufferOrErr = MemoryBuffer::getFile(CachePath, -1, false);
+    if (!BufferOrErr)
+    {
+        return false;
+    }
+
+    auto Data = (*BufferOrErr)->getBuffer();
+    auto Ptr = reinterpret_cast<const uint8_t *>(Data.data());
+    if (Data.size() < SymbolCacheHeaderSize || std::memcmp(Ptr, SymbolCacheMagic, sizeof(SymbolCacheMagic)) != 0)
+    {
+        return false;
+    }
+    Ptr += sizeof(SymbolCacheMagic);
+
+    uint32_t Version = support::endian::read32le(Ptr);
+    uint32_t KeySize = support::endian::read32le(Ptr + 4);
+    Ptr += 8;
+    if (Version != SymbolCacheVersion || KeySize != Key.size() || std::memcmp(Ptr, Key.data(), Key.size()) != 0)
+    {
+        // stale
+        return false;
+    }
+    Ptr += SymbolCacheMaxKeySize;
+
+    uint64_t CachedImageBase = support::endian::read64le(Ptr);
+    uint64_t NumSymbols = support::endian::read32le(Ptr + 8);
+    uint64_t NamesSize = support::endian::read32le(Ptr + 12);
+    Ptr += 16;
+    if (Data.size() != SymbolCacheHeaderSize + NumSymbols * SymbolCacheRecordSize + NamesSize)
+    {
+        return false;
+    }
+
+    StringRef Names = Data.take_back(NamesSize);
+    std::vector<SymbolParser::FunctionSymbol> Symbols(NumSymbols);
+    for (auto &Sym : Symbols)
+    {
+        if (!ReadSymbolCacheName(Names, Ptr, Sym.name) || !ReadSymbolCacheName(Names, Ptr + 8, Sym.internal_name))
+        {
+            return false;
+        }
+
+        Sym.rva = support::endian::read32le(Ptr + 16);
+        Sym.size = support::endian::read32le(Ptr + 20);
+        Sym.cbFrame = support::endian::read32le(Ptr + 24);
+        Sym.cbPad = support::endian::read32le(Ptr + 28);
+        Sym.offPad = support::endian::read32le(Ptr + 32);
+        Sym.cbSaveRegs = support::endian::read32le(Ptr + 36);
+        Sym.offExHdlr = support::endian::read32le(Ptr + 40);
+        Sym.sectExHdlr = support::endian::read16le(Ptr + 44);
+
+        uint16_t Flags = support::endian::read16le(Ptr + 46);
+        for (size_t Index = 0; Index < std::size(SymbolCacheFlags); ++Index)
+        {
+            Sym.*SymbolCacheFlags[Index] = (Flags >> Index) & 1;
+        }
+        Ptr += SymbolCacheRecordSize;
+    }
+
+    ImageBase = CachedImageBase;
+    std::swap(FunctionSymbols, Symbols);
+    Buffer = std::move(*BufferOrErr);
+    return true;
+}
+
+// Write the function symbols to a cache file, the file is removed if it could not be written
+bool
+WriteSymbolCache(
+    StringRef CachePath,
+    StringRef Key,
+    uint64_t ImageBase,
+    const std::vector<SymbolParser::FunctionSymbol> &FunctionSymbols)
+{
+    if (Key.size() > SymbolCacheMaxKeySize || FunctionSymbols.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+
+    // Lay out the names first, the internal name is most often the same as the name
+    StringMap<uint32_t> NameOffsets;
+    std::string Names;
+    auto addName = [&NameOffsets, &Names](StringRef Name) {
+        auto Inserted = NameOffsets.try_emplace(Name, static_cast<uint32_t>(Names.size()));
+        if (Inserted.second)
+        {
+            Names.append(Name.begin(), Name.end());
+            Names.push_back('\0');
+        }
+        return Inserted.first->second;
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> SymbolNames;
+    SymbolNames.reserve(FunctionSymbols.size());
+    for (auto &Sym : FunctionSymbols)
+    {
+        SymbolNames.emplace_back(addName(Sym.name), addName(Sym.internal_name));
+        if (Names.size() > std::numeric_limits<uint32_t>::max())
+        {
+            return false;
+        }
+    }
+
+    auto CacheDirectory = sys::path::parent_path(CachePath);
+    if (!CacheDirectory.empty() && sys::fs::create_directories(CacheDirectory))
+    {
+        return false;
+    }
+
+    std::error_code EC;
+    ToolOutputFile Out(CachePath, EC, sys::fs::OF_None);
+    if (EC)
+    {
+        return false;
+    }
+
+    char Header[SymbolCacheHeaderSize] = {};
+    auto Ptr = Header;
+    std::memcpy(Ptr, SymbolCacheMagic, sizeof(SymbolCacheMagic));
+    Ptr += sizeof(SymbolCacheMagic);
+    support::endian::write32le(Ptr, SymbolCacheVersion);
+    support::endian::write32le(Ptr + 4, static_cast<uint32_t>(Key.size()));
+    Ptr += 8;
+    std::memcpy(Ptr, Key.data(), Key.size());
+    Ptr += SymbolCacheMaxKeySize;
+    support::endian::write64le(Ptr, ImageBase);
+    support::endian::write32le(Ptr + 8, static_cast<uint32_t>(FunctionSymbols.size()));
+    support::endian::write32le(Ptr + 12, static_cast<uint32_t>(Names.size()));
+    Out.os().write(Header, sizeof(Header));
+
+    for (size_t Index = 0; Index < FunctionSymbols.size(); ++Index)
+    {
+        auto &Sym = FunctionSymbols[Index];
+        char Record[SymbolCacheRecordSize];
+        support::endian::write32le(Record, SymbolNames[Index].first);
+        support::endian::write32le(Record + 4, static_cast<uint32_t>(Sym.name.size()));
+        support::endian::write32le(Record + 8, SymbolNames[Index].second);
+        support::endian::write32le(Record + 12, static_cast<uint32_t>(Sym.internal_name.size()));
+        support::endian::write32le(Record + 16, Sym.rva);
+        support::endian::write32le(Record + 20, Sym.size);
+        support::endian::write32le(Record + 24, Sym.cbFrame);
+        support::endian::write32le(Record + 28, Sym.cbPad);
+        support::endian::write32le(Record + 32, Sym.offPad);
+        support::endian::write32le(Record + 36, Sym.cbSaveRegs);
+        support::endian::write32le(Record + 40, Sym.offExHdlr);
+        support::endian::write16le(Record + 44, Sym.sectExHdlr);
+
+        uint16_t Flags = 0;
+        for (size_t FlagIndex = 0; FlagIndex < std::size(SymbolCacheFlags); ++FlagIndex)
+        {
+            Flags |= (Sym.*SymbolCacheFlags[FlagIndex] ? 1 : 0) << FlagIndex;
+        }
+        support::endian::write16le(Record + 46, Flags);
+        Out.os().write(Record, sizeof(Record));
+    }
+
+    Out.os() << Names;
+
+    Out.os().close();
+    if (Out.os().has_error())
+    {
+        Out.os().clear_error();
+        return false;
+    }
+
+    Out.keep();
+    return true;
+}
+
+} // namespace unknown
@@ -1,4 +1,5 @@
 #include <unknown/Symbol/SymbolParser.h>
+#include <unknown/Symbol/SymbolCache.h>
 
 #include "Symbol/PDB.h"
 #include "Symbol/PDB_RawFile.h"
@@ -8,13 +9,23 @@
 #include "Symbol/PDB_NamesStream.h"
 #include "Symbol/ExampleMemoryMappedFile.h"
 
-#include <unordered_set>
-#include <regex>
+#include <unknown/ADT/StringExtras.h>
+#include <unknown/Support/Endian.h>
+#include <unknown/Support/MD5.h>
+#include <unknown/Support/MemoryBuffer.h>
+#include <unknown/Support/StringSaver.h>
+#include <unknown/Support/ThreadPool.h>
+#include <unknown/Support/Threading.h>
+
+#include <algorithm>
 #include <cstdio>
-#include <io.h>
+#include <cstring>
 #include <iostream>
-#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <ostream>
+#include <tuple>
 
 namespace unknown {
 
@@ -84,166 +95,304 @@ HasValidDBIStreams(const PDB::RawFile &rawPdbFile, const PDB::DBIStream &dbiStre
 }
 } // namespace
 
-class SymbolParserByPDB : public SymbolParser
+////////////////////////////////////////////////////////////////////////////////////////
+//// Cache
+// Load the function symbols cached for the symbol file identified by Key
+bool
+SymbolParser::ReadFunctionSymbolCache(StringRef Key)
 {
-public:
-    SymbolParserByPDB() : SymbolParser() {}
-    ~SymbolParserByPDB() = default;
+    if (mCacheDirectory.empty())
+    {
+        return false;
+    }
 
-private:
-    void ExampleFunctionSymbols(const PDB::RawFile &rawPdbFile, const PDB::DBIStream &dbiStream)
+    uint64_t ImageBase = 0;
+    if (!ReadSymbolCache(
+            GetSymbolCachePath(mCacheDirectory, Key), Key, ImageBase, mFunctionSymbols, mSymbolFileBuffer))
     {
-        const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawPdbFile);
+        return false;
+    }
 
-        // prepare the module info stream for grabbing function symbols from modules
-        const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawPdbFile);
+    if (mImageBase == 0)
+    {
+        mImageBase = ImageBase;
+    }
+    return true;
+}
+
+// Cache the function symbols of the symbol file identified by Key
+bool
+SymbolParser::WriteFunctionSymbolCache(StringRef Key) const
+{
+    if (mCacheDirectory.empty())
+    {
+        return false;
+    }
 
-        // prepare symbol record stream needed by the public stream
-        const PDB::CoalescedMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawPdbFile);
+    return WriteSymbolCache(GetSymbolCachePath(mCacheDirectory, Key), Key, mImageBase, mFunctionSymbols);
+}
 
-        // note that we only use unordered_set in order to keep the example code easy to understand.
-        // using other hash set implementations like e.g. abseil's Swiss Tables
-        // (https://abseil.io/about/design/swisstables) is *much* faster.
-        std::vector<FunctionSymbol> functionSymbols;
-        std::unordered_set<uint32_t> seenFunctionRVAs;
+////////////////////////////////////////////////////////////////////////////////////////
+//// Name
+// Keep a name that does not live in a mapped file in the name arena
+StringRef
+SymbolParser::SaveSymbolName(StringRef Name)
+{
+    return StringSaver(mNameAllocator).save(Name);
+}
 
-        // start by reading the module stream, grabbing every function symbol we can find.
-        // in most cases, this gives us ~90% of all function symbols already, along with their size.
+// Drop the symbols of the last parse along with the mapped file and the arena their names point into
+void
+SymbolParser::ClearSymbols()
+{
+    mCommonSymbols.clear();
+    mFunctionSymbols.clear();
+    mSymbolFileBuffer.reset();
+    mNameAllocator.Reset();
+}
+
+class SymbolParserByPDB : public SymbolParser
+{
+private:
+    // The PDB stays mapped while the names of the symbols point into it
+    MemoryMappedFile::Handle mPdbFile;
+    StringRef mPdbFileData;
+
+    // The names of the records copied out of the mapped PDB, one arena per module
+    std::vector<BumpPtrAllocator> mModuleNameAllocators;
+
+public:
+    SymbolParserByPDB() : SymbolParser(), mPdbFile{} {}
+    ~SymbolParserByPDB() { ClosePdbFile(); }
+
+private:
+    void ClosePdbFile()
+    {
+        if (mPdbFile.baseAddress)
         {
-            const PDB::ArrayView<PDB::ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+            MemoryMappedFile::Close(mPdbFile);
+        }
+        mPdbFileData = StringRef();
+    }
 
-            for (const PDB::ModuleInfoStream::Module &module : modules)
-            {
-                if (!module.HasSymbolStream())
-                {
-                    continue;
-                }
+    // Get the name of a record, it is only copied if the record was copied out of the mapped PDB
+    StringRef GetRecordName(StringRef name, BumpPtrAllocator &nameAllocator) const
+    {
+        if (name.begin() >= mPdbFileData.begin() && name.end() < mPdbFileData.end())
+        {
+            return name;
+        }
 
-                const PDB::ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(rawPdbFile);
-                moduleSymbolStream.ForEachSymbol([&functionSymbols, &seenFunctionRVAs, &imageSectionStream](
-                                                     const PDB::CodeView::DBI::Record *record) {
-                    // only grab function symbols from the module streams
-                    const char *name = nullptr;
-                    uint32_t rva = 0u;
-                    uint32_t size = 0u;
-                    if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_FRAMEPROC)
+        return StringSaver(nameAllocator).save(name);
+    }
+
+    // Collect the function symbols of the symbol stream of a module
+    void ModuleFunctionSymbols(
+        const PDB::RawFile &rawPdbFile,
+        const PDB::ImageSectionStream &imageSectionStream,
+        const PDB::ModuleInfoStream::Module &module,
+        std::vector<FunctionSymbol> &functionSymbols,
+        BumpPtrAllocator &nameAllocator) const
+    {
+        const PDB::ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(rawPdbFile);
+        moduleSymbolStream.ForEachSymbol(
+            [this, &functionSymbols, &nameAllocator, &imageSectionStream](const PDB::CodeView::DBI::Record *record) {
+                // only grab function symbols from the module streams
+                const char *name = nullptr;
+                uint32_t rva = 0u;
+                uint32_t size = 0u;
+                if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_FRAMEPROC)
+                {
+                    // the frame of a procedure follows the procedure within the same module
+                    if (functionSymbols.empty())
                     {
-                        // functionSymbols[functionSymbols.size() - 1].frameProc = record;
-                        functionSymbols[functionSymbols.size() - 1].cbFrame = record->data.S_FRAMEPROC.cbFrame;
-                        functionSymbols[functionSymbols.size() - 1].cbPad = record->data.S_FRAMEPROC.cbPad;
-                        functionSymbols[functionSymbols.size() - 1].offPad = record->data.S_FRAMEPROC.offPad;
-                        functionSymbols[functionSymbols.size() - 1].cbSaveRegs = record->data.S_FRAMEPROC.cbSaveRegs;
-                        functionSymbols[functionSymbols.size() - 1].offExHdlr = record->data.S_FRAMEPROC.offExHdlr;
-                        functionSymbols[functionSymbols.size() - 1].sectExHdlr = record->data.S_FRAMEPROC.sectExHdlr;
+                        return;
+                    }
 
-                        functionSymbols[functionSymbols.size() - 1].hasAlloca =
-                            record->data.S_FRAMEPROC.flags.fHasAlloca ? true : false;
+                    // functionSymbols[functionSymbols.size() - 1].frameProc = record;
+                    functionSymbols[functionSymbols.size() - 1].cbFrame = record->data.S_FRAMEPROC.cbFrame;
+                    functionSymbols[functionSymbols.size() - 1].cbPad = record->data.S_FRAMEPROC.cbPad;
+                    functionSymbols[functionSymbols.size() - 1].offPad = record->data.S_FRAMEPROC.offPad;
+                    functionSymbols[functionSymbols.size() - 1].cbSaveRegs = record->data.S_FRAMEPROC.cbSaveRegs;
+                    functionSymbols[functionSymbols.size() - 1].offExHdlr = record->data.S_FRAMEPROC.offExHdlr;
+                    functionSymbols[functionSymbols.size() - 1].sectExHdlr = record->data.S_FRAMEPROC.sectExHdlr;
 
-                        functionSymbols[functionSymbols.size() - 1].hasSetJmp =
-                            record->data.S_FRAMEPROC.flags.fHasSetJmp ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasAlloca =
+                        record->data.S_FRAMEPROC.flags.fHasAlloca ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasLongJmp =
-                            record->data.S_FRAMEPROC.flags.fHasLongJmp ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasSetJmp =
+                        record->data.S_FRAMEPROC.flags.fHasSetJmp ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasInlAsm =
-                            record->data.S_FRAMEPROC.flags.fHasInlAsm ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasLongJmp =
+                        record->data.S_FRAMEPROC.flags.fHasLongJmp ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasEH =
-                            record->data.S_FRAMEPROC.flags.fHasEH ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasInlAsm =
+                        record->data.S_FRAMEPROC.flags.fHasInlAsm ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasSEH =
-                            record->data.S_FRAMEPROC.flags.fHasSEH ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasEH =
+                        record->data.S_FRAMEPROC.flags.fHasEH ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasNaked =
-                            record->data.S_FRAMEPROC.flags.fNaked ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasSEH =
+                        record->data.S_FRAMEPROC.flags.fHasSEH ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasSecurityChecks =
-                            record->data.S_FRAMEPROC.flags.fSecurityChecks ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasNaked =
+                        record->data.S_FRAMEPROC.flags.fNaked ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasAsyncEH =
-                            record->data.S_FRAMEPROC.flags.fAsyncEH ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasSecurityChecks =
+                        record->data.S_FRAMEPROC.flags.fSecurityChecks ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasWasInlined =
-                            record->data.S_FRAMEPROC.flags.fWasInlined ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasAsyncEH =
+                        record->data.S_FRAMEPROC.flags.fAsyncEH ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasGSCheck =
-                            record->data.S_FRAMEPROC.flags.fGSCheck ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasWasInlined =
+                        record->data.S_FRAMEPROC.flags.fWasInlined ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasSafeBuffers =
-                            record->data.S_FRAMEPROC.flags.fSafeBuffers ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasGSCheck =
+                        record->data.S_FRAMEPROC.flags.fGSCheck ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasOptSpeed =
-                            record->data.S_FRAMEPROC.flags.fOptSpeed ? true : false;
+                    functionSymbols[functionSymbols.size() - 1].hasSafeBuffers =
+                        record->data.S_FRAMEPROC.flags.fSafeBuffers ? true : false;
 
-                        functionSymbols[functionSymbols.size() - 1].hasGuardCF =
-                            record->data.S_FRAMEPROC.flags.fGuardCF ? true : false;
-                        return;
-                    }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_THUNK32)
-                    {
-                        if (record->data.S_THUNK32.thunk == PDB::CodeView::DBI::ThunkOrdinal::TrampolineIncremental)
-                        {
-                            // we have never seen incremental linking thunks stored inside a S_THUNK32 symbol, but
-                            // better safe than sorry
-                            name = "ILT";
-                            rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                                record->data.S_THUNK32.section, record->data.S_THUNK32.offset);
-                            size = 5u;
-                        }
-                    }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_TRAMPOLINE)
+                    functionSymbols[functionSymbols.size() - 1].hasOptSpeed =
+                        record->data.S_FRAMEPROC.flags.fOptSpeed ? true : false;
+
+                    functionSymbols[functionSymbols.size() - 1].hasGuardCF =
+                        record->data.S_FRAMEPROC.flags.fGuardCF ? true : false;
+                    return;
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_THUNK32)
+                {
+                    if (record->data.S_THUNK32.thunk == PDB::CodeView::DBI::ThunkOrdinal::TrampolineIncremental)
                     {
-                        // incremental linking thunks are stored in the linker module
+                        // we have never seen incremental linking thunks stored inside a S_THUNK32 symbol, but
+                        // better safe than sorry
                         name = "ILT";
                         rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                            record->data.S_TRAMPOLINE.thunkSection, record->data.S_TRAMPOLINE.thunkOffset);
+                            record->data.S_THUNK32.section, record->data.S_THUNK32.offset);
                         size = 5u;
                     }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_LPROC32)
-                    {
-                        name = record->data.S_LPROC32.name;
-                        rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                            record->data.S_LPROC32.section, record->data.S_LPROC32.offset);
-                        size = record->data.S_LPROC32.codeSize;
-                    }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_GPROC32)
-                    {
-                        name = record->data.S_GPROC32.name;
-                        rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                            record->data.S_GPROC32.section, record->data.S_GPROC32.offset);
-                        size = record->data.S_GPROC32.codeSize;
-                    }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_LPROC32_ID)
-                    {
-                        name = record->data.S_LPROC32_ID.name;
-                        rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                            record->data.S_LPROC32_ID.section, record->data.S_LPROC32_ID.offset);
-                        size = record->data.S_LPROC32_ID.codeSize;
-                    }
-                    else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_GPROC32_ID)
-                    {
-                        name = record->data.S_GPROC32_ID.name;
-                        rva = imageSectionStream.ConvertSectionOffsetToRVA(
-                            record->data.S_GPROC32_ID.section, record->data.S_GPROC32_ID.offset);
-                        size = record->data.S_GPROC32_ID.codeSize;
-                    }
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_TRAMPOLINE)
+                {
+                    // incremental linking thunks are stored in the linker module
+                    name = "ILT";
+                    rva = imageSectionStream.ConvertSectionOffsetToRVA(
+                        record->data.S_TRAMPOLINE.thunkSection, record->data.S_TRAMPOLINE.thunkOffset);
+                    size = 5u;
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_LPROC32)
+                {
+                    name = record->data.S_LPROC32.name;
+                    rva = imageSectionStream.ConvertSectionOffsetToRVA(
+                        record->data.S_LPROC32.section, record->data.S_LPROC32.offset);
+                    size = record->data.S_LPROC32.codeSize;
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_GPROC32)
+                {
+                    name = record->data.S_GPROC32.name;
+                    rva = imageSectionStream.ConvertSectionOffsetToRVA(
+                        record->data.S_GPROC32.section, record->data.S_GPROC32.offset);
+                    size = record->data.S_GPROC32.codeSize;
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_LPROC32_ID)
+                {
+                    name = record->data.S_LPROC32_ID.name;
+                    rva = imageSectionStream.ConvertSectionOffsetToRVA(
+                        record->data.S_LPROC32_ID.section, record->data.S_LPROC32_ID.offset);
+                    size = record->data.S_LPROC32_ID.codeSize;
+                }
+                else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_GPROC32_ID)
+                {
+                    name = record->data.S_GPROC32_ID.name;
+                    rva = imageSectionStream.ConvertSectionOffsetToRVA(
+                        record->data.S_GPROC32_ID.section, record->data.S_GPROC32_ID.offset);
+                    size = record->data.S_GPROC32_ID.codeSize;
+                }
 
-                    if (rva == 0u)
-                    {
-                        return;
-                    }
+                if (rva == 0u)
+                {
+                    return;
+                }
+
+                if (size == 0u)
+                {
+                    return;
+                }
+
+                const StringRef symbolName = GetRecordName(name, nameAllocator);
+                functionSymbols.push_back(FunctionSymbol{symbolName, symbolName, rva, size});
+            });
+    }
 
-                    if (size == 0u)
+    void ExampleFunctionSymbols(const PDB::RawFile &rawPdbFile, const PDB::DBIStream &dbiStream)
+    {
+        const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawPdbFile);
+
+        // prepare the module info stream for grabbing function symbols from modules
+        const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawPdbFile);
+
+        // prepare symbol record stream needed by the public stream, its records are read in place
+        const PDB::RecordMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawPdbFile);
+
+        std::vector<FunctionSymbol> functionSymbols;
+
+        // start by reading the module stream, grabbing every function symbol we can find.
+        // in most cases, this gives us ~90% of all function symbols already, along with their size.
+        {
+            const PDB::ArrayView<PDB::ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+
+            // the symbol streams of the modules are independent, so each module is parsed on its own into its own
+            // vector. they are merged in module order afterwards.
+            std::vector<std::vector<FunctionSymbol>> moduleFunctionSymbols(modules.GetLength());
+            mModuleNameAllocators.resize(modules.GetLength());
+            if (!moduleFunctionSymbols.empty())
+            {
+                ThreadPool pool(std::min<unsigned>(hardware_concurrency(), moduleFunctionSymbols.size()));
+                for (size_t i = 0u; i < modules.GetLength(); ++i)
+                {
+                    if (!modules[i].HasSymbolStream())
                     {
-                        return;
+                        continue;
                     }
 
-                    functionSymbols.push_back(FunctionSymbol{name, name, rva, size});
-                    seenFunctionRVAs.emplace(rva);
-                });
+                    pool.async([this, &rawPdbFile, &imageSectionStream, &modules, &moduleFunctionSymbols, i]() {
+                        ModuleFunctionSymbols(
+                            rawPdbFile,
+                            imageSectionStream,
+                            modules[i],
+                            moduleFunctionSymbols[i],
+                            mModuleNameAllocators[i]);
+                    });
+                }
+                pool.wait();
+            }
+
+            size_t symbolCount = 0u;
+            for (const auto &symbols : moduleFunctionSymbols)
+            {
+                symbolCount += symbols.size();
+            }
+
+            functionSymbols.reserve(symbolCount);
+            for (auto &symbols : moduleFunctionSymbols)
+            {
+                std::move(symbols.begin(), symbols.end(), std::back_inserter(functionSymbols));
             }
         }
 
+        // a function may be reported by several modules, keep the first one of each RVA.
+        // sorting and removing the adjacent duplicates is much faster than a node-based hash set.
+        std::stable_sort(
+            functionSymbols.begin(), functionSymbols.end(), [](const FunctionSymbol &lhs, const FunctionSymbol &rhs) {
+                return lhs.rva < rhs.rva;
+            });
+        functionSymbols.erase(
+            std::unique(
+                functionSymbols.begin(),
+                functionSymbols.end(),
+                [](const FunctionSymbol &lhs, const FunctionSymbol &rhs) { return lhs.rva == rhs.rva; }),
+            functionSymbols.end());
+
         // we don't need to touch global symbols in this case.
         // most of the data we need can be obtained from the module symbol streams, and the global symbol stream only
         // offers data symbols on top of that, which we are not interested in. however, there can still be public
@@ -257,9 +406,12 @@ private:
             const PDB::ArrayView<PDB::HashRecord> hashRecords = publicSymbolStream.GetRecords();
             const size_t count = hashRecords.GetLength();
 
+            // holds a record that straddles a block boundary, until the next record is read
+            PDB::RecordMSFStream::RecordBuffer recordBuffer;
             for (const PDB::HashRecord &hashRecord : hashRecords)
             {
-                const PDB::CodeView::DBI::Record *record = publicSymbolStream.GetRecord(symbolRecordStream, hashRecord);
+                const PDB::CodeView::DBI::Record *record =
+                    publicSymbolStream.GetRecord(symbolRecordStream, hashRecord, recordBuffer);
                 if ((PDB_AS_UNDERLYING(record->data.S_PUB32.flags) &
                      PDB_AS_UNDERLYING(PDB::CodeView::DBI::PublicSymbolFlags::Function)) == 0u)
                 {
@@ -277,18 +429,16 @@ private:
 
                 // this is a new function symbol, so store it.
                 // note that we don't know its size yet.
-                publicSymbols.push_back(FunctionSymbol{record->data.S_PUB32.name, record->data.S_PUB32.name, rva, 0u});
+                // a record copied into the buffer is overwritten by the next one, so its name is kept in the arena.
+                const StringRef publicName = GetRecordName(record->data.S_PUB32.name, mNameAllocator);
+                publicSymbols.push_back(FunctionSymbol{publicName, publicName, rva, 0u});
             }
         }
 
         // we still need to find the size of the public function symbols.
-        // this can be deduced by sorting the symbols by their RVA, and then computing the distance between the current
+        // this can be deduced from the symbols sorted by their RVA above, by computing the distance between the current
         // and the next symbol. this works since functions are always mapped to executable pages, so they aren't
         // interleaved by any data symbols.
-        std::sort(
-            functionSymbols.begin(), functionSymbols.end(), [](const FunctionSymbol &lhs, const FunctionSymbol &rhs) {
-                return lhs.rva < rhs.rva;
-            });
 
         const size_t symbolCount = functionSymbols.size();
         if (symbolCount != 0u)
@@ -345,7 +495,10 @@ private:
                     {
                         // should have found the contribution by now
                         printf(
-                            "Unknown contribution for symbol %s at RVA 0x%X", lastSymbol.name.c_str(), lastSymbol.rva);
+                            "Unknown contribution for symbol %.*s at RVA 0x%X",
+                            static_cast<int>(lastSymbol.name.size()),
+                            lastSymbol.name.data(),
+                            lastSymbol.rva);
                         break;
                     }
                 }
@@ -354,14 +507,21 @@ private:
 
         if (!functionSymbols.empty())
         {
+            // the public name of a function wins, the last one if there are several at its RVA
+            std::stable_sort(
+                publicSymbols.begin(), publicSymbols.end(), [](const FunctionSymbol &lhs, const FunctionSymbol &rhs) {
+                    return lhs.rva < rhs.rva;
+                });
             for (auto &functionItem : functionSymbols)
             {
-                for (auto &publicItem : publicSymbols)
+                auto publicItem = std::upper_bound(
+                    publicSymbols.begin(),
+                    publicSymbols.end(),
+                    functionItem.rva,
+                    [](uint32_t rva, const FunctionSymbol &publicSymbol) { return rva < publicSymbol.rva; });
+                if (publicItem != publicSymbols.begin() && (publicItem - 1)->rva == functionItem.rva)
                 {
-                    if (functionItem.rva == publicItem.rva)
-                    {
-                        functionItem.name = publicItem.name;
-                    }
+                    functionItem.name = (publicItem - 1)->name;
                 }
             }
 
@@ -379,25 +539,33 @@ public:
 
     virtual bool ParseFunctionSymbols(StringRef SymFilePath) override
     {
-        mFunctionSymbols.clear();
+        ClearSymbols();
+        ClosePdbFile();
+        mModuleNameAllocators.clear();
 
         // try to open the PDB file and check whether all the data we need is available
-        MemoryMappedFile::Handle pdbFile = MemoryMappedFile::Open(SymFilePath.data());
-        if (!pdbFile.baseAddress)
+        mPdbFile = MemoryMappedFile::Open(SymFilePath.data());
+        if (!mPdbFile.baseAddress)
         {
             return false;
         }
 
-        if (IsError(PDB::ValidateFile(pdbFile.baseAddress)))
+        if (IsError(PDB::ValidateFile(mPdbFile.baseAddress)))
         {
-            MemoryMappedFile::Close(pdbFile);
+            ClosePdbFile();
             return false;
         }
 
-        const PDB::RawFile rawPdbFile = PDB::CreateRawFile(pdbFile.baseAddress);
+        // the names of the records that are read in place point into the mapped blocks
+        const auto superBlock = static_cast<const PDB::SuperBlock *>(mPdbFile.baseAddress);
+        mPdbFileData = StringRef(
+            static_cast<const char *>(mPdbFile.baseAddress),
+            static_cast<size_t>(superBlock->blockSize) * superBlock->blockCount);
+
+        const PDB::RawFile rawPdbFile = PDB::CreateRawFile(mPdbFile.baseAddress);
         if (IsError(PDB::HasValidDBIStream(rawPdbFile)))
         {
-            MemoryMappedFile::Close(pdbFile);
+            ClosePdbFile();
             return false;
         }
 
@@ -406,117 +574,351 @@ public:
         {
             printf("PDB was linked using unsupported option /DEBUG:FASTLINK\n");
 
-            MemoryMappedFile::Close(pdbFile);
+            ClosePdbFile();
             return false;
         }
 
+        // the GUID and the age identify the PDB, a cache of the same PDB saves parsing it again
         const auto h = infoStream.GetHeader();
+        std::string cacheKey = "pdb";
+        cacheKey.append(reinterpret_cast<const char *>(&h->guid), sizeof(h->guid));
+        cacheKey.append(reinterpret_cast<const char *>(&h->age), sizeof(h->age));
+        if (ReadFunctionSymbolCache(cacheKey))
+        {
+            ClosePdbFile();
+            return true;
+        }
+
         const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawPdbFile);
         if (!HasValidDBIStreams(rawPdbFile, dbiStream))
         {
-            MemoryMappedFile::Close(pdbFile);
+            ClosePdbFile();
             return false;
         }
 
         const PDB::TPIStream tpiStream = PDB::CreateTPIStream(rawPdbFile);
         if (PDB::HasValidTPIStream(rawPdbFile) != PDB::ErrorCode::Success)
         {
-            MemoryMappedFile::Close(pdbFile);
+            ClosePdbFile();
             return false;
         }
 
         ExampleFunctionSymbols(rawPdbFile, dbiStream);
 
-        MemoryMappedFile::Close(pdbFile);
+        WriteFunctionSymbolCache(cacheKey);
 
         return true;
     }
 };
 
+namespace {
+// The smallest chunk of a MAP file that is parsed on its own thread
+constexpr size_t MapMinChunkSize = 1 << 20;
+
+// A function symbol of a MAP file, the name points into the mapped file
+struct MapFunctionSymbol
+{
+    uint32_t Section;
+    uint32_t Offset;
+    uint64_t Address;
+    StringRef Name;
+};
+
+// A section contribution of a MAP file: 0001:00000174 00000a3cH .text$mn CODE
+struct MapSectionContribution
+{
+    uint32_t Section;
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+// Is it a separator of the tokens of a line?
+inline bool
+IsMapSpace(char C)
+{
+    return C == ' ' || C == '\t' || C == '\r';
+}
+
+// Get the next whitespace separated token of a line
+StringRef
+NextMapToken(StringRef &Line)
+{
+    const char *Ptr = Line.begin();
+    const char *End = Line.end();
+    while (Ptr != End && IsMapSpace(*Ptr))
+    {
+        ++Ptr;
+    }
+
+    const char *TokenBegin = Ptr;
+    while (Ptr != End && !IsMapSpace(*Ptr))
+    {
+        ++Ptr;
+    }
+
+    Line = StringRef(Ptr, End - Ptr);
+    return StringRef(TokenBegin, Ptr - TokenBegin);
+}
+
+// Parse a whole token as a number, StringRef::getAsInteger is too slow for every line of a large file
+template <typename T>
+bool
+ParseMapNumber(StringRef Token, unsigned Radix, T &Result)
+{
+    if (Token.empty() || Token.size() > sizeof(T) * 2)
+    {
+        return false;
+    }
+
+    uint64_t Value = 0;
+    for (char C : Token)
+    {
+        unsigned Digit;
+        if (C >= '0' && C <= '9')
+        {
+            Digit = C - '0';
+        }
+        else if (C >= 'a' && C <= 'f')
+        {
+            Digit = C - 'a' + 10;
+        }
+        else if (C >= 'A' && C <= 'F')
+        {
+            Digit = C - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (Digit >= Radix)
+        {
+            return false;
+        }
+        Value = Value * Radix + Digit;
+    }
+
+    if (Value > std::numeric_limits<T>::max())
+    {
+        return false;
+    }
+    Result = static_cast<T>(Value);
+    return true;
+}
+
+// Parse a section and an offset: 0001:000000b0
+bool
+ParseMapSectionOffset(StringRef Token, uint32_t &Section, uint32_t &Offset)
+{
+    auto Colon = Token.find(':');
+    return Colon != StringRef::npos && ParseMapNumber(Token.take_front(Colon), 10, Section) &&
+           ParseMapNumber(Token.drop_front(Colon + 1), 16, Offset);
+}
+
+// Parse a function symbol: 0001:000000b0       main       00000001400010b0 f   Source.obj
+bool
+ParseMapFunctionSymbol(StringRef Line, MapFunctionSymbol &Sym)
+{
+    if (!ParseMapSectionOffset(NextMapToken(Line), Sym.Section, Sym.Offset))
+    {
+        return false;
+    }
+
+    Sym.Name = NextMapToken(Line);
+    if (Sym.Name.empty() || !ParseMapNumber(NextMapToken(Line), 16, Sym.Address))
+    {
+        return false;
+    }
+
+    // The flags come before the object: f for functions, i for inlined ones
+    for (auto Token = NextMapToken(Line); !Token.empty(); Token = NextMapToken(Line))
+    {
+        if (Token == "f")
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Parse a section contribution: 0001:00000174 00000a3cH .text$mn CODE
+bool
+ParseMapSectionContribution(StringRef Line, MapSectionContribution &Contribution)
+{
+    if (!ParseMapSectionOffset(NextMapToken(Line), Contribution.Section, Contribution.Offset))
+    {
+        return false;
+    }
+
+    auto Length = NextMapToken(Line);
+    return Length.consume_back("H") && ParseMapNumber(Length, 16, Contribution.Length);
+}
+
+// Parse the function symbols of the lines of a chunk
+void
+ParseMapFunctionSymbols(StringRef Chunk, std::vector<MapFunctionSymbol> &Symbols)
+{
+    const char *Ptr = Chunk.begin();
+    const char *End = Chunk.end();
+    while (Ptr != End)
+    {
+        auto LineEnd = static_cast<const char *>(std::memchr(Ptr, '\n', End - Ptr));
+        LineEnd = LineEnd ? LineEnd : End;
+        StringRef Line(Ptr, LineEnd - Ptr);
+        Ptr = LineEnd == End ? End : LineEnd + 1;
+
+        MapFunctionSymbol Sym;
+        if (ParseMapFunctionSymbol(Line, Sym))
+        {
+            Symbols.push_back(Sym);
+        }
+    }
+}
+} // namespace
+
 class SymbolParserByMap : public SymbolParser
 {
 public:
     SymbolParserByMap() : SymbolParser() {}
     ~SymbolParserByMap() = default;
 
-public:
-    // Parser
-    virtual bool ParseCommonSymbols(StringRef SymFilePath) override
+private:
+    // Read the image base and the section contributions, returns the offset of the public symbols
+    size_t ParseMapHeader(StringRef Buffer, std::vector<MapSectionContribution> &Contributions)
     {
-        // Not implemented
-        return false;
+        const StringRef LoadAddressTitle = "Preferred load address is ";
+
+        size_t Offset = 0;
+        while (Offset < Buffer.size())
+        {
+            auto Line = Buffer.substr(Offset).take_until([](char C) { return C == '\n'; });
+            Offset += Line.size() + 1;
+
+            MapSectionContribution Contribution;
+            auto LoadAddressIdx = Line.find(LoadAddressTitle);
+            if (LoadAddressIdx != StringRef::npos)
+            {
+                if (mImageBase == 0)
+                {
+                    Line.substr(LoadAddressIdx + LoadAddressTitle.size()).trim().getAsInteger(16, mImageBase);
+                }
+            }
+            else if (ParseMapSectionContribution(Line, Contribution))
+            {
+                Contributions.push_back(Contribution);
+            }
+            else if (Line.find("Publics by Value") != StringRef::npos)
+            {
+                return std::min(Offset, Buffer.size());
+            }
+        }
+
+        return Buffer.size();
     }
 
-    virtual bool ParseFunctionSymbols(StringRef SymFilePath) override
+    // Split the symbols into line-aligned chunks and parse them in parallel
+    std::vector<MapFunctionSymbol> ParseMapSymbols(StringRef Symbols)
     {
-        mFunctionSymbols.clear();
-
-        std::vector<FunctionSymbol> FunctionSymbols;
+        size_t NumChunks = std::min<size_t>(hardware_concurrency(), Symbols.size() / MapMinChunkSize);
+        if (NumChunks <= 1)
+        {
+            std::vector<MapFunctionSymbol> Result;
+            ParseMapFunctionSymbols(Symbols, Result);
+            return Result;
+        }
 
-        auto ParseImageBase = [&](std::string &Line) {
-            auto Idx = Line.find("Preferred load address is ");
-            if (Idx != std::string::npos)
+        std::vector<StringRef> Chunks;
+        size_t Begin = 0;
+        for (size_t Index = 1; Index <= NumChunks && Begin < Symbols.size(); ++Index)
+        {
+            size_t End = Index == NumChunks ? Symbols.size() : Symbols.find('\n', Index * Symbols.size() / NumChunks);
+            End = std::min(End == StringRef::npos ? Symbols.size() : End + 1, Symbols.size());
+            if (End > Begin)
             {
-                auto StartIdx = Idx + strlen("Preferred load address is ");
-                auto ImageBaseStr = Line.substr(StartIdx);
-                mImageBase = std::strtoull(ImageBaseStr.c_str(), nullptr, 16);
+                Chunks.push_back(Symbols.slice(Begin, End));
+                Begin = End;
             }
-        };
+        }
 
-        auto ParseSymbol = [&](std::string &Line) {
-            // https://github.com/mike1k/perses/blob/master/src/mapfileparser.cpp#LL25
-            std::regex Reg(
-                R"#(\s(\d+):([a-fA-F0-9]+)\s+(\S+)\s+([a-fA-F0-9]+)\s+(.+))#", std::regex_constants::ECMAScript);
-            if (std::regex_match(Line, Reg))
+        std::vector<std::vector<MapFunctionSymbol>> ChunkSymbols(Chunks.size());
+        {
+            ThreadPool Pool(static_cast<unsigned>(Chunks.size()));
+            for (size_t Index = 0; Index < Chunks.size(); ++Index)
             {
-                std::smatch Match;
-                for (; std::regex_search(Line, Match, Reg); Line = Match.suffix())
-                {
-                    if (Line.find(" f ") != std::string::npos)
-                    {
-                        FunctionSymbol Sym{};
-
-                        Sym.rva = std::strtoull(Match[4].str().c_str(), nullptr, 16) - mImageBase;
-
-                        if (Sym.rva == 0)
-                        {
-                            continue;
-                        }
+                Pool.async([&Chunks, &ChunkSymbols, Index]() {
+                    ParseMapFunctionSymbols(Chunks[Index], ChunkSymbols[Index]);
+                });
+            }
+            Pool.wait();
+        }
 
-                        if (Sym.rva < 0x1000)
-                        {
-                            continue;
-                        }
+        // Keep the order of the file
+        std::vector<MapFunctionSymbol> Result;
+        for (auto &Chunk : ChunkSymbols)
+        {
+            Result.insert(Result.end(), Chunk.begin(), Chunk.end());
+        }
+        return Result;
+    }
 
-                        Sym.name = Match[3].str();
-                        Sym.size = 0;
+public:
+    // Parser
+    virtual bool ParseCommonSymbols(StringRef SymFilePath) override
+    {
+        // Not implemented
+        return false;
+    }
 
-                        FunctionSymbols.push_back(Sym);
-                    }
-                }
-            }
-        };
+    virtual bool ParseFunctionSymbols(StringRef SymFilePath) override
+    {
+        ClearSymbols();
 
-        if ((access(SymFilePath.data(), 0) != 0))
+        auto BufferOrErr = MemoryBuffer::getFile(SymFilePath, -1, false);
+        if (!BufferOrErr)
         {
             // file does not exist
             return false;
         }
+        auto Buffer = (*BufferOrErr)->getBuffer();
 
-        std::ifstream IfStream(SymFilePath.data());
-        std::string Line = "";
+        // A MAP has no identity of its own, it is identified by its hash and the image base the RVAs are relative to
+        std::string CacheKey = "map";
+        if (!mCacheDirectory.empty())
+        {
+            auto Hash = MD5::hash(arrayRefFromStringRef(Buffer));
+            char ImageBase[sizeof(uint64_t)];
+            support::endian::write64le(ImageBase, mImageBase);
+            CacheKey.append(reinterpret_cast<const char *>(Hash.data()), Hash.size());
+            CacheKey.append(ImageBase, sizeof(ImageBase));
+            if (ReadFunctionSymbolCache(CacheKey))
+            {
+                return true;
+            }
+        }
 
-        while (std::getline(IfStream, Line))
+        std::vector<MapSectionContribution> Contributions;
+        auto SymbolsOffset = ParseMapHeader(Buffer, Contributions);
+        if (mImageBase == 0)
         {
-            // read line
+            return false;
+        }
 
-            if (mImageBase == 0)
+        std::vector<FunctionSymbol> FunctionSymbols;
+        std::vector<const MapFunctionSymbol *> SymbolOfFunction;
+        auto MapSymbols = ParseMapSymbols(Buffer.substr(SymbolsOffset));
+        for (auto &MapSym : MapSymbols)
+        {
+            if (MapSym.Address < mImageBase + 0x1000 || MapSym.Address - mImageBase > UINT32_MAX)
             {
-                ParseImageBase(Line);
                 continue;
             }
 
-            ParseSymbol(Line);
+            FunctionSymbol Sym{};
+            Sym.rva = static_cast<uint32_t>(MapSym.Address - mImageBase);
+            Sym.name = MapSym.Name;
+            FunctionSymbols.push_back(std::move(Sym));
+            SymbolOfFunction.push_back(&MapSym);
         }
 
         if (FunctionSymbols.empty())
@@ -524,7 +926,60 @@ public:
             return false;
         }
 
+        // The size of a function is the distance to the next RVA, folded functions share their RVA.
+        // It is bounded by the section contribution of the function, which also gives the size of the last one.
+        std::vector<size_t> Order(FunctionSymbols.size());
+        std::iota(Order.begin(), Order.end(), 0);
+        std::stable_sort(Order.begin(), Order.end(), [&FunctionSymbols](size_t Lhs, size_t Rhs) {
+            return FunctionSymbols[Lhs].rva < FunctionSymbols[Rhs].rva;
+        });
+
+        std::sort(
+            Contributions.begin(),
+            Contributions.end(),
+            [](const MapSectionContribution &Lhs, const MapSectionContribution &Rhs) {
+                return std::tie(Lhs.Section, Lhs.Offset) < std::tie(Rhs.Section, Rhs.Offset);
+            });
+
+        size_t NextIndex = 0;
+        for (size_t Index = 0; Index < Order.size(); ++Index)
+        {
+            auto &Sym = FunctionSymbols[Order[Index]];
+            NextIndex = std::max(NextIndex, Index + 1);
+            while (NextIndex < Order.size() && FunctionSymbols[Order[NextIndex]].rva == Sym.rva)
+            {
+                ++NextIndex;
+            }
+
+            uint64_t Size = NextIndex < Order.size() ? FunctionSymbols[Order[NextIndex]].rva - Sym.rva : 0;
+
+            const MapFunctionSymbol &MapSym = *SymbolOfFunction[Order[Index]];
+            auto It = std::upper_bound(
+                Contributions.begin(),
+                Contributions.end(),
+                std::make_pair(MapSym.Section, MapSym.Offset),
+                [](const std::pair<uint32_t, uint32_t> &Lhs, const MapSectionContribution &Rhs) {
+                    return Lhs < std::make_pair(Rhs.Section, Rhs.Offset);
+                });
+            if (It != Contributions.begin())
+            {
+                --It;
+                uint64_t ContributionEnd = static_cast<uint64_t>(It->Offset) + It->Length;
+                if (It->Section == MapSym.Section && MapSym.Offset < ContributionEnd)
+                {
+                    auto ContributionSize = ContributionEnd - MapSym.Offset;
+                    Size = Size == 0 ? ContributionSize : std::min(Size, ContributionSize);
+                }
+            }
+
+            Sym.size = static_cast<uint32_t>(std::min<uint64_t>(Size, UINT32_MAX));
+        }
+
+        // The names point into the mapped file
         std::swap(mFunctionSymbols, FunctionSymbols);
+        mSymbolFileBuffer = std::move(*BufferOrErr);
+
+        WriteFunctionSymbolCache(CacheKey);
 
         return true;
     }
@@ -1,8 +1,14 @@
 
 #include <UnknownFrontend/UnknownFrontend.h>
+#include <UnknownUtils/unknown/ADT/SmallString.h>
+#include <UnknownUtils/unknown/Support/FileSystem.h>
+#include <UnknownUtils/unknown/Support/JSON.h>
+#include <UnknownUtils/unknown/Support/Path.h>
 #include <gtest/gtest.h>
+#include <chrono>
 #include <format>
 #include <iostream>
+#include <set>
 
 TEST(test_lift, test_lift_1)
 {
@@ -47,3 +53,449 @@ TEST(test_lift, test_lift_2)
     assert(Module);
     Module->print(unknown::outs());
 }
+
+TEST(test_lift, test_lift_3)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->initTranslator();
+
+    auto Module = Translator->translateBinary("Project12-3");
+    assert(Module);
+    EXPECT_NE(Translator->getNumDecodedInstructions(), 0);
+
+    // Lift ?add@@YAHHH@Z again and translate its entry block a second time, the block decodes the same addresses
+    auto Add = Module->getFunction("?add@@YAHHH@Z");
+    ASSERT_TRUE(Add.has_value());
+    auto Begin = (*Add)->getFunctionBeginAddress();
+    auto End = (*Add)->getFunctionEndAddress();
+
+    auto F = std::make_unique<uir::Function>(CTX, "?add@@YAHHH@Z", nullptr, Begin, End);
+    ASSERT_TRUE(Translator->translateOneFunction(F->getFunctionName(), Begin, End - Begin, F.get()));
+    auto NumDecoded = Translator->getNumDecodedInstructions();
+    auto NumHits = Translator->getNumDecodeCacheHits();
+
+    std::unique_ptr<uir::BasicBlock> EntryBB(Translator->translateOneBasicBlock("", Begin, End));
+    ASSERT_TRUE(EntryBB);
+    EXPECT_EQ(Translator->getNumDecodedInstructions(), NumDecoded);
+    EXPECT_GT(Translator->getNumDecodeCacheHits(), NumHits);
+
+    std::cout << std::format(
+        "decoded: {} cache hits: {}\n", Translator->getNumDecodedInstructions(), Translator->getNumDecodeCacheHits());
+}
+
+TEST(test_lift, test_lift_4)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->initTranslator();
+
+    auto SerialModule = Translator->translateBinary("Project12-4");
+    assert(SerialModule);
+    auto ParallelModule = Translator->translateBinary("Project12-4", 4);
+    assert(ParallelModule);
+
+    std::string SerialStr;
+    unknown::raw_string_ostream SerialOS(SerialStr);
+    SerialModule->print(SerialOS);
+
+    std::string ParallelStr;
+    unknown::raw_string_ostream ParallelOS(ParallelStr);
+    ParallelModule->print(ParallelOS);
+
+    EXPECT_EQ(SerialOS.str(), ParallelOS.str());
+}
+
+TEST(test_lift, test_lift_5)
+{
+    std::cout << "---------------lift----------------\n";
+
+    unknown::SmallString<128> CacheDirectory;
+    unknown::sys::path::system_temp_directory(true, CacheDirectory);
+    unknown::sys::path::append(CacheDirectory, "UnknownRebuilder-lift-cache");
+    unknown::sys::fs::remove_directories(CacheDirectory);
+
+    auto translateWithCache = [&CacheDirectory](uint64_t &NumHits) {
+        uir::Context CTX;
+        CTX.setArch(uir::Context::Arch::ArchX86);
+        CTX.setMode(uir::Context::Mode::Mode64);
+
+        auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+            CTX,
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+            true);
+        assert(Translator);
+        Translator->initTranslator();
+        EXPECT_TRUE(Translator->enableLiftCache(CacheDirectory.str().str(), "prune_after=1h"));
+
+        auto Module = Translator->translateBinary("Project12-5");
+        assert(Module);
+        NumHits = Translator->getNumLiftCacheHits();
+
+        std::string Str;
+        unknown::raw_string_ostream OS(Str);
+        Module->print(OS);
+        return OS.str();
+    };
+
+    // The first run fills the cache, the second run is served from it
+    uint64_t ColdHits = 0;
+    auto ColdStr = translateWithCache(ColdHits);
+    uint64_t WarmHits = 0;
+    auto WarmStr = translateWithCache(WarmHits);
+
+    EXPECT_EQ(ColdHits, 0);
+    EXPECT_NE(WarmHits, 0);
+    EXPECT_EQ(ColdStr, WarmStr);
+
+    unknown::sys::fs::remove_directories(CacheDirectory);
+}
+
+TEST(test_lift, test_lift_6)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->initTranslator();
+
+    auto Module = Translator->translateBinary("Project12-6");
+    assert(Module);
+
+    std::string ModuleStr;
+    unknown::raw_string_ostream ModuleOS(ModuleStr);
+    for (auto F : *Module)
+    {
+        F->print(ModuleOS);
+    }
+
+    // Print each function as it arrives and drop it
+    for (uint32_t NumThreads : {1, 4})
+    {
+        std::string StreamStr;
+        unknown::raw_string_ostream StreamOS(StreamStr);
+        auto StreamModule = Translator->translateBinary(
+            "Project12-6",
+            [&StreamOS](uir::Function &F) {
+                F.print(StreamOS);
+                return false;
+            },
+            NumThreads);
+        assert(StreamModule);
+
+        EXPECT_TRUE(StreamModule->empty());
+        EXPECT_EQ(ModuleOS.str(), StreamOS.str());
+    }
+}
+
+TEST(test_lift, test_lift_7)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg3.xml)",
+        false);
+    assert(Translator);
+    Translator->initTranslator();
+
+    auto Module = Translator->translateBinary("Project12-7");
+    assert(Module);
+
+    // The exact name wins over the pattern
+    auto Empty1 = Module->getFunction("?empty1@@YAXXZ");
+    auto Empty2 = Module->getFunction("?empty2@@YAXXZ");
+    ASSERT_TRUE(Empty1.has_value());
+    ASSERT_TRUE(Empty2.has_value());
+    EXPECT_EQ((*Empty1)->getFunctionAttributes(), std::vector<std::string>{"v2"});
+    EXPECT_EQ((*Empty2)->getFunctionAttributes(), std::vector<std::string>{"v1"});
+}
+
+TEST(test_lift, test_lift_8)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->initTranslator();
+
+    // Translate in the given decode mode and report the throughput
+    auto translateWithDecodeMode = [&Translator](bool LazyDetail) {
+        Translator->setEnableLazyDecodeDetail(LazyDetail);
+        auto NumDecoded = Translator->getNumDecodedInstructions();
+        auto NumDetailDecoded = Translator->getNumDetailDecodedInstructions();
+
+        auto Begin = std::chrono::steady_clock::now();
+        auto Module = Translator->translateBinary("Project12-8");
+        assert(Module);
+        std::chrono::duration<double> Seconds = std::chrono::steady_clock::now() - Begin;
+
+        NumDecoded = Translator->getNumDecodedInstructions() - NumDecoded;
+        NumDetailDecoded = Translator->getNumDetailDecodedInstructions() - NumDetailDecoded;
+        std::cout << std::format(
+            "{}: decoded: {} with detail: {} insns/sec: {:.0f}\n",
+            LazyDetail ? "lazy detail" : "full detail",
+            NumDecoded,
+            NumDetailDecoded,
+            Seconds.count() > 0 ? NumDecoded / Seconds.count() : 0.0);
+
+        if (LazyDetail)
+        {
+            EXPECT_LE(NumDetailDecoded, NumDecoded);
+        }
+        else
+        {
+            EXPECT_EQ(NumDetailDecoded, NumDecoded);
+        }
+
+        std::string Str;
+        unknown::raw_string_ostream OS(Str);
+        Module->print(OS);
+        return OS.str();
+    };
+
+    auto FullStr = translateWithDecodeMode(false);
+    auto LazyStr = translateWithDecodeMode(true);
+    EXPECT_EQ(FullStr, LazyStr);
+}
+
+TEST(test_lift, test_lift_9)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->setEnableStatistics(true);
+    Translator->initTranslator();
+
+    auto Module = Translator->translateBinary("Project12-9");
+    assert(Module);
+    EXPECT_NE(Translator->getNumTranslatedFunctions(), 0);
+    EXPECT_GE(Translator->getNumTranslatedBasicBlocks(), Translator->getNumTranslatedFunctions());
+
+    std::string Str;
+    unknown::raw_string_ostream OS(Str);
+    Translator->printModule(*Module, OS);
+    EXPECT_FALSE(OS.str().empty());
+
+    // The parallel printer writes the same text
+    std::string ParallelStr;
+    unknown::raw_string_ostream ParallelOS(ParallelStr);
+    Translator->printModule(*Module, ParallelOS, 4);
+    EXPECT_EQ(ParallelOS.str(), OS.str());
+
+    Translator->printStatistics(unknown::outs());
+
+    // The JSON report is well-formed and holds every phase
+    std::string JSONStr;
+    unknown::raw_string_ostream JSONOS(JSONStr);
+    Translator->printStatisticsJSON(JSONOS);
+    std::cout << JSONOS.str();
+
+    auto JSON = unknown::json::parse(JSONOS.str());
+    ASSERT_TRUE(!!JSON);
+    auto Root = JSON->getAsObject();
+    ASSERT_TRUE(Root);
+    auto Phases = Root->getObject("phases");
+    ASSERT_TRUE(Phases);
+    for (auto Phase : {"parse-config", "parse-symbol", "parse-binary", "translate", "print"})
+    {
+        EXPECT_TRUE(Phases->getObject(Phase));
+    }
+    auto Counters = Root->getObject("counters");
+    ASSERT_TRUE(Counters);
+    EXPECT_EQ(Counters->getInteger("functions"), static_cast<int64_t>(Translator->getNumTranslatedFunctions()));
+}
+
+TEST(test_lift, test_lift_10)
+{
+    std::cout << "---------------lift----------------\n";
+
+    uir::Context CTX;
+    CTX.setArch(uir::Context::Arch::ArchX86);
+    CTX.setMode(uir::Context::Mode::Mode64);
+
+    auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+        CTX,
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+        UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+        true);
+    assert(Translator);
+    Translator->initTranslator();
+
+    auto Module = Translator->translateBinary("Project12-10");
+    assert(Module);
+
+    // int add(int, int):
+    //   +0x00 .. +0x1E jle +0x31
+    //   +0x20 .. +0x2F jmp +0x3D
+    //   +0x31 .. +0x39
+    //   +0x3D .. +0x45 ret
+    // The taken side of the jle is translated first, the jmp lands inside it and splits it at +0x3D
+    auto Add = Module->getFunction("?add@@YAHHH@Z");
+    ASSERT_TRUE(Add.has_value());
+    auto F = *Add;
+    ASSERT_EQ(F->size(), 4);
+
+    std::vector<uir::BasicBlock *> Blocks(F->begin(), F->end());
+    auto Begin = F->getFunctionBeginAddress();
+    EXPECT_EQ(Blocks[0]->getBasicBlockAddressBegin(), Begin);
+    EXPECT_EQ(Blocks[1]->getBasicBlockAddressBegin(), Begin + 0x20);
+    EXPECT_EQ(Blocks[2]->getBasicBlockAddressBegin(), Begin + 0x31);
+    EXPECT_EQ(Blocks[2]->getBasicBlockAddressEnd(), Begin + 0x3D);
+    EXPECT_EQ(Blocks[3]->getBasicBlockAddressBegin(), Begin + 0x3D);
+
+    // The jle keeps both edges
+    auto Jcc = unknown::dyn_cast_or_null<uir::JccBBInstruction>(Blocks[0]->getTerminator());
+    ASSERT_TRUE(Jcc);
+    EXPECT_EQ(Jcc->getDestinationBlock(), Blocks[2]);
+    EXPECT_EQ(Jcc->getNormalBlock(), Blocks[1]);
+
+    // The jle tests ZF, SF and OF
+    auto JleFlags = Jcc->getFlagsVariable();
+    ASSERT_TRUE(JleFlags);
+    EXPECT_EQ(JleFlags->getCondition(), uir::FlagsVariable::ConditionKind::LessOrEqual);
+    EXPECT_TRUE(JleFlags->getFlags().ZeroFlag);
+    EXPECT_TRUE(JleFlags->getFlags().SignFlag);
+    EXPECT_TRUE(JleFlags->getFlags().OverflowFlag);
+    EXPECT_FALSE(JleFlags->getFlags().CarryFlag);
+
+    // The different kinds of Jcc of the module keep their conditions apart
+    std::set<uint64_t> JccFlagsValues;
+    for (auto Func : *Module)
+    {
+        for (auto BB : *Func)
+        {
+            if (auto Terminator = BB->getTerminator(); Terminator && Terminator->getFlagsVariable())
+            {
+                JccFlagsValues.insert(Terminator->getFlagsVariable()->getFlagsValue());
+            }
+        }
+    }
+    EXPECT_GE(JccFlagsValues.size(), 2);
+
+    // The jmp reaches the tail of the split block, and the head falls through into it
+    auto Jmp = unknown::dyn_cast_or_null<uir::JmpBBInstruction>(Blocks[1]->getTerminator());
+    ASSERT_TRUE(Jmp);
+    EXPECT_EQ(Jmp->getDestinationBlock(), Blocks[3]);
+    auto FallThrough = unknown::dyn_cast_or_null<uir::JmpBBInstruction>(Blocks[2]->getTerminator());
+    ASSERT_TRUE(FallThrough);
+    EXPECT_EQ(FallThrough->getDestinationBlock(), Blocks[3]);
+
+    EXPECT_TRUE(Blocks[0]->predecessor_empty());
+    ASSERT_EQ(Blocks[1]->predecessor_count(), 1);
+    EXPECT_EQ(Blocks[1]->predecessor_front(), Blocks[0]);
+    ASSERT_EQ(Blocks[2]->predecessor_count(), 1);
+    EXPECT_EQ(Blocks[2]->predecessor_front(), Blocks[0]);
+    ASSERT_EQ(Blocks[3]->predecessor_count(), 2);
+    EXPECT_EQ(Blocks[3]->predecessor_front(), Blocks[1]);
+    EXPECT_EQ(Blocks[3]->predecessor_back(), Blocks[2]);
+}
+
+TEST(test_lift, test_lift_11)
+{
+    std::cout << "---------------lift----------------\n";
+
+    // The symbol cache shares its directory with the lift cache
+    unknown::SmallString<128> CacheDirectory;
+    unknown::sys::path::system_temp_directory(true, CacheDirectory);
+    unknown::sys::path::append(CacheDirectory, "UnknownRebuilder-symbol-cache");
+    unknown::sys::fs::remove_directories(CacheDirectory);
+
+    auto translateWithCache = [&CacheDirectory]() {
+        uir::Context CTX;
+        CTX.setArch(uir::Context::Arch::ArchX86);
+        CTX.setMode(uir::Context::Mode::Mode64);
+
+        auto Translator = ufrontend::UnknownFrontendTranslator::createTranslator(
+            CTX,
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.exe)",
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)",
+            UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.cfg.xml)",
+            true);
+        assert(Translator);
+        EXPECT_TRUE(Translator->enableSymbolCache(CacheDirectory.str().str()));
+        Translator->initTranslator();
+        EXPECT_TRUE(Translator->enableLiftCache(CacheDirectory.str().str()));
+
+        auto Module = Translator->translateBinary("Project12-11");
+        assert(Module);
+
+        std::string Str;
+        unknown::raw_string_ostream OS(Str);
+        Module->print(OS);
+        return OS.str();
+    };
+
+    // The first run writes the symbol cache, the second run reads the symbols from it
+    auto ColdStr = translateWithCache();
+    bool HasSymbolCache = false;
+    std::error_code EC;
+    for (unknown::sys::fs::directory_iterator It(CacheDirectory, EC), End; It != End && !EC; It.increment(EC))
+    {
+        HasSymbolCache |= unknown::sys::path::extension(It->path()) == ".symcache";
+    }
+    EXPECT_TRUE(HasSymbolCache);
+    auto WarmStr = translateWithCache();
+    EXPECT_EQ(ColdStr, WarmStr);
+
+    unknown::sys::fs::remove_directories(CacheDirectory);
+}
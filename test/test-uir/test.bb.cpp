@@ -29,4 +29,47 @@ TEST(test_uir, test_uir_bb_1)
     }
 
     std::cout << "--------------------bp-----------------------" << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(test_uir, test_uir_bb_2)
+{
+    {
+        Context CTX;
+        CTX.setArch(Context::Arch::ArchX86);
+        CTX.setMode(Context::Mode::Mode64);
+
+        BasicBlock BB1(CTX, "bb1", 0x401000, 0x401010);
+
+        IRBuilder IBR(&BB1);
+        auto ret1 = IBR.createRetVoid(0x401000);
+        auto ret2 = IBR.createRetVoid(0x401001);
+        auto ret3 = IBR.createRetVoid(0x401002);
+        EXPECT_TRUE(BB1.isInstrOrderValid());
+        EXPECT_TRUE(ret1->comesBefore(ret3));
+        EXPECT_FALSE(ret3->comesBefore(ret2));
+
+        // Inserting in the middle invalidates the order until it is queried again
+        IBR.setInsertPoint(ret2);
+        auto ret4 = IBR.createRetVoid(0x401003);
+        EXPECT_FALSE(BB1.isInstrOrderValid());
+        EXPECT_TRUE(ret4->comesBefore(ret2));
+        EXPECT_TRUE(ret1->comesBefore(ret4));
+        EXPECT_TRUE(BB1.isInstrOrderValid());
+
+        ret3->removeFromParent();
+        ret3->insertBefore(ret1);
+        EXPECT_EQ(&BB1.front(), ret3);
+        EXPECT_TRUE(ret3->comesBefore(ret1));
+        EXPECT_EQ(BB1.size(), 4);
+
+        ret4->removeFromParent();
+        EXPECT_EQ(ret4->getParent(), nullptr);
+        EXPECT_EQ(BB1.size(), 3);
+        delete ret4;
+
+        std::vector<Instruction *> Order(BB1.begin(), BB1.end());
+        EXPECT_EQ(Order, (std::vector<Instruction *>{ret3, ret1, ret2}));
+    }
+
+    std::cout << "--------------------bp-----------------------" << std::endl;
+}
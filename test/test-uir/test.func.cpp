@@ -58,4 +58,123 @@ TEST(test_uir, test_uir_func_1)
     }
 
     std::cout << "--------------------bp-----------------------" << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(test_uir, test_uir_func_2)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    Function F(CTX, "func2");
+
+    F.setFunctionBeginAddress(0x401000);
+    F.setFunctionEndAddress(0x401010);
+
+    BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", 0x401000, 0x401002);
+    BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", 0x401002, 0x401008);
+    BasicBlock *BB3 = BasicBlock::get(CTX, "bb3", 0x401008, 0x401010);
+
+    IRBuilder IRB1(BB1);
+    auto JccBBInst = IRB1.createJccBB(BB3, BB2, FlagsVariable::get(CTX), 0x401000);
+    BB2->predecessor_push(BB1);
+    BB3->predecessor_push(BB1);
+
+    IRBuilder IRB2(BB2);
+    IRB2.createJmpBB(BB3, 0x401002);
+    BB3->predecessor_push(BB2);
+
+    IRBuilder IRB3(BB3);
+    IRB3.createRetVoid(0x401008);
+
+    F.insertBasicBlock(BB1);
+    F.insertBasicBlock(BB2);
+    F.insertBasicBlock(BB3);
+
+    EXPECT_EQ(JccBBInst->getParent(), BB1);
+    EXPECT_EQ(JccBBInst->getInstructionAddress(), 0x401000);
+    EXPECT_EQ(BB3->predecessor_count(), 2);
+
+    unknown::outs() << F;
+}
+
+TEST(test_uir, test_uir_func_3)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    Function F(CTX, "func3", nullptr, 0x401000, 0x401010);
+    F.insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", &F, 0));
+
+    BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", 0x401000, 0x401008);
+    BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", 0x401008, 0x40100C);
+    BasicBlock *BB3 = BasicBlock::get(CTX, "bb3", 0x40100C, 0x401010);
+    BB1->addExtraInfo("entry");
+
+    IRBuilder IRB1(BB1);
+    auto GV = GlobalVariable::get(Type::getInt32PtrTy(CTX), "gv1", 0x601000);
+    IRB1.createStore(F.getArgumentList().front(), GV, 0x401000)->setComment("spill");
+    IRB1.createJccBB(BB3, BB2, FlagsVariable::get(CTX), 0x401004);
+    BB2->predecessor_push(BB1);
+    BB3->predecessor_push(BB1);
+
+    IRBuilder IRB2(BB2);
+    IRB2.createJmpAddr(ConstantInt::get(CTX, unknown::APInt(64, 0x402000)), 0x401008);
+
+    IRBuilder IRB3(BB3);
+    IRB3.createRetImm(ConstantInt::get(CTX, unknown::APInt(128, 5)), 0x40100C);
+
+    F.insertBasicBlock(BB1);
+    F.insertBasicBlock(BB2);
+    F.insertBasicBlock(BB3);
+
+    std::string Expected;
+    unknown::raw_string_ostream ExpectedOS(Expected);
+    F.print(ExpectedOS);
+    ExpectedOS.flush();
+
+    // The default options keep everything the text has
+    std::string Binary;
+    unknown::raw_string_ostream BinaryOS(Binary);
+    EXPECT_TRUE(F.writeBinaryBody(BinaryOS));
+    BinaryOS.flush();
+
+    Function Read(CTX, "func3", nullptr, 0x401000, 0x401010);
+    Read.insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", &Read, 0));
+    EXPECT_TRUE(Read.readBinaryBody(Binary));
+    EXPECT_FALSE(Read.readBinaryBody(Binary));
+    std::string Printed;
+    unknown::raw_string_ostream PrintedOS(Printed);
+    Read.print(PrintedOS);
+    PrintedOS.flush();
+    EXPECT_EQ(Printed, Expected);
+
+    // The global variable is not in a module, so the function that read it owns it
+    ASSERT_EQ(Read.getOwnedGlobalVariableList().size(), 1);
+    EXPECT_NE(Read.getOwnedGlobalVariableList().front(), GV);
+    EXPECT_EQ(Read.front().front().getOperand(1), Read.getOwnedGlobalVariableList().front());
+    EXPECT_TRUE(F.getOwnedGlobalVariableList().empty());
+
+    // Absolute addresses, the annotations of the blocks are left out
+    BinaryBodyOptions Options = {false, false};
+    std::string Absolute;
+    unknown::raw_string_ostream AbsoluteOS(Absolute);
+    EXPECT_TRUE(F.writeBinaryBody(AbsoluteOS, Options));
+    AbsoluteOS.flush();
+
+    Function ReadAbsolute(CTX, "func3", nullptr, 0x401000, 0x401010);
+    ReadAbsolute.insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", &ReadAbsolute, 0));
+    EXPECT_TRUE(ReadAbsolute.readBinaryBody(Absolute, Options));
+    ASSERT_EQ(ReadAbsolute.size(), 3);
+    EXPECT_TRUE(ReadAbsolute.front().getExtraInfoList().empty());
+    EXPECT_EQ(ReadAbsolute.back().getBasicBlockAddressBegin(), 0x40100C);
+    EXPECT_EQ(ReadAbsolute.back().front().getInstructionAddress(), 0x40100C);
+    EXPECT_EQ(ReadAbsolute.front().front().getComment(), "spill");
+
+    // A truncated body leaves the function untouched
+    Function Truncated(CTX, "func3", nullptr, 0x401000, 0x401010);
+    Truncated.insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", &Truncated, 0));
+    EXPECT_FALSE(Truncated.readBinaryBody(unknown::StringRef(Binary).drop_back(1)));
+    EXPECT_TRUE(Truncated.empty());
+}
@@ -38,7 +38,7 @@ TEST(test_uir, test_uir_inst_RetIMM_1)
     for (auto OpIt = ReturnImmInst->op_begin(); OpIt != ReturnImmInst->op_end(); ++OpIt)
     {
         auto Op = *OpIt;
-        std::cout << std::format("Op = {}", Op->getName()) << std::endl;
+        std::cout << std::format("Op = {}", Op->getName().str()) << std::endl;
     }
 }
 
@@ -64,7 +64,7 @@ TEST(test_uir, test_uir_inst_Store_1)
     for (auto OpIt = StoreInst->op_begin(); OpIt != StoreInst->op_end(); ++OpIt)
     {
         auto Op = *OpIt;
-        std::cout << std::format("Op = {}", Op->getName()) << std::endl;
+        std::cout << std::format("Op = {}", Op->getName().str()) << std::endl;
     }
 }
 
@@ -186,7 +186,7 @@ TEST(test_uir, test_uir_inst_GBP_1)
     for (auto OpIt = GBPInst->op_begin(); OpIt != GBPInst->op_end(); ++OpIt)
     {
         auto Op = *OpIt;
-        std::cout << std::format("Op = {}", Op->getName()) << std::endl;
+        std::cout << std::format("Op = {}", Op->getName().str()) << std::endl;
     }
 }
 
@@ -211,6 +211,64 @@ TEST(test_uir, test_uir_inst_Load_1)
     for (auto OpIt = LoadInst->op_begin(); OpIt != LoadInst->op_end(); ++OpIt)
     {
         auto Op = *OpIt;
-        std::cout << std::format("Op = {}", Op->getName()) << std::endl;
+        std::cout << std::format("Op = {}", Op->getName().str()) << std::endl;
     }
 }
+
+TEST(test_uir, test_uir_inst_Casting_1)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    auto Ptr = LocalVariable::get(Type::getInt32PtrTy(CTX), "ptr1", 0x601000);
+    auto Addr = ConstantInt::get(CTX, unknown::APInt(64, 0x406000));
+    auto FlagsVar = FlagsVariable::get(CTX);
+
+    Value *LoadInst = LoadInstruction::get(Ptr);
+    Value *JmpAddrInst = JmpAddrInstruction::get(CTX, Addr);
+
+    // Values
+    EXPECT_TRUE(unknown::isa<Constant>(Addr));
+    EXPECT_TRUE(unknown::isa<ConstantInt>(Addr));
+    EXPECT_FALSE(unknown::isa<LocalVariable>(Addr));
+    EXPECT_TRUE(unknown::isa<LocalVariable>(Ptr));
+    EXPECT_FALSE(unknown::isa<FlagsVariable>(Ptr));
+    EXPECT_TRUE(unknown::isa<LocalVariable>(FlagsVar));
+    EXPECT_TRUE(unknown::isa<FlagsVariable>(FlagsVar));
+    EXPECT_FALSE(unknown::isa<Instruction>(FlagsVar));
+
+    // Instructions
+    EXPECT_TRUE(unknown::isa<LocalVariable>(LoadInst));
+    EXPECT_TRUE(unknown::isa<Instruction>(LoadInst));
+    EXPECT_TRUE(unknown::isa<LoadInstruction>(LoadInst));
+    EXPECT_FALSE(unknown::isa<StoreInstruction>(LoadInst));
+    EXPECT_FALSE(unknown::isa<TerminatorInstruction>(LoadInst));
+    EXPECT_TRUE(unknown::isa<TerminatorInstruction>(JmpAddrInst));
+    EXPECT_TRUE(unknown::isa<JmpAddrInstruction>(JmpAddrInst));
+    EXPECT_FALSE(unknown::isa<JmpBBInstruction>(JmpAddrInst));
+    EXPECT_EQ(unknown::dyn_cast<LoadInstruction>(LoadInst), LoadInst);
+    EXPECT_EQ(unknown::dyn_cast<JmpAddrInstruction>(LoadInst), nullptr);
+    EXPECT_EQ(unknown::cast<JmpAddrInstruction>(JmpAddrInst)->getJmpDestConstantInt(), Addr);
+
+    // Types
+    EXPECT_TRUE(unknown::isa<PointerType>(Ptr->getType()));
+    EXPECT_FALSE(unknown::isa<IntegerType>(Ptr->getType()));
+    EXPECT_TRUE(unknown::isa<IntegerType>(Addr->getType()));
+
+    // OpCode properties are looked up from the opcode
+    auto I = unknown::cast<Instruction>(LoadInst);
+    EXPECT_EQ(I->getOpcodeName(), LoadComponent.mOpCodeName);
+    EXPECT_EQ(I->getDefaultNumberOfOperands(), LoadComponent.mNumberOfOperands);
+    EXPECT_TRUE(I->hasResult());
+    EXPECT_FALSE(I->hasFlags());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(OpCodeID::NumOpCodes); ++i)
+    {
+        EXPECT_EQ(getOpCodeComponent(static_cast<OpCodeID>(i)).mOpCodeID, static_cast<OpCodeID>(i));
+    }
+
+    delete LoadInst;
+    delete JmpAddrInst;
+    delete Ptr;
+    delete FlagsVar;
+}
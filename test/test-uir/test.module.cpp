@@ -1,7 +1,10 @@
 #include <UnknownIR.h>
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 using namespace uir;
 
@@ -51,4 +54,534 @@ TEST(test_uir, test_uir_module_1)
     }
 
     std::cout << "--------------------bp-----------------------" << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(test_uir, test_uir_module_2)
+{
+    {
+        Context CTX;
+        CTX.setArch(Context::Arch::ArchX86);
+        CTX.setMode(Context::Mode::Mode64);
+
+        {
+            Module module(CTX, "mod2");
+            auto GV = GlobalVariable::get(Type::getInt32PtrTy(CTX), "gv1", 0x601000);
+            module.insertGlobalVariable(GV);
+
+            // A local on the heap, used by the arena values of every function
+            auto HeapVal = LocalVariable::get(Type::getInt32Ty(CTX));
+
+            for (uint64_t Index = 0; Index < 64; ++Index)
+            {
+                uint64_t Address = 0x401000 + Index * 0x10;
+                Function *F = Function::get(CTX, std::format("func{}", Index), &module, Address, Address + 0x10);
+                Function::ArenaScope Scope(*F);
+                F->insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", F, 0));
+
+                BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", Address, Address + 0x8);
+                BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", Address + 0x8, Address + 0x10);
+
+                IRBuilder IBR(BB1);
+                auto Val = LocalVariable::get(Type::getInt32Ty(CTX));
+                IBR.createStore(Val, LocalVariable::get(Type::getInt32PtrTy(CTX)), Address);
+                IBR.createStore(HeapVal, GV, Address + 0x2);
+                IBR.createJmpBB(BB2, Address + 0x4);
+                IBR.setInsertPoint(BB2);
+                IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(32, Index)), Address + 0x8);
+
+                F->insertBasicBlock(BB1);
+                F->insertBasicBlock(BB2);
+                module.insertFunction(F);
+
+                // The functions and the globals never live in an arena
+                EXPECT_EQ(F->getArenaID(), 0u);
+                EXPECT_NE(BB1->getArenaID(), 0u);
+            }
+            EXPECT_EQ(HeapVal->getNumUses(), 64);
+            EXPECT_EQ(GV->getNumUses(), 64);
+            EXPECT_GT(module.getArenaBytesAllocated(), 0);
+
+            // Erasing a single arena value still runs its destructor
+            auto &BB = module.front().front();
+            {
+                Function::ArenaScope Scope(module.front());
+                auto Unknown = UnknownInstruction::get(CTX, "nop");
+                BB.push_front(Unknown);
+                EXPECT_EQ(BB.size(), 4);
+                Unknown->removeFromParent();
+                delete Unknown;
+                EXPECT_EQ(BB.size(), 3);
+            }
+
+            // The annotations of arena values are kept in the context like the others
+            BB.front().setComment("arena");
+            EXPECT_EQ(BB.front().getComment(), "arena");
+
+            // Another thread builds a function in the arena of that function
+            std::thread Worker([&]() {
+                Function *F = Function::get(CTX, "func_worker", &module, 0x402000, 0x402010);
+                Function::ArenaScope Scope(*F);
+                BasicBlock *BB = BasicBlock::get(CTX, "bb1", 0x402000, 0x402010);
+                IRBuilder IBR(BB);
+                IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(32, 0x12345)), 0x402000);
+                F->insertBasicBlock(BB);
+                module.insertFunction(F);
+            });
+            Worker.join();
+            EXPECT_EQ(module.size(), 65);
+
+            // Values created outside of a scope come from the heap
+            size_t BytesAllocated = module.getArenaBytesAllocated();
+            auto HeapRet = ReturnInstruction::get(CTX);
+            EXPECT_EQ(HeapRet->getArenaID(), 0u);
+            delete HeapRet;
+            EXPECT_EQ(module.getArenaBytesAllocated(), BytesAllocated);
+
+            // A function that is not kept releases its arena at once, the uses of the values outside of it are unlinked
+            {
+                Function *F = Function::get(CTX, "func_dropped", nullptr, 0x403000, 0x403010);
+                {
+                    Function::ArenaScope Scope(*F);
+                    BasicBlock *BB = BasicBlock::get(CTX, "bb1", 0x403000, 0x403010);
+                    IRBuilder IBR(BB);
+                    IBR.createStore(HeapVal, GV, 0x403000);
+                    IBR.createRetVoid(0x403004);
+                    BB->front().setComment("dropped");
+                    F->insertBasicBlock(BB);
+                }
+                EXPECT_GT(F->getArenaBytesAllocated(), 0);
+                EXPECT_EQ(GV->getNumUses(), 65);
+                delete F;
+                EXPECT_EQ(GV->getNumUses(), 64);
+                EXPECT_EQ(HeapVal->getNumUses(), 64);
+            }
+        }
+    }
+
+    std::cout << "--------------------bp-----------------------" << std::endl;
+}
+
+TEST(test_uir, test_uir_module_3)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    Module module(CTX, "mod3");
+    auto GV = GlobalVariable::get(Type::getInt32Ty(CTX), "gv1", 0x601000);
+    module.insertGlobalVariable(GV);
+
+    Function *F = Function::get(CTX, "func1", &module, 0x401000, 0x401010);
+    F->addFnAttr("attr1");
+    F->addFnAttr("attr2");
+    F->setComment("<entry> & \"main\"");
+    F->insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", F, 0));
+    F->insertFunctionContext(FunctionContext::get(Type::getInt32Ty(CTX), "eax", F, 1));
+
+    BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", 0x401000, 0x401008);
+    BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", 0x401008, 0x401010);
+    BB1->addExtraInfo("info1");
+    BB1->addExtraInfo("info2");
+
+    IRBuilder IBR(BB1);
+    auto Val = LocalVariable::get(Type::getInt32Ty(CTX));
+    auto Store = IBR.createStore(Val, LocalVariable::get(Type::getInt32PtrTy(CTX)), 0x401000);
+    Store->setComment("spill");
+    IBR.createJmpBB(BB2, 0x401004);
+    IBR.setInsertPoint(BB2);
+    auto Ret = IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(32, 0)), 0x401008);
+    Ret->enablePrintOp();
+
+    F->insertBasicBlock(BB1);
+    F->insertBasicBlock(BB2);
+    module.insertFunction(F);
+
+    // The streamed output is the same as the one of the in-memory document
+    unknown::XMLPrinter Printer;
+    module.print(Printer);
+    std::string Expected = Printer.CStr();
+
+    std::string Streamed;
+    unknown::raw_string_ostream OS(Streamed);
+    module.print(OS);
+    OS.flush();
+    EXPECT_EQ(Streamed, Expected);
+    EXPECT_NE(Streamed.find("range=\"0x401000-0x401010\""), std::string::npos);
+    EXPECT_NE(Streamed.find("&lt;entry&gt; &amp; &quot;main&quot;"), std::string::npos);
+
+    // The file is written through the same printer
+    auto FilePath = std::filesystem::temp_directory_path() / "test_uir_module_3.xml";
+    EXPECT_TRUE(module.printToFile(FilePath.string()));
+    std::ifstream File(FilePath, std::ios::binary);
+    std::string Written((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+    File.close();
+    EXPECT_EQ(Written, Expected);
+    std::filesystem::remove(FilePath);
+}
+
+TEST(test_uir, test_uir_module_4)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    // The functions are printed in module order whatever thread prints them
+    Module module(CTX, "mod4");
+    for (uint64_t Index = 0; Index < 100; ++Index)
+    {
+        uint64_t Address = 0x401000 + Index * 0x10;
+        Function *F = Function::get(CTX, std::format("func{}", Index), &module, Address, Address + 0x10);
+        F->insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", F, 0));
+
+        BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", Address, Address + 0x8);
+        BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", Address + 0x8, Address + 0x10);
+
+        IRBuilder IBR(BB1);
+        IBR.createJmpBB(BB2, Address);
+        IBR.setInsertPoint(BB2);
+        IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(32, Index)), Address + 0x8);
+
+        F->insertBasicBlock(BB1);
+        F->insertBasicBlock(BB2);
+        module.insertFunction(F);
+    }
+
+    std::string Serial;
+    unknown::raw_string_ostream SerialOS(Serial);
+    module.print(SerialOS);
+    SerialOS.flush();
+
+    for (uint32_t NumThreads : {0u, 1u, 2u, 8u})
+    {
+        std::string Parallel;
+        unknown::raw_string_ostream ParallelOS(Parallel);
+        module.printParallel(ParallelOS, NumThreads);
+        ParallelOS.flush();
+        EXPECT_EQ(Parallel, Serial);
+    }
+
+    // A module with global variables but a single function
+    Module module2(CTX, "mod5");
+    module2.insertGlobalVariable(GlobalVariable::get(Type::getInt32Ty(CTX), "gv1", 0x601000));
+    module2.insertFunction(Function::get(CTX, "func1", &module2, 0x401000, 0x401010));
+    module2.insertFunction(Function::get(CTX, "func2", &module2, 0x401010, 0x401020));
+
+    std::string Serial2;
+    unknown::raw_string_ostream SerialOS2(Serial2);
+    module2.print(SerialOS2);
+    SerialOS2.flush();
+
+    std::string Parallel2;
+    unknown::raw_string_ostream ParallelOS2(Parallel2);
+    module2.printParallel(ParallelOS2, 4);
+    ParallelOS2.flush();
+    EXPECT_EQ(Parallel2, Serial2);
+}
+
+TEST(test_uir, test_uir_module_5)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    Module module(CTX, "mod5");
+    auto GV = GlobalVariable::get(Type::getInt32PtrTy(CTX), "gv1", 0x601000);
+    GV->setComment("counter");
+    module.insertGlobalVariable(GV);
+    module.insertGlobalVariable(
+        GlobalArray<uint8_t>::get(CTX, Type::getInt8Ty(CTX), {0x90, 0xCC, 0xC3}, "arr1", 0x602000));
+    module.insertGlobalVariable(
+        GlobalArray<uint32_t>::get(CTX, Type::getInt32Ty(CTX), {1, 0xFFFFFFFF}, "arr2", 0x603000));
+
+    for (uint64_t Index = 0; Index < 16; ++Index)
+    {
+        uint64_t Address = 0x401000 + Index * 0x20;
+        Function *F = Function::get(CTX, std::format("func{}", Index), &module, Address, Address + 0x20);
+        F->addFnAttr("attr1");
+        F->setSEH(Index % 2 == 0);
+        F->insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", F, 0));
+        F->insertFunctionContext(FunctionContext::get(Type::getInt64Ty(CTX), "rax", F, 1));
+
+        BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", Address, Address + 0x10);
+        BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", Address + 0x10, Address + 0x18);
+        BasicBlock *BB3 = BasicBlock::get(CTX, "bb3", Address + 0x18, Address + 0x20);
+        BB1->addExtraInfo("entry");
+
+        IRBuilder IBR(BB1);
+        auto Load = IBR.createLoad(GV, Address);
+        Load->setName("val", static_cast<uint32_t>(Index));
+        auto Val = LocalVariable::get(Type::getInt32Ty(CTX), "val", Address - 0x4);
+        auto Slot = LocalVariable::get(Type::getInt32PtrTy(CTX), "slot", Address - 0x8);
+        auto Store = IBR.createStore(Val, Slot, Address + 0x4);
+        Store->setComment("spill");
+        auto Ptr = LocalVariable::get(Type::getInt32PtrTy(CTX), "ptr", Address - 0x8);
+        IBR.createGetBitPtr(
+            Type::getInt1PtrTy(CTX), Ptr, ConstantInt::get(CTX, unknown::APInt(64, Index)), Address + 0x8);
+        IBR.createJccBB(BB2, BB3, FlagsVariable::get(CTX), Address + 0xC);
+        IBR.setInsertPoint(BB2);
+        IBR.createUnknown("cpuid", Address + 0x10);
+        IBR.createJmpAddr(ConstantInt::get(CTX, unknown::APInt(64, 0x402000)), Address + 0x14);
+        IBR.setInsertPoint(BB3);
+        IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(128, Index)), Address + 0x18);
+
+        F->insertBasicBlock(BB1);
+        F->insertBasicBlock(BB2);
+        F->insertBasicBlock(BB3);
+        module.insertFunction(F);
+    }
+
+    std::string Expected;
+    unknown::raw_string_ostream ExpectedOS(Expected);
+    module.print(ExpectedOS);
+    ExpectedOS.flush();
+
+    std::string Binary;
+    unknown::raw_string_ostream BinaryOS(Binary);
+    EXPECT_TRUE(module.writeBinary(BinaryOS));
+    BinaryOS.flush();
+    EXPECT_LT(Binary.size(), Expected.size() / 3);
+
+    // Only the functions that are used are materialized
+    auto Reader = ModuleReader::get(CTX, unknown::MemoryBuffer::getMemBuffer(Binary, "", false));
+    ASSERT_NE(Reader, nullptr);
+    auto Read = Reader->getModule();
+    ASSERT_NE(Read, nullptr);
+    EXPECT_EQ(Read->getModuleName(), "mod5");
+    EXPECT_EQ(Read->size(), 16);
+    EXPECT_EQ(Read->global_size(), 3);
+
+    auto F3 = Read->getFunction("func3");
+    ASSERT_TRUE(F3.has_value());
+    EXPECT_FALSE(Reader->isMaterialized(*F3));
+    EXPECT_TRUE((*F3)->empty());
+    EXPECT_EQ((*F3)->arg_size(), 1);
+    EXPECT_TRUE(Reader->materialize(*F3));
+    EXPECT_TRUE(Reader->isMaterialized(*F3));
+    EXPECT_EQ((*F3)->size(), 3);
+    EXPECT_EQ((*F3)->front().front().getOperand(0), Read->getGlobalVariableList().front());
+    EXPECT_TRUE(Read->front().empty());
+
+    // The materialized module prints the same text
+    auto Taken = Reader->takeModule();
+    ASSERT_NE(Taken, nullptr);
+    EXPECT_EQ(Reader->getModule(), nullptr);
+    std::string Printed;
+    unknown::raw_string_ostream PrintedOS(Printed);
+    Taken->print(PrintedOS);
+    PrintedOS.flush();
+    EXPECT_EQ(Printed, Expected);
+
+    // The file is mapped by the reader
+    auto FilePath = std::filesystem::temp_directory_path() / "test_uir_module_5.uirb";
+    EXPECT_TRUE(module.writeBinaryToFile(FilePath.string()));
+    auto FromFile = ModuleReader::readModuleFile(CTX, FilePath.string());
+    ASSERT_NE(FromFile, nullptr);
+    std::string PrintedFile;
+    unknown::raw_string_ostream PrintedFileOS(PrintedFile);
+    FromFile->print(PrintedFileOS);
+    PrintedFileOS.flush();
+    EXPECT_EQ(PrintedFile, Expected);
+    std::filesystem::remove(FilePath);
+
+    // A corrupted body is reported when the function is materialized
+    std::string Corrupted = Binary;
+    Corrupted[8] = '\x7F';
+    auto CorruptedReader = ModuleReader::get(CTX, unknown::MemoryBuffer::getMemBuffer(Corrupted, "", false));
+    ASSERT_NE(CorruptedReader, nullptr);
+    EXPECT_FALSE(CorruptedReader->materialize(&CorruptedReader->getModule()->front()));
+    EXPECT_TRUE(CorruptedReader->getModule()->front().empty());
+
+    // A truncated file is rejected
+    EXPECT_EQ(ModuleReader::get(CTX, unknown::MemoryBuffer::getMemBuffer(Binary.substr(0, 64), "", false)), nullptr);
+}
+
+TEST(test_uir, test_uir_module_6)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    Module module(CTX, "mod6");
+    auto GV = GlobalVariable::get(Type::getInt32PtrTy(CTX), "gv1", 0x601000);
+    GV->setComment("<\"counter\" & 'total'>");
+    module.insertGlobalVariable(GV);
+
+    for (uint64_t Index = 0; Index < 16; ++Index)
+    {
+        uint64_t Address = 0x401000 + Index * 0x20;
+        Function *F = Function::get(CTX, std::format("func{}", Index), &module, Address, Address + 0x20);
+        F->addFnAttr("attr1");
+        F->addFnAttr("attr2");
+        F->insertArgument(Argument::get(Type::getInt32Ty(CTX), "arg1", F, 0));
+        F->insertFunctionContext(FunctionContext::get(Type::getInt64Ty(CTX), "rax", F, 1));
+
+        BasicBlock *BB1 = BasicBlock::get(CTX, "bb1", Address, Address + 0x10);
+        BasicBlock *BB2 = BasicBlock::get(CTX, "bb2", Address + 0x10, Address + 0x18);
+        BasicBlock *BB3 = BasicBlock::get(CTX, "bb3", Address + 0x18, Address + 0x20);
+        BB1->addExtraInfo("entry");
+        BB1->addExtraInfo("hot");
+
+        IRBuilder IBR(BB1);
+        auto Load = IBR.createLoad(GV, Address);
+        Load->setName("val", static_cast<uint32_t>(Index));
+        Load->enablePrintOp(true);
+        auto Val = LocalVariable::get(Type::getInt32Ty(CTX), "val", Address - 0x4);
+        auto Slot = LocalVariable::get(Type::getInt32PtrTy(CTX), "slot", Address - 0x8);
+        auto Store = IBR.createStore(Val, Slot, Address + 0x4);
+        Store->setComment("spill");
+        auto Ptr = LocalVariable::get(Type::getInt32PtrTy(CTX), "ptr", Address - 0x8);
+        IBR.createGetBitPtr(
+            Type::getInt1PtrTy(CTX), Ptr, ConstantInt::get(CTX, unknown::APInt(64, Index)), Address + 0x8);
+        IBR.createJccBB(BB2, BB3, FlagsVariable::get(CTX), Address + 0xC);
+        IBR.setInsertPoint(BB2);
+        IBR.createUnknown("rep movsb <a,b>", Address + 0x10);
+        IBR.createJmpAddr(ConstantInt::get(CTX, unknown::APInt(64, 0x402000)), Address + 0x14);
+        IBR.setInsertPoint(BB3);
+        IBR.createRetImm(ConstantInt::get(CTX, unknown::APInt(128, Index)), Address + 0x18);
+
+        F->insertBasicBlock(BB1);
+        F->insertBasicBlock(BB2);
+        F->insertBasicBlock(BB3);
+        module.insertFunction(F);
+    }
+
+    std::string Expected;
+    unknown::raw_string_ostream ExpectedOS(Expected);
+    module.print(ExpectedOS);
+    ExpectedOS.flush();
+
+    // The whole module prints the same text
+    XMLModuleReader Reader(CTX);
+    auto Read = Reader.read(Expected);
+    ASSERT_NE(Read, nullptr) << Reader.getError();
+    std::string Printed;
+    unknown::raw_string_ostream PrintedOS(Printed);
+    Read->print(PrintedOS);
+    PrintedOS.flush();
+    EXPECT_EQ(Printed, Expected);
+
+    // The operands and the predecessors are linked
+    auto F3 = Read->getFunction("func3");
+    ASSERT_TRUE(F3.has_value());
+    EXPECT_EQ((*F3)->front().front().getOperand(0), Read->getGlobalVariableList().front());
+    auto BB2 = *std::next((*F3)->begin());
+    EXPECT_EQ(BB2->predecessor_count(), 1);
+    EXPECT_EQ(BB2->predecessor_front(), &(*F3)->front());
+
+    // Only the selected functions are read
+    std::string ExpectedF3;
+    unknown::raw_string_ostream ExpectedF3OS(ExpectedF3);
+    (*module.getFunction("func3"))->print(ExpectedF3OS);
+    ExpectedF3OS.flush();
+
+    XMLModuleReader NameReader(CTX);
+    NameReader.addFunctionName("func3");
+    auto ByName = NameReader.read(Expected);
+    ASSERT_NE(ByName, nullptr) << NameReader.getError();
+    EXPECT_EQ(ByName->size(), 1);
+    EXPECT_EQ(ByName->global_size(), 1);
+    std::string PrintedF3;
+    unknown::raw_string_ostream PrintedF3OS(PrintedF3);
+    ByName->front().print(PrintedF3OS);
+    PrintedF3OS.flush();
+    EXPECT_EQ(PrintedF3, ExpectedF3);
+
+    XMLModuleReader RangeReader(CTX);
+    RangeReader.addFunctionRange(0x401070, 0x4010A0);
+    auto ByRange = RangeReader.read(Expected);
+    ASSERT_NE(ByRange, nullptr) << RangeReader.getError();
+    EXPECT_EQ(ByRange->size(), 2);
+    EXPECT_EQ(ByRange->front().getFunctionName(), "func3");
+    EXPECT_EQ(ByRange->back().getFunctionName(), "func4");
+
+    // The printed file is mapped by the reader
+    auto FilePath = std::filesystem::temp_directory_path() / "test_uir_module_6.xml";
+    EXPECT_TRUE(module.printToFile(FilePath.string(), 4));
+    auto FromFile = XMLModuleReader::readModuleFile(CTX, FilePath.string());
+    ASSERT_NE(FromFile, nullptr);
+    std::string PrintedFile;
+    unknown::raw_string_ostream PrintedFileOS(PrintedFile);
+    FromFile->print(PrintedFileOS);
+    PrintedFileOS.flush();
+    EXPECT_EQ(PrintedFile, Expected);
+    std::filesystem::remove(FilePath);
+
+    // Invalid documents are rejected
+    XMLModuleReader BadReader(CTX);
+    EXPECT_EQ(BadReader.read(Expected.substr(0, Expected.size() / 2)), nullptr);
+    EXPECT_FALSE(BadReader.getError().empty());
+    std::string Undefined = Expected;
+    Undefined.replace(Undefined.find("uir.jcc.bb block.bb2"), 20, "uir.jcc.bb block.bb9");
+    EXPECT_EQ(BadReader.read(Undefined), nullptr);
+    EXPECT_FALSE(BadReader.getError().empty());
+
+    Context CTX32;
+    CTX32.setArch(Context::Arch::ArchX86);
+    CTX32.setMode(Context::Mode::Mode32);
+    EXPECT_EQ(XMLModuleReader(CTX32).read(Expected), nullptr);
+}
+
+TEST(test_uir, test_uir_module_7)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    // The global variable is only used by the instructions, it outlives the module
+    std::unique_ptr<GlobalVariable> Ext(GlobalVariable::get(Type::getInt32PtrTy(CTX), "ext", 0x602000));
+    Module module(CTX, "mod7");
+    for (uint64_t Index = 0; Index < 2; ++Index)
+    {
+        uint64_t Address = 0x401000 + Index * 0x10;
+        Function *F = Function::get(CTX, std::format("func{}", Index), &module, Address, Address + 0x10);
+        BasicBlock *BB = BasicBlock::get(CTX, "bb1", Address, Address + 0x10);
+
+        IRBuilder IBR(BB);
+        auto Tmp = LocalVariable::get(Type::getInt32PtrTy(CTX), "tmp", 0);
+        IBR.createStore(ConstantInt::get(CTX, unknown::APInt(32, Index)), Tmp, Address);
+        IBR.createStore(Tmp, Ext.get(), Address + 0x4);
+        IBR.createRetVoid(Address + 0x8);
+
+        F->insertBasicBlock(BB);
+        module.insertFunction(F);
+    }
+
+    std::string Expected;
+    unknown::raw_string_ostream ExpectedOS(Expected);
+    module.print(ExpectedOS);
+    ExpectedOS.flush();
+
+    XMLModuleReader Reader(CTX);
+    auto Read = Reader.read(Expected);
+    ASSERT_NE(Read, nullptr) << Reader.getError();
+
+    // The local variable is shared by the instructions of its function
+    auto F0 = Read->getFunction("func0");
+    auto F1 = Read->getFunction("func1");
+    ASSERT_TRUE(F0.has_value() && F1.has_value());
+    auto &Insts0 = (*F0)->front();
+    auto Tmp0 = Insts0.front().getOperand(1);
+    EXPECT_EQ((*std::next(Insts0.begin()))->getOperand(0), Tmp0);
+    EXPECT_EQ(Tmp0->getNumUses(), 2);
+    auto Tmp1 = (*F1)->front().front().getOperand(1);
+    EXPECT_NE(Tmp1, Tmp0);
+
+    // The global variable is shared by the functions and owned by the module
+    ASSERT_EQ(Read->global_size(), 1);
+    auto ReadExt = Read->getGlobalVariableList().front();
+    EXPECT_EQ((*std::next(Insts0.begin()))->getOperand(1), ReadExt);
+    EXPECT_EQ((*std::next((*F1)->front().begin()))->getOperand(1), ReadExt);
+    EXPECT_EQ(ReadExt->getNumUses(), 2);
+
+    // An instruction that can not be rebuilt frees the local variables it created
+    std::string Broken = Expected;
+    auto ExtPos = Broken.find("@ext");
+    ASSERT_NE(ExtPos, std::string::npos);
+    auto TmpPos = Broken.rfind("%tmp", ExtPos);
+    ASSERT_NE(TmpPos, std::string::npos);
+    Broken.replace(ExtPos, 4, "0xZZ");
+    Broken.replace(TmpPos, 4, "%bad");
+    XMLModuleReader BrokenReader(CTX);
+    EXPECT_EQ(BrokenReader.read(Broken), nullptr);
+    EXPECT_FALSE(BrokenReader.getError().empty());
+}
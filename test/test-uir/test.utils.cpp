@@ -1,7 +1,11 @@
 
 #include <UnknownIR.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
 
 #include <UnknownUtils/unknown/ADT/APInt.h>
@@ -9,6 +13,7 @@
 #include <UnknownUtils/unknown/Support/raw_ostream.h>
 #include <UnknownUtils/unknown/Support/FileSystem.h>
 
+#include <UnknownUtils/unknown/Symbol/SymbolCache.h>
 #include <UnknownUtils/unknown/Symbol/SymbolParser.h>
 
 TEST(test_uir, test_uir_utils_1)
@@ -56,3 +61,180 @@ TEST(test_uir, test_uir_utils_3)
         }
     }
 }
+
+TEST(test_uir, test_uir_utils_4)
+{
+    // The MAP parser aims for this many MB/s in a release build, it is printed next to the measured rate
+    constexpr double TargetMBPerSec = 100.0;
+
+    auto SymParserMap = unknown::CreateSymbolParserForPE(false);
+    ASSERT_TRUE(SymParserMap);
+    ASSERT_TRUE(SymParserMap->ParseFunctionSymbols(UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.map)"));
+    EXPECT_EQ(SymParserMap->getImageBase(), 0x140000000);
+
+    // The size of main is the distance to printf
+    auto Symbols = SymParserMap->getFunctionSymbols();
+    auto Main = std::find_if(Symbols.begin(), Symbols.end(), [](auto &Sym) { return Sym.name == "main"; });
+    ASSERT_NE(Main, Symbols.end());
+    EXPECT_EQ(Main->rva, 0x10b0);
+    EXPECT_EQ(Main->size, 0x50);
+
+    // A large map is parsed in chunks, the last function ends with its section contribution
+    constexpr uint32_t NumFunctions = 200000;
+    auto FilePath = std::filesystem::temp_directory_path() / "test_uir_utils_4.map";
+    {
+        std::ofstream File(FilePath, std::ios::binary);
+        File << " Project\r\n\r\n Preferred load address is 0000000140000000\r\n\r\n";
+        File << " Start         Length     Name                   Class\r\n";
+        File << std::format(" 0001:00000000 {:08x}H .text$mn                CODE\r\n", NumFunctions * 0x10 + 8);
+        File << "\r\n  Address         Publics by Value              Rva+Base               Lib:Object\r\n\r\n";
+        for (uint32_t Index = 0; Index < NumFunctions; ++Index)
+        {
+            File << std::format(
+                " 0001:{:08x}       func_{}                 {:016x} f   Source{}.obj\r\n",
+                Index * 0x10,
+                Index,
+                0x140001000 + Index * 0x10,
+                Index % 64);
+        }
+        File << std::format(
+            " 0002:00000000       data_0                 {:016x}     Data.obj\r\n", 0x140001000 + NumFunctions * 0x10);
+    }
+
+    auto FileSize = std::filesystem::file_size(FilePath);
+    auto Begin = std::chrono::steady_clock::now();
+    ASSERT_TRUE(SymParserMap->ParseFunctionSymbols(FilePath.string()));
+    std::chrono::duration<double> Seconds = std::chrono::steady_clock::now() - Begin;
+    std::filesystem::remove(FilePath);
+
+    // The names point into the mapped file, which the parser keeps after the file is removed
+    Symbols = SymParserMap->getFunctionSymbols();
+    ASSERT_EQ(Symbols.size(), NumFunctions);
+    for (uint32_t Index = 0; Index < NumFunctions; ++Index)
+    {
+        EXPECT_EQ(Symbols[Index].name, std::format("func_{}", Index));
+        EXPECT_EQ(Symbols[Index].rva, 0x1000 + Index * 0x10);
+        EXPECT_EQ(Symbols[Index].size, Index + 1 == NumFunctions ? 0x18 : 0x10);
+    }
+
+    auto MBPerSec = Seconds.count() > 0 ? FileSize / (1024.0 * 1024.0) / Seconds.count() : 0.0;
+    // The rate depends on the machine, so it is not checked
+    std::cout << std::format("map: {} bytes MB/sec: {:.1f} target: {:.1f}\n", FileSize, MBPerSec, TargetMBPerSec);
+}
+
+TEST(test_uir, test_uir_utils_5)
+{
+    auto SymParserPdb = unknown::CreateSymbolParserForPE(true);
+    ASSERT_TRUE(SymParserPdb);
+    ASSERT_TRUE(SymParserPdb->ParseFunctionSymbols(UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)"));
+
+    // The symbols of all modules are merged sorted by RVA without duplicates
+    auto Symbols = SymParserPdb->getFunctionSymbols();
+    ASSERT_FALSE(Symbols.empty());
+    EXPECT_TRUE(std::adjacent_find(Symbols.begin(), Symbols.end(), [](auto &Lhs, auto &Rhs) {
+                    return Lhs.rva >= Rhs.rva;
+                }) == Symbols.end());
+
+    auto Main = std::find_if(Symbols.begin(), Symbols.end(), [](auto &Sym) { return Sym.name == "main"; });
+    ASSERT_NE(Main, Symbols.end());
+    EXPECT_EQ(Main->rva, 0x10b0);
+    EXPECT_NE(Main->size, 0);
+
+    // The symbols do not depend on the order in which the modules were parsed
+    std::vector<std::pair<uint32_t, std::string>> Expected;
+    for (auto &Sym : Symbols)
+    {
+        Expected.emplace_back(Sym.rva, Sym.name);
+    }
+    ASSERT_TRUE(SymParserPdb->ParseFunctionSymbols(UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)"));
+    Symbols = SymParserPdb->getFunctionSymbols();
+    ASSERT_EQ(Symbols.size(), Expected.size());
+    for (size_t Index = 0; Index < Symbols.size(); ++Index)
+    {
+        EXPECT_EQ(Symbols[Index].rva, Expected[Index].first);
+        EXPECT_EQ(Symbols[Index].name, Expected[Index].second);
+    }
+}
+
+TEST(test_uir, test_uir_utils_6)
+{
+    auto CacheDirectory = std::filesystem::temp_directory_path() / "test_uir_utils_6";
+    std::filesystem::remove_all(CacheDirectory);
+
+    // Compare all the fields the cache holds
+    auto expectSameSymbols = [](const auto &Lhs, const auto &Rhs) {
+        ASSERT_EQ(Lhs.size(), Rhs.size());
+        for (size_t Index = 0; Index < Lhs.size(); ++Index)
+        {
+            EXPECT_EQ(Lhs[Index].name, Rhs[Index].name);
+            EXPECT_EQ(Lhs[Index].internal_name, Rhs[Index].internal_name);
+            EXPECT_EQ(Lhs[Index].rva, Rhs[Index].rva);
+            EXPECT_EQ(Lhs[Index].size, Rhs[Index].size);
+            EXPECT_EQ(Lhs[Index].cbFrame, Rhs[Index].cbFrame);
+            EXPECT_EQ(Lhs[Index].cbSaveRegs, Rhs[Index].cbSaveRegs);
+            EXPECT_EQ(Lhs[Index].hasSecurityChecks, Rhs[Index].hasSecurityChecks);
+            EXPECT_EQ(Lhs[Index].hasGuardCF, Rhs[Index].hasGuardCF);
+        }
+    };
+
+    for (bool UsePDB : {true, false})
+    {
+        auto SymFilePath = UsePDB ? UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.pdb)"
+                                  : UNKNOWN_REBUILDER_SRC_DIR R"(/sample/pe-x64/Project12.map)";
+
+        // The first parse writes the cache
+        auto SymParser = unknown::CreateSymbolParserForPE(UsePDB);
+        SymParser->setCacheDirectory(CacheDirectory.string());
+        ASSERT_TRUE(SymParser->ParseFunctionSymbols(SymFilePath));
+        auto NumCacheFiles = std::distance(
+            std::filesystem::directory_iterator(CacheDirectory), std::filesystem::directory_iterator());
+        EXPECT_EQ(NumCacheFiles, UsePDB ? 1 : 2);
+
+        // The next one reads it
+        auto CachedSymParser = unknown::CreateSymbolParserForPE(UsePDB);
+        CachedSymParser->setCacheDirectory(CacheDirectory.string());
+        ASSERT_TRUE(CachedSymParser->ParseFunctionSymbols(SymFilePath));
+        EXPECT_EQ(CachedSymParser->getImageBase(), SymParser->getImageBase());
+        expectSameSymbols(CachedSymParser->getFunctionSymbols(), SymParser->getFunctionSymbols());
+    }
+
+    // A cache written for another key or by another version is not read
+    std::vector<unknown::SymbolParser::FunctionSymbol> Symbols(2);
+    Symbols[0].name = "func1";
+    Symbols[0].internal_name = "func1";
+    Symbols[0].rva = 0x1000;
+    Symbols[0].size = 0x10;
+    Symbols[0].hasGuardCF = true;
+    Symbols[1].name = "func2";
+    Symbols[1].internal_name = "?func2@@YAXXZ";
+    Symbols[1].rva = 0x1010;
+    Symbols[1].sectExHdlr = 2;
+
+    auto CachePath = unknown::GetSymbolCachePath(CacheDirectory.string(), "key1");
+    ASSERT_TRUE(unknown::WriteSymbolCache(CachePath, "key1", 0x140000000, Symbols));
+
+    uint64_t ImageBase = 0;
+    std::vector<unknown::SymbolParser::FunctionSymbol> CachedSymbols;
+    std::unique_ptr<unknown::MemoryBuffer> CachedBuffer;
+    ASSERT_TRUE(unknown::ReadSymbolCache(CachePath, "key1", ImageBase, CachedSymbols, CachedBuffer));
+    EXPECT_EQ(ImageBase, 0x140000000);
+    expectSameSymbols(CachedSymbols, Symbols);
+    EXPECT_EQ(CachedSymbols[1].sectExHdlr, 2);
+    EXPECT_FALSE(unknown::ReadSymbolCache(CachePath, "key2", ImageBase, CachedSymbols, CachedBuffer));
+
+    // The names point into the cache file
+    auto CachedData = CachedBuffer->getBuffer();
+    EXPECT_TRUE(
+        CachedSymbols[1].internal_name.begin() >= CachedData.begin() &&
+        CachedSymbols[1].internal_name.end() <= CachedData.end());
+
+    // A truncated cache is not read
+    CachedSymbols.clear();
+    CachedBuffer.reset();
+    std::filesystem::resize_file(CachePath, std::filesystem::file_size(CachePath) - 1);
+    EXPECT_FALSE(unknown::ReadSymbolCache(CachePath, "key1", ImageBase, CachedSymbols, CachedBuffer));
+    EXPECT_TRUE(CachedSymbols.empty());
+    EXPECT_FALSE(CachedBuffer);
+
+    std::filesystem::remove_all(CacheDirectory);
+}
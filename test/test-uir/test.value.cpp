@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <format>
 #include <iostream>
+#include <thread>
 
 using namespace uir;
 
@@ -83,3 +84,150 @@ TEST(test_uir, test_uir_value_4)
     std::cout << std::format("CSTInt ReadableName =  {}", CSTInt->getReadableName()) << std::endl;
     unknown::outs() << "CSTInt ReadableName = " << *CSTInt;
 }
+
+TEST(test_uir, test_uir_value_5)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    auto Val1 = LocalVariable::get(Type::getInt32Ty(CTX), "local_1", 0x501000);
+    auto Val2 = LocalVariable::get(Type::getInt32Ty(CTX), "local_2", 0x501004);
+    auto Ptr = LocalVariable::get(Type::getInt32PtrTy(CTX), "local_ptr_1", 0x601000);
+
+    auto StoreInst1 = StoreInstruction::get(CTX, Val1, Ptr);
+    auto StoreInst2 = StoreInstruction::get(CTX, Val1, Ptr);
+    EXPECT_EQ(Val1->getNumUses(), 2);
+    EXPECT_EQ(Ptr->getNumUses(), 2);
+    EXPECT_TRUE(Val2->use_empty());
+    EXPECT_TRUE(Val1->user_contains(StoreInst1));
+    EXPECT_TRUE(Val1->user_contains(StoreInst2));
+
+    // Every use refers back to its user and value
+    for (auto &U : Val1->uses())
+    {
+        EXPECT_EQ(U.get(), Val1);
+        EXPECT_EQ(U.getUser()->getOperand(0), Val1);
+    }
+
+    // Setting an operand moves the use
+    StoreInst1->setValueOperand(Val2);
+    EXPECT_TRUE(Val2->hasOneUse());
+    EXPECT_EQ(*Val2->user_begin(), StoreInst1);
+    EXPECT_TRUE(Val1->hasOneUse());
+
+    // RAUW moves all uses without touching the other operands
+    Val1->replaceAllUsesWith(Val2);
+    EXPECT_TRUE(Val1->use_empty());
+    EXPECT_EQ(Val2->getNumUses(), 2);
+    EXPECT_EQ(StoreInst2->getValueOperand(), Val2);
+    EXPECT_EQ(StoreInst2->getPointerOperand(), Ptr);
+
+    // Erasing an operand or destroying the user unlinks its uses
+    StoreInst2->eraseOperandAndUpdateUsers(Ptr);
+    EXPECT_TRUE(Ptr->hasOneUse());
+    delete StoreInst2;
+    EXPECT_TRUE(Val2->hasOneUse());
+    delete StoreInst1;
+    EXPECT_TRUE(Val2->use_empty());
+    EXPECT_TRUE(Ptr->use_empty());
+
+    delete Val1;
+    delete Val2;
+    delete Ptr;
+}
+
+TEST(test_uir, test_uir_value_6)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    // Names are formatted when they are read
+    auto CI = ConstantInt::get(CTX, unknown::APInt(32, 0x7b));
+    EXPECT_EQ(CI->getName(), "0x7B");
+    EXPECT_EQ(CI->getReadableName(), "0x7B i32");
+
+    auto Val1 = LocalVariable::get(Type::getInt32Ty(CTX));
+    auto Val2 = LocalVariable::get(Type::getInt32Ty(CTX));
+    EXPECT_TRUE(Val1->hasName());
+    EXPECT_EQ(std::stoul(Val2->getName()), std::stoul(Val1->getName()) + 1);
+
+    Val1->setName("rax", 3);
+    EXPECT_EQ(Val1->getName(), "rax3");
+    Val1->setName("rbx");
+    EXPECT_EQ(Val1->getName(), "rbx");
+    Val2->setName("");
+    EXPECT_FALSE(Val2->hasName());
+
+    // Comments and extra info are only stored for the values that have them
+    EXPECT_TRUE(Val1->getExtraInfoList().empty());
+    EXPECT_EQ(Val1->getComment(), "");
+    Val1->addExtraInfo("info1");
+    Val1->addExtraInfo("info2");
+    Val1->addExtraInfo("info1");
+    Val1->removeExtraInfo("info2");
+    Val1->setComment("first");
+    Val1->addComment(" second");
+    EXPECT_EQ(Val1->getExtraInfoList(), Value::ExtraInfoListType{"info1"});
+    EXPECT_EQ(Val1->getComment(), "first second");
+    EXPECT_TRUE(Val2->getExtraInfoList().empty());
+
+    delete Val1;
+    delete Val2;
+}
+
+TEST(test_uir, test_uir_value_7)
+{
+    Context CTX;
+    CTX.setArch(Context::Arch::ArchX86);
+    CTX.setMode(Context::Mode::Mode64);
+
+    // Constants are uniqued by value and bit width
+    auto CI1 = ConstantInt::get(CTX, unknown::APInt(32, 0x7b));
+    auto CI2 = ConstantInt::get(CTX, unknown::APInt(32, 0x7b));
+    auto CI3 = ConstantInt::get(CTX, unknown::APInt(64, 0x7b));
+    auto CI4 = ConstantInt::get(CTX, unknown::APInt(8, 0x7b));
+    EXPECT_EQ(CI1, CI2);
+    EXPECT_NE(CI1, CI3);
+    EXPECT_NE(CI1, CI4);
+    EXPECT_EQ(CI3->getType(), Type::getInt64Ty(CTX));
+    EXPECT_EQ(CI4->getType(), Type::getInt8Ty(CTX));
+
+    auto Big1 = ConstantInt::get(CTX, unknown::APInt(64, 0x12345678));
+    auto Big2 = ConstantInt::get(CTX, unknown::APInt(64, 0x12345678));
+    auto Big3 = ConstantInt::get(CTX, unknown::APInt(32, 0x12345678));
+    EXPECT_EQ(Big1, Big2);
+    EXPECT_NE(Big1, Big3);
+
+    auto Odd1 = ConstantInt::get(CTX, unknown::APInt(24, 0x7b));
+    auto Odd2 = ConstantInt::get(CTX, unknown::APInt(24, 0x7b));
+    EXPECT_EQ(Odd1, Odd2);
+
+    // Integer types are uniqued by bit width
+    EXPECT_EQ(IntegerType::get(CTX, 8), Type::getInt8Ty(CTX));
+    EXPECT_EQ(IntegerType::get(CTX, 24), IntegerType::get(CTX, 24));
+    EXPECT_EQ(IntegerType::get(CTX, 24), Odd1->getType());
+    EXPECT_EQ(IntegerType::get(CTX, 256)->getTypeName(), "i256");
+
+    // Constants built on another thread are the same objects
+    ConstantInt *ThreadCI = nullptr;
+    ConstantInt *ThreadBig = nullptr;
+    std::thread Worker([&] {
+        ThreadCI = ConstantInt::get(CTX, unknown::APInt(32, 0x7b));
+        ThreadBig = ConstantInt::get(CTX, unknown::APInt(64, 0x12345678));
+    });
+    Worker.join();
+    EXPECT_EQ(ThreadCI, CI1);
+    EXPECT_EQ(ThreadBig, Big1);
+
+    // The uses of the shared constants are not tracked
+    auto Ptr = LocalVariable::get(Type::getInt32PtrTy(CTX), "local_ptr_1", 0x601000);
+    auto StoreInst = StoreInstruction::get(CTX, CI1, Ptr);
+    EXPECT_EQ(StoreInst->getValueOperand(), CI1);
+    EXPECT_TRUE(CI1->use_empty());
+    EXPECT_TRUE(Ptr->hasOneUse());
+    delete StoreInst;
+    EXPECT_TRUE(Ptr->use_empty());
+    delete Ptr;
+}